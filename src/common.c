@@ -100,8 +100,8 @@ sr_sub_change_add(sr_session_ctx_t *sess, const char *mod_name, const char *xpat
     uint32_t i;
     void *mem[4] = {NULL};
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         return err_info;
     }
 
@@ -157,13 +157,13 @@ sr_sub_change_add(sr_session_ctx_t *sess, const char *mod_name, const char *xpat
 
     ++change_sub->sub_count;
 
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
     return NULL;
 
 error_unlock:
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
 
     for (i = 0; i < 4; ++i) {
         free(mem[i]);
@@ -185,8 +185,8 @@ sr_sub_change_del(const char *mod_name, const char *xpath, sr_datastore_t ds, sr
     uint32_t i, j;
     struct modsub_change_s *change_sub;
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         sr_errinfo_free(&err_info);
         return;
     }
@@ -232,8 +232,8 @@ sr_sub_change_del(const char *mod_name, const char *xpath, sr_datastore_t ds, sr
                 }
             }
 
-            /* SUBS UNLOCK */
-            sr_munlock(&subs->subs_lock);
+            /* SUBS WRITE UNLOCK */
+            sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
             return;
         }
     }
@@ -241,23 +241,25 @@ sr_sub_change_del(const char *mod_name, const char *xpath, sr_datastore_t ds, sr
     /* unreachable */
     assert(0);
 
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
 }
 
 sr_error_info_t *
 sr_sub_oper_add(sr_session_ctx_t *sess, const char *mod_name, const char *xpath, sr_oper_get_items_cb oper_cb,
-        void *private_data, sr_subscription_ctx_t *subs)
+        void *private_data, sr_subscr_options_t sub_opts, sr_subscription_ctx_t *subs)
 {
     sr_error_info_t *err_info = NULL;
     struct modsub_oper_s *oper_sub = NULL;
-    uint32_t i;
-    void *mem[4] = {NULL};
+    struct modsub_opersub_s *sub;
+    char suffix[SR_OPER_SLOT_SUFFIX_SIZE];
+    uint32_t i, slot_count;
+    void *mem[5] = {NULL};
 
     assert(mod_name && xpath);
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         return err_info;
     }
 
@@ -291,34 +293,52 @@ sr_sub_oper_add(sr_session_ctx_t *sess, const char *mod_name, const char *xpath,
     mem[2] = realloc(oper_sub->subs, (oper_sub->sub_count + 1) * sizeof *oper_sub->subs);
     SR_CHECK_MEM_GOTO(!mem[2], err_info, error_unlock);
     oper_sub->subs = mem[2];
-    memset(oper_sub->subs + oper_sub->sub_count, 0, sizeof *oper_sub->subs);
-    oper_sub->subs[oper_sub->sub_count].sub_shm.fd = -1;
+    sub = &oper_sub->subs[oper_sub->sub_count];
+    memset(sub, 0, sizeof *sub);
 
     /* set attributes */
     mem[3] = strdup(xpath);
     SR_CHECK_MEM_GOTO(!mem[3], err_info, error_unlock);
-    oper_sub->subs[oper_sub->sub_count].xpath = mem[3];
-    oper_sub->subs[oper_sub->sub_count].cb = oper_cb;
-    oper_sub->subs[oper_sub->sub_count].private_data = private_data;
-    oper_sub->subs[oper_sub->sub_count].sess = sess;
-
-    /* create specific SHM and map it */
-    if ((err_info = sr_shmsub_open_map(mod_name, "oper", sr_str_hash(xpath), &oper_sub->subs[oper_sub->sub_count].sub_shm,
-            sizeof(sr_sub_shm_t)))) {
-        goto error_unlock;
+    sub->xpath = mem[3];
+    sub->opts = sub_opts;
+    sub->cb = oper_cb;
+    sub->private_data = private_data;
+    sub->sess = sess;
+
+    /* create request slots */
+    slot_count = (sub_opts & SR_SUBSCR_OPER_CONCURRENT) ? SR_OPER_SUB_SLOT_COUNT : 1;
+    mem[4] = calloc(slot_count, sizeof *sub->slots);
+    SR_CHECK_MEM_GOTO(!mem[4], err_info, error_unlock);
+    sub->slots = mem[4];
+    for (i = 0; i < slot_count; ++i) {
+        sub->slots[i].sub_shm.fd = -1;
+    }
+
+    /* create specific SHM for every slot and map it */
+    for (sub->slot_count = 0; sub->slot_count < slot_count; ++sub->slot_count) {
+        sr_oper_slot_suffix(sub->slot_count, suffix);
+        if ((err_info = sr_shmsub_open_map(mod_name, suffix, sr_str_hash(xpath), &sub->slots[sub->slot_count].sub_shm,
+                sizeof(sr_sub_shm_t)))) {
+            goto error_unlock;
+        }
     }
 
     ++oper_sub->sub_count;
 
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
     return NULL;
 
 error_unlock:
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
 
-    for (i = 0; i < 4; ++i) {
+    if (mem[4]) {
+        for (i = 0; i < sub->slot_count; ++i) {
+            sr_shm_clear(&sub->slots[i].sub_shm);
+        }
+    }
+    for (i = 0; i < 5; ++i) {
         free(mem[i]);
     }
     if (mem[1]) {
@@ -331,11 +351,11 @@ void
 sr_sub_oper_del(const char *mod_name, const char *xpath, sr_subscription_ctx_t *subs)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i, j;
+    uint32_t i, j, k;
     struct modsub_oper_s *oper_sub;
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         sr_errinfo_free(&err_info);
         return;
     }
@@ -354,7 +374,10 @@ sr_sub_oper_del(const char *mod_name, const char *xpath, sr_subscription_ctx_t *
 
             /* found our subscription, replace it with the last */
             free(oper_sub->subs[j].xpath);
-            sr_shm_clear(&oper_sub->subs[j].sub_shm);
+            for (k = 0; k < oper_sub->subs[j].slot_count; ++k) {
+                sr_shm_clear(&oper_sub->subs[j].slots[k].sub_shm);
+            }
+            free(oper_sub->subs[j].slots);
             if (j < oper_sub->sub_count - 1) {
                 memcpy(&oper_sub->subs[j], &oper_sub->subs[oper_sub->sub_count - 1], sizeof *oper_sub->subs);
             }
@@ -376,8 +399,8 @@ sr_sub_oper_del(const char *mod_name, const char *xpath, sr_subscription_ctx_t *
                 }
             }
 
-            /* SUBS UNLOCK */
-            sr_munlock(&subs->subs_lock);
+            /* SUBS WRITE UNLOCK */
+            sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
             return;
         }
     }
@@ -385,8 +408,8 @@ sr_sub_oper_del(const char *mod_name, const char *xpath, sr_subscription_ctx_t *
     /* unreachable */
     assert(0);
 
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
 }
 
 sr_error_info_t *
@@ -400,8 +423,8 @@ sr_sub_notif_add(sr_session_ctx_t *sess, const char *mod_name, const char *xpath
 
     assert(mod_name);
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         return err_info;
     }
 
@@ -458,13 +481,13 @@ sr_sub_notif_add(sr_session_ctx_t *sess, const char *mod_name, const char *xpath
 
     ++notif_sub->sub_count;
 
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
     return NULL;
 
 error_unlock:
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
 
     for (i = 0; i < 4; ++i) {
         free(mem[i]);
@@ -485,8 +508,8 @@ sr_sub_notif_del(const char *mod_name, const char *xpath, time_t start_time, tim
     struct modsub_notif_s *notif_sub;
 
     if (!has_subs_lock) {
-        /* SUBS LOCK */
-        if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+        /* SUBS WRITE LOCK */
+        if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
             sr_errinfo_free(&err_info);
             return;
         }
@@ -535,8 +558,8 @@ sr_sub_notif_del(const char *mod_name, const char *xpath, time_t start_time, tim
             }
 
             if (!has_subs_lock) {
-                /* SUBS UNLOCK */
-                sr_munlock(&subs->subs_lock);
+                /* SUBS WRITE UNLOCK */
+                sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
             }
             return;
         }
@@ -546,8 +569,8 @@ sr_sub_notif_del(const char *mod_name, const char *xpath, time_t start_time, tim
     assert(0);
 
     if (!has_subs_lock) {
-        /* SUBS UNLOCK */
-        sr_munlock(&subs->subs_lock);
+        /* SUBS WRITE UNLOCK */
+        sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
     }
 }
 
@@ -563,8 +586,8 @@ sr_sub_rpc_add(sr_session_ctx_t *sess, const char *op_path, const char *xpath, s
 
     assert(op_path && xpath && (rpc_cb || rpc_tree_cb) && (!rpc_cb || !rpc_tree_cb));
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         return err_info;
     }
 
@@ -623,13 +646,13 @@ sr_sub_rpc_add(sr_session_ctx_t *sess, const char *op_path, const char *xpath, s
 
     ++rpc_sub->sub_count;
 
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
     return NULL;
 
 error_unlock:
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
 
     for (i = 0; i < 4; ++i) {
         free(mem[i]);
@@ -649,8 +672,8 @@ sr_sub_rpc_del(const char *op_path, const char *xpath, sr_rpc_cb rpc_cb, sr_rpc_
     uint32_t i, j;
     struct opsub_rpc_s *rpc_sub;
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         sr_errinfo_free(&err_info);
         return;
     }
@@ -695,8 +718,8 @@ sr_sub_rpc_del(const char *op_path, const char *xpath, sr_rpc_cb rpc_cb, sr_rpc_
                 }
             }
 
-            /* SUBS UNLOCK */
-            sr_munlock(&subs->subs_lock);
+            /* SUBS WRITE UNLOCK */
+            sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
             return;
         }
     }
@@ -704,8 +727,8 @@ sr_sub_rpc_del(const char *op_path, const char *xpath, sr_rpc_cb rpc_cb, sr_rpc_
     /* unreachable */
     assert(0);
 
-    /* SUBS UNLOCK */
-    sr_munlock(&subs->subs_lock);
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subs->subs_lock, SR_LOCK_WRITE, __func__);
 }
 
 int
@@ -1425,6 +1448,17 @@ sr_path_sub_shm(const char *mod_name, const char *suffix1, int64_t suffix2, int
     return err_info;
 }
 
+void
+sr_oper_slot_suffix(uint32_t slot, char *suffix)
+{
+    if (slot) {
+        snprintf(suffix, SR_OPER_SLOT_SUFFIX_SIZE, "oper%" PRIu32, slot);
+    } else {
+        /* the first slot is the only one of non-concurrent subscriptions */
+        strcpy(suffix, "oper");
+    }
+}
+
 sr_error_info_t *
 sr_path_ds_shm(const char *mod_name, sr_datastore_t ds, int abs_path, char **path)
 {
@@ -3896,6 +3930,7 @@ sr_module_update_oper_diff(sr_conn_ctx_t *conn, const char *mod_name)
     sr_error_info_t *err_info = NULL;
     const struct lys_module *ly_mod;
     struct sr_mod_info_s mod_info;
+    sr_mod_t *shm_mod;
     sr_sid_t sid;
     struct lyd_node *diff = NULL;
 
@@ -3938,6 +3973,12 @@ sr_module_update_oper_diff(sr_conn_ctx_t *conn, const char *mod_name)
         goto cleanup;
     }
 
+    /* update module stored operational data version */
+    shm_mod = sr_shmmain_find_module(&conn->main_shm, conn->ext_shm.addr, mod_name, 0);
+    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+    ATOMIC_STORE_RELAXED(shm_mod->oper_subtrees, sr_diff_mod_subtrees(diff, ly_mod));
+    ATOMIC_INC_RELAXED(shm_mod->oper_ver);
+
 cleanup:
     /* MODULES UNLOCK */
     sr_shmmod_modinfo_unlock(&mod_info, 0);
@@ -60,8 +60,242 @@ enum insert_val {
     INSERT_AFTER
 };
 
+/**
+ * @brief Minimal number of merged or applied sibling nodes for building a sibling index.
+ */
+#define SR_DIFF_IDX_MIN_COUNT 16
+
+/**
+ * @brief Index of sibling instances. Diff trees are linked manually (see ::sr_diff_insert) and libyang does not
+ * hash top-level data siblings, so finding a sibling in either would be linear.
+ */
+struct sr_diff_idx_s {
+    struct {
+        struct lyd_node *node;  /**< Indexed node, NULL if the record is empty or removed. */
+        uint32_t hash;          /**< Hash of the node instance. */
+        int removed;            /**< Whether there was a node that was removed. */
+    } *recs;                    /**< Records with open addressing. */
+    uint32_t size;              /**< Number of records, always a power of 2. */
+    uint32_t used;              /**< Number of used records, including the removed ones. */
+};
+
+/**
+ * @brief Add data into a hash.
+ *
+ * @param[in] hash Current hash.
+ * @param[in] data Data to add.
+ * @param[in] len Length of @p data.
+ * @return Updated hash.
+ */
+static uint32_t
+sr_diff_hash_add(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *ptr = data;
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+        hash += ptr[i];
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Get a hash of a node instance. Only the schema and keys/value are used
+ * so that all the nodes matched by ::sr_edit_find() have the same hash.
+ *
+ * @param[in] node Node.
+ * @param[out] hash Instance hash.
+ * @return 0 if the node instance cannot be hashed, non-zero on success.
+ */
+static int
+sr_diff_node_hash(const struct lyd_node *node, uint32_t *hash)
+{
+    const struct lys_node_list *slist;
+    const struct lyd_node *key;
+    const char *str;
+    uint32_t h;
+    uint16_t i;
+
+    h = sr_diff_hash_add(0, &node->schema, sizeof node->schema);
+    switch (node->schema->nodetype) {
+    case LYS_LEAFLIST:
+        str = sr_ly_leaf_value_str(node);
+        h = sr_diff_hash_add(h, str, strlen(str));
+        break;
+    case LYS_LIST:
+        slist = (struct lys_node_list *)node->schema;
+        if (!slist->keys_size) {
+            /* keyless list instances can be matched only by their whole content */
+            return 0;
+        }
+        for (key = node->child, i = 0; i < slist->keys_size; key = key->next, ++i) {
+            if (!key || (key->schema != (struct lys_node *)slist->keys[i])) {
+                return 0;
+            }
+            /* include the terminating zero to separate the keys */
+            str = sr_ly_leaf_value_str(key);
+            h = sr_diff_hash_add(h, str, strlen(str) + 1);
+        }
+        break;
+    default:
+        break;
+    }
+
+    h += (h << 3);
+    h ^= (h >> 11);
+    h += (h << 15);
+    *hash = h;
+    return 1;
+}
+
+/**
+ * @brief Check whether 2 nodes are the same instance.
+ *
+ * @param[in] node1 First node.
+ * @param[in] node2 Second node.
+ * @return 0 if not, non-zero if they are.
+ */
+static int
+sr_diff_node_inst_equal(const struct lyd_node *node1, const struct lyd_node *node2)
+{
+    const struct lys_node_list *slist;
+    const struct lyd_node *key1, *key2;
+    uint16_t i;
+
+    if (node1->schema != node2->schema) {
+        return 0;
+    }
+
+    switch (node1->schema->nodetype) {
+    case LYS_LEAFLIST:
+        return !strcmp(sr_ly_leaf_value_str(node1), sr_ly_leaf_value_str(node2));
+    case LYS_LIST:
+        slist = (struct lys_node_list *)node1->schema;
+        for (key1 = node1->child, key2 = node2->child, i = 0; i < slist->keys_size; key1 = key1->next, key2 = key2->next, ++i) {
+            if (strcmp(sr_ly_leaf_value_str(key1), sr_ly_leaf_value_str(key2))) {
+                return 0;
+            }
+        }
+        return 1;
+    default:
+        return 1;
+    }
+}
+
+/**
+ * @brief Add a node into a sibling index.
+ *
+ * @param[in] idx Sibling index.
+ * @param[in] node Node to add.
+ */
+static void
+sr_diff_idx_add(struct sr_diff_idx_s *idx, struct lyd_node *node)
+{
+    uint32_t hash, i;
+
+    if (!idx || !idx->recs || !sr_diff_node_hash(node, &hash)) {
+        return;
+    }
+
+    /* there is always enough space, the index is created big enough */
+    assert(idx->used < idx->size);
+    for (i = hash & (idx->size - 1); idx->recs[i].node || idx->recs[i].removed; i = (i + 1) & (idx->size - 1));
+
+    idx->recs[i].node = node;
+    idx->recs[i].hash = hash;
+    ++idx->used;
+}
+
+/**
+ * @brief Create a sibling index.
+ *
+ * @param[in] first_sibling First sibling to index.
+ * @param[in] add_count Maximum number of siblings that will be added into the index.
+ * @param[out] idx Created sibling index.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_diff_idx_create(struct lyd_node *first_sibling, uint32_t add_count, struct sr_diff_idx_s *idx)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *iter;
+    uint32_t count = add_count;
+
+    memset(idx, 0, sizeof *idx);
+
+    LY_TREE_FOR(first_sibling, iter) {
+        ++count;
+    }
+
+    /* keep the index at most half full */
+    for (idx->size = 1; idx->size < 2 * count; idx->size <<= 1);
+    idx->recs = calloc(idx->size, sizeof *idx->recs);
+    SR_CHECK_MEM_RET(!idx->recs, err_info);
+
+    LY_TREE_FOR(first_sibling, iter) {
+        sr_diff_idx_add(idx, iter);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find a node instance in a sibling index.
+ *
+ * @param[in] idx Sibling index.
+ * @param[in] node Node instance to find.
+ * @param[out] match Matching diff node, NULL if there is none.
+ * @return 0 if the index cannot be used for the node, non-zero if it was searched.
+ */
+static int
+sr_diff_idx_find(const struct sr_diff_idx_s *idx, const struct lyd_node *node, struct lyd_node **match)
+{
+    uint32_t hash, i;
+
+    if (!idx || !idx->recs || !sr_diff_node_hash(node, &hash)) {
+        return 0;
+    }
+
+    *match = NULL;
+    for (i = hash & (idx->size - 1); idx->recs[i].node || idx->recs[i].removed; i = (i + 1) & (idx->size - 1)) {
+        if (idx->recs[i].node && (idx->recs[i].hash == hash) && sr_diff_node_inst_equal(idx->recs[i].node, node)) {
+            *match = idx->recs[i].node;
+            break;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Remove a node from a sibling index.
+ *
+ * @param[in] idx Sibling index.
+ * @param[in] node Node to remove.
+ */
+static void
+sr_diff_idx_del(struct sr_diff_idx_s *idx, const struct lyd_node *node)
+{
+    uint32_t hash, i;
+
+    if (!idx || !idx->recs || !sr_diff_node_hash(node, &hash)) {
+        return;
+    }
+
+    for (i = hash & (idx->size - 1); idx->recs[i].node || idx->recs[i].removed; i = (i + 1) & (idx->size - 1)) {
+        if (idx->recs[i].node == node) {
+            idx->recs[i].node = NULL;
+            idx->recs[i].removed = 1;
+            break;
+        }
+    }
+}
+
 static sr_error_info_t *sr_diff_merge_r(const struct lyd_node *src_node, enum edit_op parent_op, void *oper_conn,
-        struct lyd_node *diff_parent, struct lyd_node **diff_root, int *change);
+        struct lyd_node *diff_parent, struct lyd_node **diff_root, struct sr_diff_idx_s *idx, int *change);
 
 /**
  * @brief Find a previous (leaf-)list instance.
@@ -179,6 +413,82 @@ sr_edit_find_userord_predicate(const struct lyd_node *sibling, const struct lyd_
     return NULL;
 }
 
+/**
+ * @brief Learn whether a found matching node in data tree equals the edit node even in its value.
+ *
+ * @param[in] first_node First sibling in the data tree.
+ * @param[in] edit_node Edit node to match.
+ * @param[in] op Operation of the edit node.
+ * @param[in] insert Optional insert place of the operation.
+ * @param[in] key_or_value Optional predicate of relative (leaf-)list instance of the operation.
+ * @param[in] match Matching node.
+ * @param[out] val_equal_p Whether even the value matches.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_edit_find_val_equal(const struct lyd_node *first_node, const struct lyd_node *edit_node, enum edit_op op,
+        enum insert_val insert, const char *key_or_value, const struct lyd_node *match, int *val_equal_p)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *anchor_node;
+
+    switch (edit_node->schema->nodetype) {
+    case LYS_CONTAINER:
+        *val_equal_p = 1;
+        break;
+    case LYS_LEAF:
+        if ((op == EDIT_REMOVE) || (op == EDIT_DELETE) || (op == EDIT_PURGE)) {
+            /* we do not care about the value in this case */
+            *val_equal_p = 1;
+        } else if ((match->dflt != edit_node->dflt) || strcmp(sr_ly_leaf_value_str(match), sr_ly_leaf_value_str(edit_node))) {
+            /* check whether the value or at least dflt flag is different */
+            *val_equal_p = 0;
+        } else {
+            /* canonical values are the same */
+            *val_equal_p = 1;
+        }
+        break;
+    case LYS_ANYXML:
+    case LYS_ANYDATA:
+        if ((op == EDIT_REMOVE) || (op == EDIT_DELETE) || (op == EDIT_PURGE)) {
+            /* we do not care about the value in this case */
+            *val_equal_p = 1;
+        } else {
+            /* compare values */
+            if ((err_info = sr_lyd_anydata_equal(match, edit_node, val_equal_p))) {
+                return err_info;
+            }
+        }
+        break;
+    case LYS_LIST:
+    case LYS_LEAFLIST:
+        if (sr_ly_is_userord(edit_node)) {
+            /* check if even the order matches for user-ordered (leaf-)lists */
+            anchor_node = NULL;
+            if (key_or_value) {
+                /* find the anchor node if set */
+                if ((err_info = sr_edit_find_userord_predicate(first_node, match, key_or_value, &anchor_node))) {
+                    return err_info;
+                }
+            }
+            /* check for move */
+            if (sr_edit_userord_is_moved(match, insert, anchor_node)) {
+                *val_equal_p = 0;
+            } else {
+                *val_equal_p = 1;
+            }
+        } else {
+            *val_equal_p = 1;
+        }
+        break;
+    default:
+        SR_ERRINFO_INT(&err_info);
+        return err_info;
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Find a matching node in data tree for an edit node.
  *
@@ -196,7 +506,6 @@ sr_edit_find(const struct lyd_node *first_node, const struct lyd_node *edit_node
         const char *key_or_value, struct lyd_node **match_p, int *val_equal_p)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *anchor_node;
     const struct lyd_node *iter, *match = NULL;
     int val_equal = 0;
 
@@ -216,60 +525,8 @@ sr_edit_find(const struct lyd_node *first_node, const struct lyd_node *edit_node
             return err_info;
         }
 
-        if (match) {
-            switch (edit_node->schema->nodetype) {
-            case LYS_CONTAINER:
-                val_equal = 1;
-                break;
-            case LYS_LEAF:
-                if ((op == EDIT_REMOVE) || (op == EDIT_DELETE) || (op == EDIT_PURGE)) {
-                    /* we do not care about the value in this case */
-                    val_equal = 1;
-                } else if ((match->dflt != edit_node->dflt) || strcmp(sr_ly_leaf_value_str(match), sr_ly_leaf_value_str(edit_node))) {
-                    /* check whether the value or at least dflt flag is different */
-                    val_equal = 0;
-                } else {
-                    /* canonical values are the same */
-                    val_equal = 1;
-                }
-                break;
-            case LYS_ANYXML:
-            case LYS_ANYDATA:
-                if ((op == EDIT_REMOVE) || (op == EDIT_DELETE) || (op == EDIT_PURGE)) {
-                    /* we do not care about the value in this case */
-                    val_equal = 1;
-                } else {
-                    /* compare values */
-                    if ((err_info = sr_lyd_anydata_equal(match, edit_node, &val_equal))) {
-                        return err_info;
-                    }
-                }
-                break;
-            case LYS_LIST:
-            case LYS_LEAFLIST:
-                if (sr_ly_is_userord(edit_node)) {
-                    /* check if even the order matches for user-ordered (leaf-)lists */
-                    anchor_node = NULL;
-                    if (key_or_value) {
-                        /* find the anchor node if set */
-                        if ((err_info = sr_edit_find_userord_predicate(first_node, match, key_or_value, &anchor_node))) {
-                            return err_info;
-                        }
-                    }
-                    /* check for move */
-                    if (sr_edit_userord_is_moved(match, insert, anchor_node)) {
-                        val_equal = 0;
-                    } else {
-                        val_equal = 1;
-                    }
-                } else {
-                    val_equal = 1;
-                }
-                break;
-            default:
-                SR_ERRINFO_INT(&err_info);
-                return err_info;
-            }
+        if (match && (err_info = sr_edit_find_val_equal(first_node, edit_node, op, insert, key_or_value, match, &val_equal))) {
+            return err_info;
         }
     }
 
@@ -1540,20 +1797,22 @@ sr_edit_apply_delete(struct lyd_node *match_node, const struct lyd_node *edit_no
  * @param[in] parent_op Parent operation.
  * @param[in] diff_parent Current sysrepo diff parent.
  * @param[in,out] diff_root Sysrepo diff root node.
+ * @param[in,out] idx Optional index of the data siblings of @p first_node, is kept updated.
  * @param[in] flags Flags modifying the behavior.
  * @param[out] change Set if there are some data changes.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_edit_apply_r(struct lyd_node **first_node, struct lyd_node *parent_node, const struct lyd_node *edit_node,
-        enum edit_op parent_op, struct lyd_node *diff_parent, struct lyd_node **diff_root, int flags, int *change)
+        enum edit_op parent_op, struct lyd_node *diff_parent, struct lyd_node **diff_root, struct sr_diff_idx_s *idx,
+        int flags, int *change)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *match = NULL, *child, *next, *edit_match, *diff_node = NULL;
     enum edit_op op, next_op, prev_op = 0;
     enum insert_val insert;
     const char *key_or_value, *origin;
-    int val_equal;
+    int val_equal, new_match;
 
     assert(first_node || (flags & EDIT_APPLY_CHECK_OP_R));
     /* if data node is set, it must be the first sibling */
@@ -1569,6 +1828,14 @@ reapply:
     if (flags & EDIT_APPLY_CHECK_OP_R) {
         /* we have no data */
         match = NULL;
+    } else if (!((op == EDIT_PURGE) && (edit_node->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)))
+            && sr_diff_idx_find(idx, edit_node, &match)) {
+        /* found in the index */
+        val_equal = 0;
+        if (match && (err_info = sr_edit_find_val_equal(*first_node, edit_node, op, insert, key_or_value, match,
+                &val_equal))) {
+            return err_info;
+        }
     } else {
         if ((err_info = sr_edit_find(*first_node, edit_node, op, insert, key_or_value, &match, &val_equal))) {
             return err_info;
@@ -1600,6 +1867,10 @@ reapply:
                     &diff_node, &next_op, change))) {
                 goto op_error;
             }
+            if (next_op == EDIT_CONTINUE) {
+                /* a new sibling was inserted */
+                sr_diff_idx_add(idx, match);
+            }
             break;
         case EDIT_MERGE:
             if (flags & EDIT_APPLY_CHECK_OP_R) {
@@ -1625,12 +1896,21 @@ reapply:
                     &next_op, &flags, change))) {
                 goto op_error;
             }
+            if (match) {
+                /* the sibling was unlinked */
+                sr_diff_idx_del(idx, match);
+            }
             break;
         case EDIT_MOVE:
+            new_match = match ? 0 : 1;
             if ((err_info = sr_edit_apply_move(first_node, parent_node, edit_node, &match, insert, key_or_value,
                     diff_parent, diff_root, &diff_node, &next_op, change))) {
                 goto op_error;
             }
+            if (new_match) {
+                /* a new sibling was inserted */
+                sr_diff_idx_add(idx, match);
+            }
             break;
         case EDIT_NONE:
             if ((err_info = sr_edit_apply_none(match, edit_node, diff_parent, diff_root, &diff_node, &next_op))) {
@@ -1683,19 +1963,19 @@ reapply:
                 return err_info;
             }
             if (!edit_match && (err_info = sr_edit_apply_r(&match->child, match, child, EDIT_DELETE, diff_parent,
-                    diff_root, flags, change))) {
+                    diff_root, NULL, flags, change))) {
                 return err_info;
             }
         }
     }
 
-    /* apply edit recursively */
+    /* apply edit recursively, children of inner data nodes are hashed by libyang */
     LY_TREE_FOR(sr_lyd_child(edit_node, 1), child) {
         if (flags & EDIT_APPLY_CHECK_OP_R) {
             /* we do not operate with any datastore data or diff anymore */
-            err_info = sr_edit_apply_r(NULL, NULL, child, op, NULL, NULL, flags, change);
+            err_info = sr_edit_apply_r(NULL, NULL, child, op, NULL, NULL, NULL, flags, change);
         } else {
-            err_info = sr_edit_apply_r(&match->child, match, child, op, diff_parent, diff_root, flags, change);
+            err_info = sr_edit_apply_r(&match->child, match, child, op, diff_parent, diff_root, NULL, flags, change);
         }
         if (err_info) {
             return err_info;
@@ -1727,11 +2007,23 @@ sr_edit_mod_apply(const struct lyd_node *edit, const struct lys_module *ly_mod,
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *root;
     struct lyd_node *mod_diff;
+    struct sr_diff_idx_s idx = {0};
+    uint32_t count = 0;
 
     if (change) {
         *change = 0;
     }
 
+    /* index the top-level data nodes if many are edited, libyang does not hash them */
+    LY_TREE_FOR(edit, root) {
+        if (lyd_node_module(root) == ly_mod) {
+            ++count;
+        }
+    }
+    if ((count >= SR_DIFF_IDX_MIN_COUNT) && (err_info = sr_diff_idx_create(*data, count, &idx))) {
+        return err_info;
+    }
+
     LY_TREE_FOR(edit, root) {
         if (lyd_node_module(root) != ly_mod) {
             /* skip data nodes from different modules */
@@ -1740,9 +2032,10 @@ sr_edit_mod_apply(const struct lyd_node *edit, const struct lys_module *ly_mod,
 
         /* apply relevant nodes from the edit datatree */
         mod_diff = NULL;
-        if ((err_info = sr_edit_apply_r(data, NULL, root, EDIT_CONTINUE, NULL, diff ? &mod_diff : NULL, 0, change))) {
+        if ((err_info = sr_edit_apply_r(data, NULL, root, EDIT_CONTINUE, NULL, diff ? &mod_diff : NULL, &idx, 0,
+                change))) {
             lyd_free_withsiblings(mod_diff);
-            return err_info;
+            goto cleanup;
         }
 
         if (diff && mod_diff) {
@@ -1750,15 +2043,17 @@ sr_edit_mod_apply(const struct lyd_node *edit, const struct lys_module *ly_mod,
             if (!*diff) {
                 *diff = mod_diff;
             } else {
-                if ((err_info = sr_diff_merge_r(mod_diff, EDIT_CONTINUE, NULL, NULL, diff, NULL))) {
-                    return err_info;
+                if ((err_info = sr_diff_merge_r(mod_diff, EDIT_CONTINUE, NULL, NULL, diff, NULL, NULL))) {
+                    goto cleanup;
                 }
                 lyd_free_withsiblings(mod_diff);
             }
         }
     }
 
-    return NULL;
+cleanup:
+    free(idx.recs);
+    return err_info;
 }
 
 /**
@@ -2245,20 +2540,23 @@ sr_diff_check_pid_conn(struct lyd_node *diff_node, pid_t cur_pid, void *cur_conn
  * @param[in] oper_conn Connection pointer in case it is operational diff. Otherwise should be NULL.
  * @param[in] diff_parent Current sysrepo diff parent.
  * @param[in,out] diff_root Sysrepo diff root node.
+ * @param[in,out] idx Optional index of the siblings of the matching diff node, is kept updated.
  * @param[out] change Set if there are some data changes.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_diff_merge_r(const struct lyd_node *src_node, enum edit_op parent_op, void *oper_conn, struct lyd_node *diff_parent,
-        struct lyd_node **diff_root, int *change)
+        struct lyd_node **diff_root, struct sr_diff_idx_s *idx, int *change)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_node *child, *diff_node = NULL;
+    struct sr_diff_idx_s child_idx = {0};
     enum edit_op src_op, cur_op;
     pid_t pid;
     void *conn_ptr;
     const char *key_or_value, *origin, *cur_origin;
     int val_equal, op_own, attr_own, origin_own;
+    uint32_t child_count;
 
     /* get this node operation */
     if ((err_info = sr_edit_op(src_node, parent_op, &src_op, NULL, &key_or_value))) {
@@ -2266,8 +2564,13 @@ sr_diff_merge_r(const struct lyd_node *src_node, enum edit_op parent_op, void *o
     }
 
     /* find an equal node in the current diff */
-    if ((err_info = sr_edit_find(diff_parent ? sr_lyd_child(diff_parent, 1) : *diff_root, src_node, src_op, INSERT_DEFAULT,
-            NULL, &diff_node, &val_equal))) {
+    if (sr_diff_idx_find(idx, src_node, &diff_node)) {
+        if (diff_node && (err_info = sr_edit_find_val_equal(diff_parent ? sr_lyd_child(diff_parent, 1) : *diff_root,
+                src_node, src_op, INSERT_DEFAULT, NULL, diff_node, &val_equal))) {
+            return err_info;
+        }
+    } else if ((err_info = sr_edit_find(diff_parent ? sr_lyd_child(diff_parent, 1) : *diff_root, src_node, src_op,
+            INSERT_DEFAULT, NULL, &diff_node, &val_equal))) {
         return err_info;
     }
 
@@ -2328,17 +2631,30 @@ sr_diff_merge_r(const struct lyd_node *src_node, enum edit_op parent_op, void *o
         /* update diff parent */
         diff_parent = diff_node;
 
+        /* index the diff children if there are many to merge, they are not hashed by libyang */
+        child_count = 0;
+        LY_TREE_FOR(sr_lyd_child(src_node, 1), child) {
+            ++child_count;
+        }
+        if ((child_count >= SR_DIFF_IDX_MIN_COUNT) && (err_info = sr_diff_idx_create(sr_lyd_child(diff_parent, 1),
+                child_count, &child_idx))) {
+            return err_info;
+        }
+
         /* merge src_diff recursively */
         LY_TREE_FOR(sr_lyd_child(src_node, 1), child) {
-            if ((err_info = sr_diff_merge_r(child, src_op, oper_conn, diff_parent, diff_root, change))) {
+            if ((err_info = sr_diff_merge_r(child, src_op, oper_conn, diff_parent, diff_root, &child_idx, change))) {
+                free(child_idx.recs);
                 return err_info;
             }
         }
+        free(child_idx.recs);
     } else {
         /* add new diff node with all descendants */
         if ((err_info = sr_diff_add(src_node, diff_parent, diff_root, &diff_node))) {
             return err_info;
         }
+        sr_diff_idx_add(idx, diff_node);
         if (change) {
             *change = 1;
         }
@@ -2377,6 +2693,7 @@ sr_diff_merge_r(const struct lyd_node *src_node, enum edit_op parent_op, void *o
         if (diff_parent == *diff_root) {
             *diff_root = (*diff_root)->next;
         }
+        sr_diff_idx_del(idx, diff_parent);
         lyd_free(diff_parent);
     }
 
@@ -2394,11 +2711,23 @@ sr_diff_mod_merge(const struct lyd_node *src_diff, void *oper_conn, const struct
 {
     sr_error_info_t *err_info = NULL;
     const struct lyd_node *src_node;
+    struct sr_diff_idx_s idx = {0};
+    uint32_t count = 0;
 
     if (change) {
         *change = 0;
     }
 
+    /* index the diff top-level nodes if there are many to merge */
+    LY_TREE_FOR(src_diff, src_node) {
+        if (lyd_node_module(src_node) == ly_mod) {
+            ++count;
+        }
+    }
+    if ((count >= SR_DIFF_IDX_MIN_COUNT) && (err_info = sr_diff_idx_create(*diff, count, &idx))) {
+        return err_info;
+    }
+
     LY_TREE_FOR(src_diff, src_node) {
         if (lyd_node_module(src_node) != ly_mod) {
             /* skip data nodes from different modules */
@@ -2406,12 +2735,14 @@ sr_diff_mod_merge(const struct lyd_node *src_diff, void *oper_conn, const struct
         }
 
         /* apply relevant nodes from the diff datatree */
-        if ((err_info = sr_diff_merge_r(src_node, EDIT_CONTINUE, oper_conn, NULL, diff, change))) {
-            return err_info;
+        if ((err_info = sr_diff_merge_r(src_node, EDIT_CONTINUE, oper_conn, NULL, diff, &idx, change))) {
+            goto cleanup;
         }
     }
 
-    return NULL;
+cleanup:
+    free(idx.recs);
+    return err_info;
 }
 
 /**
@@ -2835,6 +3166,21 @@ sr_diff_mod_update(struct lyd_node **diff, const struct lys_module *ly_mod, cons
     return NULL;
 }
 
+uint32_t
+sr_diff_mod_subtrees(const struct lyd_node *diff, const struct lys_module *ly_mod)
+{
+    const struct lyd_node *root;
+    uint32_t mask = 0;
+
+    LY_TREE_FOR(diff, root) {
+        if (lyd_node_module(root) == ly_mod) {
+            mask |= 1U << (sr_str_hash(root->schema->name) % 32);
+        }
+    }
+
+    return mask;
+}
+
 sr_error_info_t *
 sr_ly_val_diff_merge(struct lyd_node **diff, LYD_DIFFTYPE type, struct lyd_node *first, struct lyd_node *second,
         struct ly_ctx *ly_ctx, int *change)
@@ -2883,13 +3229,13 @@ sr_ly_val_diff_merge(struct lyd_node **diff, LYD_DIFFTYPE type, struct lyd_node
     /* merge this one subtree with siblings */
     if (type == LYD_DIFF_CREATED) {
         LY_TREE_FOR(second, tmp) {
-            if ((err_info = sr_diff_merge_r(tmp, EDIT_CREATE, NULL, diff_parent, diff, change))) {
+            if ((err_info = sr_diff_merge_r(tmp, EDIT_CREATE, NULL, diff_parent, diff, NULL, change))) {
                 return err_info;
             }
         }
     } else {
         LY_TREE_FOR(first, tmp) {
-            if ((err_info = sr_diff_merge_r(tmp, EDIT_DELETE, NULL, diff_parent, diff, change))) {
+            if ((err_info = sr_diff_merge_r(tmp, EDIT_DELETE, NULL, diff_parent, diff, NULL, change))) {
                 return err_info;
             }
         }
@@ -3424,6 +3770,225 @@ error:
     return err_info;
 }
 
+/**
+ * @brief Learn where all the node segments of a simple data path end.
+ *
+ * @param[in] path Path to examine.
+ * @param[in,out] seg_ends Array of offsets of the ends of the segments (the next '/' or the terminating 0).
+ * @param[in,out] seg_size Allocated size of @p seg_ends.
+ * @param[out] seg_count Number of segments.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_edit_path_segments(const char *path, uint32_t **seg_ends, uint32_t *seg_size, uint32_t *seg_count)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+    char quot = 0;
+    int depth = 0;
+    void *mem;
+
+    *seg_count = 0;
+    for (i = 1; ; ++i) {
+        if (quot) {
+            if (path[i] == quot) {
+                quot = 0;
+            }
+            continue;
+        }
+
+        if ((path[i] == '\'') || (path[i] == '\"')) {
+            quot = path[i];
+        } else if (path[i] == '[') {
+            ++depth;
+        } else if (path[i] == ']') {
+            --depth;
+        } else if (!path[i] || ((path[i] == '/') && !depth)) {
+            /* segment end */
+            if (*seg_count == *seg_size) {
+                mem = realloc(*seg_ends, (*seg_size + 8) * sizeof **seg_ends);
+                SR_CHECK_MEM_RET(!mem, err_info);
+                *seg_ends = mem;
+                *seg_size += 8;
+            }
+            (*seg_ends)[*seg_count] = i;
+            ++(*seg_count);
+
+            if (!path[i]) {
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check and normalize operations of an edit subtree, recursively.
+ *
+ * @param[in] edit_node Edit node to check.
+ * @param[in] parent_op Parent operation, ::EDIT_CONTINUE for top-level nodes.
+ * @param[out] redundant Whether the whole subtree is redundant and can be dropped.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_edit_check_r(struct lyd_node *edit_node, enum edit_op parent_op, int *redundant)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *child, *next;
+    enum edit_op op;
+    int child_redundant;
+
+    *redundant = 0;
+
+    /* get this node operation, also checks the attributes */
+    if ((err_info = sr_edit_op(edit_node, parent_op, &op, NULL, NULL))) {
+        return err_info;
+    }
+
+    if ((parent_op != EDIT_CONTINUE) && sr_edit_find_oper(edit_node, 0, NULL)) {
+        switch (parent_op) {
+        case EDIT_DELETE:
+        case EDIT_REMOVE:
+        case EDIT_PURGE:
+            if ((op == EDIT_CREATE) || (op == EDIT_MERGE) || (op == EDIT_REPLACE)) {
+                goto op_error;
+            } else if (op == EDIT_REMOVE) {
+                /* removed with the parent */
+                *redundant = 1;
+                return NULL;
+            }
+            break;
+        case EDIT_CREATE:
+            if (op == EDIT_DELETE) {
+                /* a created node cannot have any children to delete */
+                goto op_error;
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (op == parent_op) {
+            /* inherited anyway */
+            sr_edit_del_attr(edit_node, "operation");
+        }
+    }
+
+    LY_TREE_FOR_SAFE(sr_lyd_child(edit_node, 1), next, child) {
+        if ((err_info = sr_edit_check_r(child, op, &child_redundant))) {
+            return err_info;
+        }
+        if (child_redundant) {
+            lyd_free(child);
+        }
+    }
+
+    return NULL;
+
+op_error:
+    sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, NULL, "Operation \"%s\" cannot have children with operation \"%s\".",
+            sr_edit_op2str(parent_op), sr_edit_op2str(op));
+    return err_info;
+}
+
+sr_error_info_t *
+sr_edit_check(struct lyd_node *edit)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *root;
+    int redundant;
+
+    LY_TREE_FOR(edit, root) {
+        if ((err_info = sr_edit_check_r(root, EDIT_CONTINUE, &redundant))) {
+            return err_info;
+        }
+        assert(!redundant);
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_edit_items_create(struct ly_ctx *ly_ctx, const sr_edit_item_t *items, size_t item_count, struct lyd_node **edit)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node, *parent, *prev_node = NULL;
+    const char *prev_path = NULL;
+    uint32_t *ends = NULL, *prev_ends = NULL, *tmp_ends, size = 0, prev_size = 0, count, prev_count = 0, j, k;
+    size_t i;
+    int opts;
+
+    *edit = NULL;
+
+    for (i = 0; i < item_count; ++i) {
+        if ((err_info = sr_edit_path_segments(items[i].path, &ends, &size, &count))) {
+            goto error;
+        }
+
+        /* learn how many parent nodes are shared with the previous change */
+        k = 0;
+        if (prev_node) {
+            for (k = (count - 1 < prev_count) ? count - 1 : prev_count; k; --k) {
+                if ((ends[k - 1] == prev_ends[k - 1]) && !strncmp(items[i].path, prev_path, ends[k - 1])) {
+                    break;
+                }
+            }
+        }
+
+        opts = LYD_PATH_OPT_NOPARENTRET;
+        if (items[i].operation && (!strcmp(items[i].operation, "remove") || !strcmp(items[i].operation, "delete"))) {
+            opts |= LYD_PATH_OPT_EDIT;
+        }
+
+        if (k) {
+            /* create the node in the shared parent, relative path */
+            for (parent = prev_node, j = prev_count; j > k; --j) {
+                parent = parent->parent;
+            }
+            node = lyd_new_path(parent, NULL, items[i].path + ends[k - 1] + 1, (void *)items[i].value, 0, opts);
+        } else {
+            node = lyd_new_path(*edit, ly_ctx, items[i].path, (void *)items[i].value, 0, opts);
+        }
+        if (!node) {
+            sr_errinfo_new_ly(&err_info, ly_ctx);
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Invalid change \"%s\" of the datastore edit.",
+                    items[i].path);
+            goto error;
+        }
+        if (!*edit) {
+            for (*edit = node; (*edit)->parent; *edit = (*edit)->parent);
+        }
+
+        /* add the operation of the node */
+        if (items[i].operation && (err_info = sr_edit_set_oper(node, items[i].operation))) {
+            goto error;
+        }
+
+        /* remember this change */
+        prev_node = node;
+        prev_path = items[i].path;
+        prev_count = count;
+        tmp_ends = prev_ends;
+        prev_ends = ends;
+        ends = tmp_ends;
+        j = prev_size;
+        prev_size = size;
+        size = j;
+    }
+
+    free(ends);
+    free(prev_ends);
+    return NULL;
+
+error:
+    free(ends);
+    free(prev_ends);
+    lyd_free_withsiblings(*edit);
+    *edit = NULL;
+    return err_info;
+}
+
 sr_error_info_t *
 sr_diff_set_getnext(struct ly_set *set, uint32_t *idx, struct lyd_node **node, sr_change_oper_t *op)
 {
@@ -121,6 +121,16 @@ sr_error_info_t *sr_diff_mod_apply(const struct lyd_node *diff, const struct lys
  */
 sr_error_info_t *sr_diff_mod_update(struct lyd_node **diff, const struct lys_module *ly_mod, const struct lyd_node *mod_data);
 
+/**
+ * @brief Get the summary of top-level subtrees of a module present in a diff.
+ * Every top-level node sets one bit selected by the hash of its name so the summary is the same in all processes.
+ *
+ * @param[in] diff Diff to examine.
+ * @param[in] ly_mod Module of the subtrees.
+ * @return Subtree bit mask, 0 if there are no subtrees of @p ly_mod.
+ */
+uint32_t sr_diff_mod_subtrees(const struct lyd_node *diff, const struct lys_module *ly_mod);
+
 /**
  * @brief Merge libyang validation diff into sysrepo diff.
  *
@@ -163,6 +173,28 @@ sr_error_info_t *sr_edit_add(sr_session_ctx_t *session, const char *xpath, const
         const char *def_operation, const sr_move_position_t *position, const char *keys, const char *val,
         const char *origin, int isolate);
 
+/**
+ * @brief Check operations of a whole edit without any data and normalize them.
+ * Operations same as the inherited ones are removed and redundant removals are dropped.
+ *
+ * @param[in] edit Edit to check and normalize.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_edit_check(struct lyd_node *edit);
+
+/**
+ * @brief Create a new edit from a batch of changes. Consecutive changes sharing a parent
+ * create their nodes directly in the parent created by the previous change.
+ *
+ * @param[in] ly_ctx Libyang context to use.
+ * @param[in] items Array of changes.
+ * @param[in] item_count Count of @p items.
+ * @param[out] edit Created edit.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_edit_items_create(struct ly_ctx *ly_ctx, const sr_edit_item_t *items, size_t item_count,
+        struct lyd_node **edit);
+
 /**
  * @brief Get next change from a sysrepo diff set.
  *
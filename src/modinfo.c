@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <ctype.h>
 #include <assert.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -433,25 +434,18 @@ sr_xpath_oper_data_predicate_required(const char *pred1, int len1, const char *p
 }
 
 /**
- * @brief Check whether operational data are required.
+ * @brief Check whether operational data are required by a single path.
  *
- * @param[in] request_xpath Get request XPath.
+ * @param[in] request_xpath Get request path.
  * @param[in] sub_xpath Operational subscription XPath.
  * @return 0 if not required, non-zero if required.
  */
 static int
-sr_xpath_oper_data_required(const char *request_xpath, const char *sub_xpath)
+sr_xpath_oper_data_path_required(const char *request_xpath, const char *sub_xpath)
 {
     const char *xpath1, *xpath2, *mod1, *mod2, *name1, *name2, *pred1, *pred2;
     int wildc1, wildc2, mlen1, mlen2, len1, len2, dslash1, dslash2, has_pred1, has_pred2;
 
-    assert(sub_xpath);
-
-    if (!request_xpath) {
-        /* we do not know, say it is required */
-        return 1;
-    }
-
     xpath1 = request_xpath;
     xpath2 = sub_xpath;
     do {
@@ -523,776 +517,2540 @@ sr_xpath_oper_data_required(const char *request_xpath, const char *sub_xpath)
 }
 
 /**
- * @brief Get specific operational data from a subscriber.
+ * @brief Find the separator of the first path in an XPath union. Separators inside predicates
+ * and function arguments are skipped.
  *
- * @param[in] ly_mod libyang module of the data.
- * @param[in] xpath XPath of the provided data.
- * @param[in] request_xpath XPath of the data request.
- * @param[in] sid Sysrepo session ID.
- * @param[in] evpipe_num Subscriber event pipe number.
- * @param[in] parent Data parent required for the subscription, NULL if top-level.
- * @param[in] timeout_ms Operational callback timeout in milliseconds.
- * @param[out] data Data tree with appended operational data.
- * @param[out] cb_error_info Callback error info returned by the client, if any.
- * @return err_info, NULL on success.
+ * @param[in] xpath XPath to examine.
+ * @return Pointer to the '|' separator, NULL if @p xpath is not a union.
  */
-static sr_error_info_t *
-sr_xpath_oper_data_get(const struct lys_module *ly_mod, const char *xpath, const char *request_xpath, sr_sid_t sid,
-        uint32_t evpipe_num, const struct lyd_node *parent, uint32_t timeout_ms, struct lyd_node **oper_data,
-        sr_error_info_t **cb_error_info)
+static const char *
+sr_xpath_union_sep(const char *xpath)
 {
-    sr_error_info_t *err_info = NULL;
-    struct lyd_node *parent_dup = NULL, *last_parent;
-    char *parent_path = NULL;
-
-    *oper_data = NULL;
+    char quot = 0;
+    int depth = 0;
 
-    if (parent) {
-        /* duplicate parent so that it is a stand-alone subtree */
-        last_parent = lyd_dup(parent, LYD_DUP_OPT_WITH_PARENTS | LYD_DUP_OPT_WITH_KEYS);
-        if (!last_parent) {
-            sr_errinfo_new_ly(&err_info, ly_mod->ctx);
-            return err_info;
+    for ( ; xpath[0]; ++xpath) {
+        if (quot) {
+            if (xpath[0] == quot) {
+                quot = 0;
+            }
+        } else if ((xpath[0] == '\'') || (xpath[0] == '\"')) {
+            quot = xpath[0];
+        } else if ((xpath[0] == '[') || (xpath[0] == '(')) {
+            ++depth;
+        } else if ((xpath[0] == ']') || (xpath[0] == ')')) {
+            --depth;
+        } else if ((xpath[0] == '|') && !depth) {
+            return xpath;
         }
+    }
 
-        /* go top-level */
-        for (parent_dup = last_parent; parent_dup->parent; parent_dup = parent_dup->parent);
+    return NULL;
+}
 
-        if (request_xpath) {
-            /* check whether the parent would not be filtered out */
-            parent_path = lyd_path(last_parent);
-            SR_CHECK_MEM_GOTO(!parent_path, err_info, cleanup);
+/**
+ * @brief Check whether operational data are required.
+ *
+ * @param[in] request_xpath Get request XPath, may be a union of paths.
+ * @param[in] sub_xpath Operational subscription XPath.
+ * @return 0 if not required, non-zero if required.
+ */
+static int
+sr_xpath_oper_data_required(const char *request_xpath, const char *sub_xpath)
+{
+    const char *sep;
+    char *path;
+    int len, required;
 
-            if (!sr_xpath_oper_data_required(request_xpath, parent_path)) {
-                goto cleanup;
-            }
-        }
-    }
+    assert(sub_xpath);
 
-    /* get data from client */
-    if ((err_info = sr_shmsub_oper_notify(ly_mod, xpath, request_xpath, parent_dup, sid, evpipe_num, timeout_ms,
-            oper_data, cb_error_info))) {
-        goto cleanup;
+    if (!request_xpath) {
+        /* we do not know, say it is required */
+        return 1;
     }
 
-    if (*oper_data) {
-        /* add default state data so that parents exist and we ask for descendants
-         * that can exist (it should not fail with TRUSTED flag, we do not care even if it does) */
-        lyd_validate_modules(oper_data, &ly_mod, 1, LYD_OPT_DATA | LYD_OPT_TRUSTED);
+    /* union, required if any of its paths requires them */
+    while ((sep = sr_xpath_union_sep(request_xpath))) {
+        len = sep - request_xpath;
+        while (len && isspace(request_xpath[len - 1])) {
+            --len;
+        }
+        path = strndup(request_xpath, len);
+        if (!path) {
+            /* we do not know, say it is required */
+            return 1;
+        }
+        required = sr_xpath_oper_data_path_required(path, sub_xpath);
+        free(path);
+        if (required) {
+            return 1;
+        }
+
+        /* next path */
+        request_xpath = sep + 1;
+        while (isspace(request_xpath[0])) {
+            ++request_xpath;
+        }
     }
 
-cleanup:
-    lyd_free_withsiblings(parent_dup);
-    free(parent_path);
-    return err_info;
+    return sr_xpath_oper_data_path_required(request_xpath, sub_xpath);
 }
 
 /**
- * @brief Append operational data for a specific XPath.
+ * @brief Learn the paths of a get request XPath that require operational data of a subscription.
  *
- * @param[in] shm_msub SHM subscription.
- * @param[in] ly_mod Module of the data to get.
- * @param[in] sub_xpath Subscription XPath.
- * @param[in] request_xpath XPath of the specific data request.
- * @param[in] oper_parent Operational parent of the data to retrieve. NULL for top-level.
- * @param[in] sid Sysrepo session ID.
- * @param[in] timeout_ms Operational callback timeout in milliseconds.
- * @param[in,out] data Operational data tree.
- * @param[out] cb_error_info Callback error info returned by the client, if any.
+ * @param[in] request_xpath Get request XPath, may be a union of paths.
+ * @param[in] sub_xpath Operational subscription XPath.
+ * @param[out] sub_request_xpath Union of only the paths of @p request_xpath requiring the data,
+ * NULL if @p request_xpath is not set.
+ * @param[out] required 0 if the data are not required by any path, non-zero if they are.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_xpath_oper_data_append(sr_mod_oper_sub_t *shm_msub, const struct lys_module *ly_mod, const char *sub_xpath,
-        const char *request_xpath, struct lyd_node *oper_parent, sr_sid_t sid, uint32_t timeout_ms,
-        struct lyd_node **data, sr_error_info_t **cb_error_info)
+sr_xpath_oper_data_request(const char *request_xpath, const char *sub_xpath, char **sub_request_xpath, int *required)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *oper_data;
+    const char *sep, *path;
+    char *path_dup = NULL, *mem;
+    int len, cur_len = 0, all = 1;
 
-    /* get oper data from the client */
-    if ((err_info = sr_xpath_oper_data_get(ly_mod, sub_xpath, request_xpath, sid, shm_msub->evpipe_num,
-            oper_parent, timeout_ms, &oper_data, cb_error_info))) {
-        return err_info;
+    *sub_request_xpath = NULL;
+
+    if (!request_xpath) {
+        /* we do not know, say it is required */
+        *required = 1;
+        return NULL;
     }
 
-    /* merge into one data tree */
-    if (!*data) {
-        *data = oper_data;
-    } else if (oper_data && lyd_merge(*data, oper_data, LYD_OPT_DESTRUCT)) {
-        lyd_free_withsiblings(oper_data);
-        sr_errinfo_new_ly(&err_info, ly_mod->ctx);
-        return err_info;
+    path = request_xpath;
+    do {
+        sep = sr_xpath_union_sep(path);
+        len = sep ? sep - path : (int)strlen(path);
+        while (len && isspace(path[len - 1])) {
+            --len;
+        }
+        path_dup = strndup(path, len);
+        SR_CHECK_MEM_GOTO(!path_dup, err_info, cleanup);
+
+        if (sr_xpath_oper_data_path_required(path_dup, sub_xpath)) {
+            /* append the path */
+            mem = realloc(*sub_request_xpath, cur_len + (cur_len ? 3 : 0) + len + 1);
+            SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+            *sub_request_xpath = mem;
+            cur_len += sprintf(*sub_request_xpath + cur_len, "%s%s", cur_len ? " | " : "", path_dup);
+        } else {
+            all = 0;
+        }
+        free(path_dup);
+        path_dup = NULL;
+
+        /* next path */
+        if (sep) {
+            path = sep + 1;
+            while (isspace(path[0])) {
+                ++path;
+            }
+        }
+    } while (sep);
+
+    *required = *sub_request_xpath ? 1 : 0;
+    if (*required && all) {
+        /* keep the request unchanged */
+        free(*sub_request_xpath);
+        *sub_request_xpath = strdup(request_xpath);
+        SR_CHECK_MEM_GOTO(!*sub_request_xpath, err_info, cleanup);
     }
 
-    return NULL;
+cleanup:
+    free(path_dup);
+    if (err_info) {
+        free(*sub_request_xpath);
+        *sub_request_xpath = NULL;
+    }
+    return err_info;
 }
 
 /**
- * @brief Update (replace or append) operational data for a specific module.
+ * @brief Free an operational data cache entry.
  *
- * @param[in] mod Mod info module to process.
- * @param[in] sid Sysrepo session ID.
+ * @param[in] entry Entry to free.
+ */
+static void
+sr_oper_cache_entry_free(struct sr_oper_cache_entry_s *entry)
+{
+    free(entry->user);
+    free(entry->sub_xpath);
+    free(entry->parent_path);
+    free(entry->request_xpath);
+    free(entry->data_lyb);
+}
+
+/**
+ * @brief Remove an operational data cache entry, the last entry is moved in its place.
+ *
+ * @param[in] oper_cache Operational data cache.
+ * @param[in] idx Index of the entry to remove.
+ */
+static void
+sr_oper_cache_entry_del(struct sr_oper_cache_s *oper_cache, uint32_t idx)
+{
+    sr_oper_cache_entry_free(&oper_cache->entries[idx]);
+    --oper_cache->entry_count;
+    if (idx < oper_cache->entry_count) {
+        oper_cache->entries[idx] = oper_cache->entries[oper_cache->entry_count];
+    }
+}
+
+/**
+ * @brief Check whether an operational data cache entry expires before another time.
+ *
+ * @param[in] entry Cache entry.
+ * @param[in] ts Time to compare with.
+ * @return Whether the entry expires at or before @p ts.
+ */
+static int
+sr_oper_cache_entry_expired(const struct sr_oper_cache_entry_s *entry, const struct timespec *ts)
+{
+    return (entry->expire_ts.tv_sec < ts->tv_sec) || ((entry->expire_ts.tv_sec == ts->tv_sec)
+            && (entry->expire_ts.tv_nsec <= ts->tv_nsec));
+}
+
+/**
+ * @brief Compare 2 optional strings.
+ *
+ * @param[in] str1 First string.
+ * @param[in] str2 Second string.
+ * @return 0 if equal, non-zero if not.
+ */
+static int
+sr_oper_cache_strcmp(const char *str1, const char *str2)
+{
+    if (!str1 || !str2) {
+        return str1 != str2;
+    }
+    return strcmp(str1, str2);
+}
+
+/**
+ * @brief Get cached operational data from a provider, removes any expired entries.
+ *
+ * @param[in] oper_cache Operational data cache.
+ * @param[in] ly_mod libyang module of the data.
+ * @param[in] shm_msub SHM subscription of the provider.
+ * @param[in] sid Sysrepo session ID of the request.
+ * @param[in] sub_xpath Subscription XPath.
+ * @param[in] parent_path Path of the data parent, NULL for top-level data.
  * @param[in] request_xpath XPath of the data request.
- * @param[in] ext_shm_addr Ext SHM address.
- * @param[in] timeout_ms Operational callback timeout in milliseconds.
- * @param[in] opts Get oper data options.
- * @param[in,out] data Operational data tree.
- * @param[out] cb_error_info Callback error info returned by the client, if any.
+ * @param[out] oper_data Cached data, if any.
+ * @param[out] hit Whether the data were found in the cache.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, sr_sid_t *sid, const char *request_xpath, char *ext_shm_addr,
-        uint32_t timeout_ms, sr_get_oper_options_t opts, struct lyd_node **data, sr_error_info_t **cb_error_info)
+sr_oper_cache_get(struct sr_oper_cache_s *oper_cache, const struct lys_module *ly_mod, sr_mod_oper_sub_t *shm_msub,
+        sr_sid_t sid, const char *sub_xpath, const char *parent_path, const char *request_xpath,
+        struct lyd_node **oper_data, int *hit)
 {
     sr_error_info_t *err_info = NULL;
-    sr_mod_oper_sub_t *shm_msub;
-    const char *sub_xpath;
-    char *parent_xpath = NULL;
-    uint16_t i, j;
-    struct ly_set *set;
-    struct lyd_node *diff = NULL;
+    struct sr_oper_cache_entry_s *entry;
+    struct timespec cur_ts;
+    uint32_t i, ver, sr_sid;
 
-    if (!(opts & SR_OPER_NO_STORED)) {
-        /* apply stored operational diff */
-        if ((err_info = sr_module_file_data_append(mod->ly_mod, SR_DS_OPERATIONAL, &diff))) {
-            return err_info;
-        }
-        err_info = sr_diff_mod_apply(diff, mod->ly_mod, opts & SR_OPER_WITH_ORIGIN, data);
-        lyd_free_withsiblings(diff);
-        if (err_info) {
-            return err_info;
-        }
+    *oper_data = NULL;
+    *hit = 0;
 
-        if (!*data) {
-            /* add possible default state data nodes */
-            lyd_validate_modules(data, &mod->ly_mod, 1, LYD_OPT_DATA | LYD_OPT_TRUSTED);
-        }
-    }
+    ver = ATOMIC_LOAD_RELAXED(shm_msub->cache_ver);
+    sr_sid = (shm_msub->opts & SR_SUBSCR_OPER_CACHE_SESSION) ? sid.sr : 0;
+    sr_time_get(&cur_ts, 0);
 
-    if (opts & SR_OPER_NO_SUBS) {
-        /* do not get data from subscribers */
-        return NULL;
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&oper_cache->lock, -1, __func__))) {
+        return err_info;
     }
 
-    assert(sid && timeout_ms && cb_error_info);
-
-    /* XPaths are ordered based on depth */
-    for (i = 0; i < mod->shm_mod->oper_sub_count; ++i) {
-        shm_msub = &((sr_mod_oper_sub_t *)(ext_shm_addr + mod->shm_mod->oper_subs))[i];
-        sub_xpath = ext_shm_addr + shm_msub->xpath;
-
-        if ((shm_msub->sub_type == SR_OPER_SUB_CONFIG) && (opts & SR_OPER_NO_CONFIG)) {
-            /* useless to retrieve configuration data */
-            continue;
-        } else if ((shm_msub->sub_type == SR_OPER_SUB_STATE) && (opts & SR_OPER_NO_STATE)) {
-            /* useless to retrieve state data */
-            continue;
-        } else if (!sr_xpath_oper_data_required(request_xpath, sub_xpath)) {
-            /* useless to retrieve this data because they would be filtered out anyway */
+    i = 0;
+    while (i < oper_cache->entry_count) {
+        entry = &oper_cache->entries[i];
+        if (sr_oper_cache_entry_expired(entry, &cur_ts)) {
+            /* expired, remove it */
+            sr_oper_cache_entry_del(oper_cache, i);
             continue;
         }
 
-        if ((shm_msub->sub_type == SR_OPER_SUB_CONFIG) || (shm_msub->sub_type == SR_OPER_SUB_MIXED)) {
-            /* remove any present data */
-            if ((err_info = sr_lyd_xpath_complement(data, sub_xpath))) {
-                return err_info;
+        if ((entry->evpipe_num == shm_msub->evpipe_num) && (entry->sr_sid == sr_sid)
+                && !sr_oper_cache_strcmp(entry->user, sid.user) && !strcmp(entry->sub_xpath, sub_xpath)
+                && !sr_oper_cache_strcmp(entry->parent_path, parent_path)
+                && !sr_oper_cache_strcmp(entry->request_xpath, request_xpath)) {
+            if (entry->ver != ver) {
+                /* invalidated by the provider, remove it */
+                sr_oper_cache_entry_del(oper_cache, i);
+                break;
             }
-        }
 
-        /* trim the last node to get the parent */
-        if ((err_info = sr_xpath_trim_last_node(sub_xpath, &parent_xpath))) {
-            return err_info;
+            /* cache hit */
+            if (entry->data_lyb) {
+                ly_errno = 0;
+                *oper_data = lyd_parse_mem(ly_mod->ctx, entry->data_lyb, LYD_LYB, LYD_OPT_DATA | LYD_OPT_STRICT);
+                if (ly_errno) {
+                    sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+                    goto cleanup_unlock;
+                }
+            }
+            *hit = 1;
+            break;
         }
 
-        if (parent_xpath) {
-            set = NULL;
+        ++i;
+    }
 
-            if (!*data) {
-                /* parent does not exist for sure */
-                goto next_iter;
-            }
+    if (*hit) {
+        ++oper_cache->hit_count;
+    } else {
+        ++oper_cache->miss_count;
+    }
 
-            set = lyd_find_path(*data, parent_xpath);
-            if (!set) {
-                sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx);
-                goto error;
-            }
+cleanup_unlock:
+    /* CACHE UNLOCK */
+    sr_munlock(&oper_cache->lock);
+    return err_info;
+}
 
-            if (!set->number) {
-                /* data parent does not exist */
-                goto next_iter;
-            }
+/**
+ * @brief Make room for a new entry in a full operational data cache. All the expired entries are removed
+ * or, if there are none, the entry expiring first.
+ *
+ * @param[in] oper_cache Operational data cache.
+ */
+static void
+sr_oper_cache_evict(struct sr_oper_cache_s *oper_cache)
+{
+    struct timespec cur_ts;
+    uint32_t i, first;
 
-            /* nested data */
-            for (j = 0; j < set->number; ++j) {
-                if ((err_info = sr_xpath_oper_data_append(shm_msub, mod->ly_mod, sub_xpath, request_xpath, set->set.d[j],
-                        *sid, timeout_ms, data, cb_error_info))) {
-                    goto error;
-                }
-            }
+    sr_time_get(&cur_ts, 0);
 
-next_iter:
-            /* cleanup for next iteration */
-            free(parent_xpath);
-            ly_set_free(set);
-        } else {
-            /* top-level data */
-            if ((err_info = sr_xpath_oper_data_append(shm_msub, mod->ly_mod, sub_xpath, request_xpath, NULL, *sid,
-                    timeout_ms, data, cb_error_info))) {
-                goto error;
-            }
+    i = 0;
+    while (i < oper_cache->entry_count) {
+        if (sr_oper_cache_entry_expired(&oper_cache->entries[i], &cur_ts)) {
+            sr_oper_cache_entry_del(oper_cache, i);
+            continue;
         }
+        ++i;
+    }
+    if (oper_cache->entry_count < SR_OPER_CACHE_MAX_ENTRIES) {
+        return;
     }
 
-    return NULL;
-
-error:
-    free(parent_xpath);
-    ly_set_free(set);
-    return err_info;
+    first = 0;
+    for (i = 1; i < oper_cache->entry_count; ++i) {
+        if (sr_oper_cache_entry_expired(&oper_cache->entries[i], &oper_cache->entries[first].expire_ts)) {
+            first = i;
+        }
+    }
+    sr_oper_cache_entry_del(oper_cache, first);
 }
 
+/**
+ * @brief Store operational data from a provider in the cache.
+ *
+ * @param[in] oper_cache Operational data cache.
+ * @param[in] ly_mod libyang module of the data.
+ * @param[in] shm_msub SHM subscription of the provider.
+ * @param[in] sid Sysrepo session ID of the request.
+ * @param[in] ttl_ms Validity period of the data.
+ * @param[in] ver Provider data version when the data were retrieved.
+ * @param[in] sub_xpath Subscription XPath.
+ * @param[in] parent_path Path of the data parent, NULL for top-level data.
+ * @param[in] request_xpath XPath of the data request.
+ * @param[in] oper_data Data to cache.
+ * @return err_info, NULL on success.
+ */
 static sr_error_info_t *
-sr_module_oper_data_add_state_default(struct lyd_node **data, const struct lys_module *ly_mod)
+sr_oper_cache_store(struct sr_oper_cache_s *oper_cache, const struct lys_module *ly_mod, sr_mod_oper_sub_t *shm_msub,
+        sr_sid_t sid, uint32_t ttl_ms, uint32_t ver, const char *sub_xpath, const char *parent_path,
+        const char *request_xpath, const struct lyd_node *oper_data)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *node, *val_node, *sibling;
-    struct lyd_difflist *val_diff;
-    struct ly_set *set;
-    uint32_t i;
-
-    if (lyd_validate_modules(data, &ly_mod, 1, LYD_OPT_DATA | LYD_OPT_TRUSTED | LYD_OPT_VAL_DIFF, &val_diff)) {
+    struct sr_oper_cache_entry_s entry, *mem;
+
+    memset(&entry, 0, sizeof entry);
+
+    /* prepare the new entry */
+    entry.evpipe_num = shm_msub->evpipe_num;
+    if (sid.user) {
+        entry.user = strdup(sid.user);
+        SR_CHECK_MEM_GOTO(!entry.user, err_info, error);
+    }
+    entry.sr_sid = (shm_msub->opts & SR_SUBSCR_OPER_CACHE_SESSION) ? sid.sr : 0;
+    entry.ver = ver;
+    sr_time_get(&entry.expire_ts, ttl_ms);
+    entry.sub_xpath = strdup(sub_xpath);
+    SR_CHECK_MEM_GOTO(!entry.sub_xpath, err_info, error);
+    if (parent_path) {
+        entry.parent_path = strdup(parent_path);
+        SR_CHECK_MEM_GOTO(!entry.parent_path, err_info, error);
+    }
+    if (request_xpath) {
+        entry.request_xpath = strdup(request_xpath);
+        SR_CHECK_MEM_GOTO(!entry.request_xpath, err_info, error);
+    }
+    if (oper_data && lyd_print_mem(&entry.data_lyb, oper_data, LYD_LYB, LYP_WITHSIBLINGS)) {
         sr_errinfo_new_ly(&err_info, ly_mod->ctx);
-        SR_ERRINFO_VALID(&err_info);
-        return err_info;
+        goto error;
     }
 
-    /* remove added config nodes */
-    assert(val_diff);
-    for (i = 0; val_diff->type[i] != LYD_DIFF_END; ++i) {
-        if (val_diff->type[i] == LYD_DIFF_CREATED) {
-            /* get the sibling in the data */
-            if (val_diff->first[i]) {
-                set = lyd_find_path(*data, (char *)val_diff->first[i]);
-                if (!set) {
-                    sr_errinfo_new_ly(&err_info, ly_mod->ctx);
-                    return err_info;
-                }
-                assert(set->number == 1);
-                sibling = set->set.d[0]->child;
-                ly_set_free(set);
-            } else {
-                sibling = *data;
-            }
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&oper_cache->lock, -1, __func__))) {
+        goto error;
+    }
 
-            LY_TREE_FOR(val_diff->second[i], val_node) {
-                if (val_node->schema->flags & LYS_CONFIG_R) {
-                    continue;
-                }
+    if (oper_cache->entry_count == SR_OPER_CACHE_MAX_ENTRIES) {
+        /* the cache is full */
+        sr_oper_cache_evict(oper_cache);
+    } else {
+        mem = realloc(oper_cache->entries, (oper_cache->entry_count + 1) * sizeof *oper_cache->entries);
+        if (!mem) {
+            /* CACHE UNLOCK */
+            sr_munlock(&oper_cache->lock);
 
-                /* find the created node in the data and free it */
-                LY_TREE_FOR(sibling, node) {
-                    if (node->schema == val_node->schema) {
-                        lyd_free(node);
-                        break;
-                    }
-                }
-            }
+            SR_ERRINFO_MEM(&err_info);
+            goto error;
         }
+        oper_cache->entries = mem;
     }
+    oper_cache->entries[oper_cache->entry_count] = entry;
+    ++oper_cache->entry_count;
 
-    lyd_free_val_diff(val_diff);
+    /* CACHE UNLOCK */
+    sr_munlock(&oper_cache->lock);
     return NULL;
+
+error:
+    sr_oper_cache_entry_free(&entry);
+    return err_info;
+}
+
+void
+sr_conn_oper_cache_free(sr_conn_ctx_t *conn)
+{
+    uint32_t i;
+
+    for (i = 0; i < conn->oper_cache.entry_count; ++i) {
+        sr_oper_cache_entry_free(&conn->oper_cache.entries[i]);
+    }
+    free(conn->oper_cache.entries);
+    pthread_mutex_destroy(&conn->oper_cache.lock);
 }
 
 /**
- * @brief Duplicate operational (enabled) data from configuration data tree.
+ * @brief Find a module in the stored operational diff cache.
  *
- * @param[in] data Configuration data.
- * @param[in] ext_shm_addr Main SHM address.
- * @param[in] mod Mod info module to process.
- * @param[in] opts Get oper data options.
- * @param[out] enabled_mod_data Enabled operational data of the module.
- * @return err_info, NULL on success.
+ * @param[in] cache Stored operational diff cache.
+ * @param[in] ly_mod Module to find.
+ * @return Index of the module, mod_count if not found.
  */
-static sr_error_info_t *
-sr_module_oper_data_dup_enabled(const struct lyd_node *data, char *ext_shm_addr, struct sr_mod_info_mod_s *mod,
-        sr_get_oper_options_t opts, struct lyd_node **enabled_mod_data)
+static uint32_t
+sr_oper_diff_cache_find(struct sr_oper_diff_cache_s *cache, const struct lys_module *ly_mod)
 {
-    sr_error_info_t *err_info = NULL;
-    sr_mod_change_sub_t *shm_changesubs;
-    struct lyd_node *root, *elem, *next;
-    uint16_t i, xp_i;
-    char **xpaths;
-    const char *origin;
-
-    *enabled_mod_data = NULL;
-
-    if (!data) {
-        /* no data is enabled */
-        return NULL;
-    }
+    uint32_t i;
 
-    /* first try to find a subscription for the whole module */
-    shm_changesubs = (sr_mod_change_sub_t *)(ext_shm_addr + mod->shm_mod->change_sub[SR_DS_RUNNING].subs);
-    for (i = 0; i < mod->shm_mod->change_sub[SR_DS_RUNNING].sub_count; ++i) {
-        if (!shm_changesubs[i].xpath && !(shm_changesubs[i].opts & SR_SUBSCR_PASSIVE)) {
-            /* the whole module is enabled */
-            if ((err_info = sr_module_data_dup(data, mod->ly_mod, enabled_mod_data))) {
-                return err_info;
-            }
-            return NULL;
+    for (i = 0; i < cache->mod_count; ++i) {
+        if (cache->mods[i].ly_mod == ly_mod) {
+            break;
         }
     }
 
-    /* collect all enabled subtress in the form of xpaths */
-    xpaths = NULL;
-    for (i = 0, xp_i = 0; i < mod->shm_mod->change_sub[SR_DS_RUNNING].sub_count; ++i) {
-        if (shm_changesubs[i].xpath && !(shm_changesubs[i].opts & SR_SUBSCR_PASSIVE)) {
-            xpaths = sr_realloc(xpaths, (xp_i + 1) * sizeof *xpaths);
-            SR_CHECK_MEM_RET(!xpaths, err_info);
+    return i;
+}
 
-            xpaths[xp_i] = ext_shm_addr + shm_changesubs[i].xpath;
-            ++xp_i;
-        }
-    }
+/**
+ * @brief Take the stored operational diff of a module out of the cache so that it can be modified.
+ * If there is no valid cached diff, it is loaded.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the diff.
+ * @param[in] shm_mod SHM module of the diff.
+ * @param[out] diff Stored operational diff of the module.
+ * @param[out] ver Stored operational data version of @p diff.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_oper_diff_cache_take(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, sr_mod_t *shm_mod, struct lyd_node **diff,
+        uint32_t *ver)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_oper_diff_cache_s *cache = &conn->oper_diff_cache;
+    uint32_t i;
 
-    /* duplicate only enabled subtrees */
-    err_info = sr_lyd_xpath_dup(data, xpaths, xp_i, mod->ly_mod, enabled_mod_data);
-    free(xpaths);
-    if (err_info) {
-        return err_info;
-    }
+    *diff = NULL;
 
-    /* add existing (valid) state NP containers and default values */
-    if ((err_info = sr_module_oper_data_add_state_default(enabled_mod_data, mod->ly_mod))) {
+    /* CACHE WRITE LOCK */
+    if ((err_info = sr_rwlock(&cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
         return err_info;
     }
 
-    if (opts & SR_OPER_WITH_ORIGIN) {
-        LY_TREE_FOR(*enabled_mod_data, root) {
-            /* add origin of all top-level nodes */
-            origin = (root->schema->flags & LYS_CONFIG_W) ? SR_CONFIG_ORIGIN : SR_OPER_ORIGIN;
-            if ((err_info = sr_edit_diff_set_origin(root, origin, 1))) {
-                return err_info;
-            }
+    /* learn the version before loading the diff, a concurrent change would only cause a reload */
+    *ver = ATOMIC_LOAD_RELAXED(shm_mod->oper_ver);
 
-            LY_TREE_DFS_BEGIN(root, next, elem) {
-                /* add origin of default nodes */
-                if ((elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) && elem->dflt) {
-                    if ((err_info = sr_edit_diff_set_origin(elem, "default", 1))) {
-                        return err_info;
-                    }
-                }
-                LY_TREE_DFS_END(root, next, elem);
-            }
-        }
+    i = sr_oper_diff_cache_find(cache, ly_mod);
+    if ((i < cache->mod_count) && cache->mods[i].ver && (cache->mods[i].ver == *ver)) {
+        /* valid cached diff */
+        *diff = cache->mods[i].diff;
+        cache->mods[i].diff = NULL;
+        cache->mods[i].ver = 0;
+    } else {
+        /* load the stored diff */
+        err_info = sr_module_file_data_append(ly_mod, SR_DS_OPERATIONAL, diff);
     }
 
-    return NULL;
+    /* CACHE WRITE UNLOCK */
+    sr_rwunlock(&cache->lock, SR_LOCK_WRITE, __func__);
+
+    return err_info;
 }
 
 /**
- * @brief Update cached running module data (if required).
+ * @brief Store the stored operational diff of a module in the cache.
  *
- * @param[in] mod_cache Module cache.
- * @param[in] mod Mod info module to process.
- * @param[in] upd_mod_data Optional current (updated) module data to store in cache.
- * @param[in] read_locked Whether the cache is READ locked.
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the diff.
+ * @param[in] ver Stored operational data version of @p diff.
+ * @param[in,out] diff Stored operational diff of the module, is spent and set to NULL.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_modcache_module_running_update(struct sr_mod_cache_s *mod_cache, struct sr_mod_info_mod_s *mod,
-        struct lyd_node **upd_mod_data, int read_locked)
+sr_oper_diff_cache_put(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, uint32_t ver, struct lyd_node **diff)
 {
     sr_error_info_t *err_info = NULL;
+    struct sr_oper_diff_cache_s *cache = &conn->oper_diff_cache;
     uint32_t i;
     void *mem;
 
-    /* find the module in the cache */
-    for (i = 0; i < mod_cache->mod_count; ++i) {
-        if (mod->ly_mod == mod_cache->mods[i].ly_mod) {
-            break;
-        }
+    /* CACHE WRITE LOCK */
+    if ((err_info = sr_rwlock(&cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
+        goto cleanup;
     }
 
-    if (i < mod_cache->mod_count) {
-        /* this module data are already in the cache */
-        assert(mod->shm_mod->ver >= mod_cache->mods[i].ver);
-        if (mod->shm_mod->ver > mod_cache->mods[i].ver) {
-            if (read_locked) {
-                /* CACHE READ UNLOCK */
-                sr_rwunlock(&mod_cache->lock, SR_LOCK_READ, __func__);
-            }
+    i = sr_oper_diff_cache_find(cache, ly_mod);
+    if (i == cache->mod_count) {
+        /* module is not in cache yet, add an item */
+        mem = realloc(cache->mods, (i + 1) * sizeof *cache->mods);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+        cache->mods = mem;
+        ++cache->mod_count;
 
-            /* CACHE WRITE LOCK */
-            if ((err_info = sr_rwlock(&mod_cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
-                goto error_rlock;
-            }
+        cache->mods[i].ly_mod = ly_mod;
+        cache->mods[i].diff = NULL;
+    }
 
-            /* data needs to be updated, remove old data */
-            lyd_free_withsiblings(sr_module_data_unlink(&mod_cache->data, mod->ly_mod));
-            mod_cache->mods[i].ver = 0;
-        }
-    } else {
-        if (read_locked) {
-            /* CACHE READ UNLOCK */
-            sr_rwunlock(&mod_cache->lock, SR_LOCK_READ, __func__);
-        }
+    /* replace the cached diff */
+    lyd_free_withsiblings(cache->mods[i].diff);
+    cache->mods[i].diff = *diff;
+    cache->mods[i].ver = ver;
+    *diff = NULL;
 
-        /* CACHE WRITE LOCK */
-        if ((err_info = sr_rwlock(&mod_cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
-            goto error_rlock;
-        }
+cleanup_unlock:
+    /* CACHE WRITE UNLOCK */
+    sr_rwunlock(&cache->lock, SR_LOCK_WRITE, __func__);
+cleanup:
+    lyd_free_withsiblings(*diff);
+    *diff = NULL;
+    return err_info;
+}
 
-        /* module is not in cache yet, add an item */
-        mem = realloc(mod_cache->mods, (i + 1) * sizeof *mod_cache->mods);
-        SR_CHECK_MEM_RET(!mem, err_info);
-        mod_cache->mods = mem;
-        ++mod_cache->mod_count;
+/**
+ * @brief Get the stored operational diff of a module from the cache, load it if not cached.
+ * Cache is READ locked on success and must be unlocked once @p diff is no longer needed.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the diff.
+ * @param[in] shm_mod SHM module of the diff.
+ * @param[out] diff Stored operational diff of the module.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_oper_diff_cache_rdlock(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, sr_mod_t *shm_mod,
+        const struct lyd_node **diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_oper_diff_cache_s *cache = &conn->oper_diff_cache;
+    struct lyd_node *new_diff;
+    uint32_t i, ver;
+    int loaded = 0;
 
-        mod_cache->mods[i].ly_mod = mod->ly_mod;
-        mod_cache->mods[i].ver = 0;
-    }
+    while (1) {
+        /* CACHE READ LOCK */
+        if ((err_info = sr_rwlock(&cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_READ, __func__))) {
+            return err_info;
+        }
 
-    /* append current data */
-    if (!mod_cache->mods[i].ver) {
-        if (upd_mod_data) {
-            /* current data were provided */
-            if (mod_cache->data) {
-                sr_ly_link(mod_cache->data, *upd_mod_data);
-            } else {
-                mod_cache->data = *upd_mod_data;
-            }
-            *upd_mod_data = NULL;
-        } else {
-            /* we need to load current data from persistent storage */
-            if ((err_info = sr_module_file_data_append(mod->ly_mod, SR_DS_RUNNING, &mod_cache->data))) {
-                goto error_wrunlock;
-            }
+        i = sr_oper_diff_cache_find(cache, ly_mod);
+        if ((i < cache->mod_count) && cache->mods[i].ver
+                && (loaded || (cache->mods[i].ver == (uint32_t)ATOMIC_LOAD_RELAXED(shm_mod->oper_ver)))) {
+            /* valid cached diff (or the one just loaded) */
+            *diff = cache->mods[i].diff;
+            return NULL;
         }
-        mod_cache->mods[i].ver = mod->shm_mod->ver;
 
-error_wrunlock:
-        /* CACHE WRITE UNLOCK */
-        sr_rwunlock(&mod_cache->lock, SR_LOCK_WRITE, __func__);
+        /* CACHE READ UNLOCK */
+        sr_rwunlock(&cache->lock, SR_LOCK_READ, __func__);
 
-error_rlock:
-        if (read_locked) {
-            /* CACHE READ LOCK */
-            if ((err_info = sr_rwlock(&mod_cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_READ, __func__))) {
-                return err_info;
-            }
+        /* load the diff and cache it, it may also be being modified by someone else so check it again */
+        if ((err_info = sr_oper_diff_cache_take(conn, ly_mod, shm_mod, &new_diff, &ver))) {
+            return err_info;
+        }
+        if ((err_info = sr_oper_diff_cache_put(conn, ly_mod, ver, &new_diff))) {
+            return err_info;
         }
+        loaded = 1;
     }
-
-    return err_info;
 }
 
 /**
- * @brief Trim all configuration/state nodes/origin from the data based on options.
+ * @brief Store a new stored operational diff of a module and keep it cached. The whole diff is written
+ * so that other connections can load it, only its parsing is saved by the cache.
  *
- * @param[in,out] data Data to trim.
- * @param[in] sibling First sibling of the current data to trim.
- * @param[in] opts Get oper data options.
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module of the diff.
+ * @param[in,out] diff Stored operational diff of the module, is spent and set to NULL.
+ * @return err_info, NULL on success.
  */
-static void
-sr_oper_data_trim_r(struct lyd_node **data, struct lyd_node *sibling, sr_get_oper_options_t opts)
+static sr_error_info_t *
+sr_oper_diff_store(sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod, struct lyd_node **diff)
 {
-    struct lyd_node *next, *elem;
-    struct lyd_attr *attr;
+    sr_error_info_t *err_info = NULL;
+    uint32_t ver;
 
-    if (!(opts & (SR_OPER_NO_STATE | SR_OPER_NO_CONFIG)) && (opts & SR_OPER_WITH_ORIGIN)) {
-        /* nothing to trim */
-        return;
+    if ((err_info = sr_module_file_data_set(mod->ly_mod->name, SR_DS_OPERATIONAL, *diff, 0, 0))) {
+        lyd_free_withsiblings(*diff);
+        *diff = NULL;
+        return err_info;
     }
 
-    LY_TREE_FOR_SAFE(sibling, next, elem) {
-        assert((elem->schema->nodetype != LYS_LEAF) || !lys_is_key((struct lys_node_leaf *)elem->schema, NULL));
-        if (elem->schema->flags & LYS_CONFIG_R) {
-            /* state subtree */
-            if (opts & SR_OPER_NO_STATE) {
-                /* free it whole */
-                if (*data == elem) {
-                    *data = (*data)->next;
-                }
-                lyd_free(elem);
-                continue;
-            }
+    /* update summary of the stored subtrees and module stored operational data version */
+    ATOMIC_STORE_RELAXED(mod->shm_mod->oper_subtrees, sr_diff_mod_subtrees(*diff, mod->ly_mod));
+    ver = ATOMIC_INC_RELAXED(mod->shm_mod->oper_ver) + 1;
 
-            if (opts & SR_OPER_WITH_ORIGIN) {
-                /* no need to go into state children */
-                continue;
-            }
-        }
+    return sr_oper_diff_cache_put(conn, mod->ly_mod, ver, diff);
+}
 
-        /* trim all our children */
-        sr_oper_data_trim_r(data, sr_lyd_child(elem, 1), opts);
+void
+sr_conn_oper_diff_cache_free(sr_conn_ctx_t *conn)
+{
+    uint32_t i;
 
-        if ((elem->schema->flags & LYS_CONFIG_W) && (opts & SR_OPER_NO_CONFIG) && !sr_lyd_child(elem, 1)) {
-            /* config-only subtree (config node with no children) */
-            if (*data == elem) {
-                *data = (*data)->next;
-            }
-            lyd_free(elem);
-            continue;
-        }
+    for (i = 0; i < conn->oper_diff_cache.mod_count; ++i) {
+        lyd_free_withsiblings(conn->oper_diff_cache.mods[i].diff);
+    }
+    free(conn->oper_diff_cache.mods);
+    sr_rwlock_destroy(&conn->oper_diff_cache.lock);
+}
 
-        if (!(opts & SR_OPER_WITH_ORIGIN)) {
-            /* trim origin */
-            LY_TREE_FOR(elem->attr, attr) {
-                if (!strcmp(attr->name, "origin") && !strcmp(attr->annotation->module->name, "ietf-origin")) {
-                    lyd_free_attr(elem->schema->module->ctx, elem, attr, 0);
-                    break;
-                }
-            }
+/**
+ * @brief Find a module in the instance-identifier target cache.
+ *
+ * @param[in] cache Instance-identifier target cache.
+ * @param[in] ly_mod Module to find.
+ * @return Index of the module, mod_count if not found.
+ */
+static uint32_t
+sr_instid_cache_find(struct sr_instid_cache_s *cache, const struct lys_module *ly_mod)
+{
+    uint32_t i;
+
+    for (i = 0; i < cache->mod_count; ++i) {
+        if (cache->mods[i].ly_mod == ly_mod) {
+            break;
         }
     }
+
+    return i;
 }
 
 /**
- * @brief Load module data of a specific module.
+ * @brief Add cached instance-identifier target modules of the current module running data.
  *
- * @param[in] mod_info Mod info to use.
- * @param[in] mod Mod info module to process.
- * @param[in] load_diff Whether to load stored operational diff of the module.
- * @param[in] sid Sysrepo session ID.
- * @param[in] request_xpath XPath of the data request.
- * @param[in] timeout_ms Operational callback timeout in milliseconds.
- * @param[in] opts Get oper data options.
- * @param[out] cb_error_info Callback error info returned by operational subscribers, if any.
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module.
+ * @param[in,out] trg_mods Set of target modules to add to.
+ * @param[out] hit Whether there were valid cached targets.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_modinfo_module_data_load(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, sr_sid_t *sid,
-        const char *request_xpath, uint32_t timeout_ms, sr_get_oper_options_t opts, sr_error_info_t **cb_error_info)
+sr_instid_cache_get(sr_conn_ctx_t *conn, const struct sr_mod_info_mod_s *mod, struct ly_set *trg_mods, int *hit)
 {
     sr_error_info_t *err_info = NULL;
-    sr_conn_ctx_t *conn = mod_info->conn;
-    struct sr_mod_cache_s *mod_cache = NULL;
-    struct lyd_node *mod_data;
-    sr_datastore_t conf_ds;
+    struct sr_instid_cache_s *cache = &conn->instid_cache;
+    uint32_t i, j;
 
-    if (((mod_info->ds == SR_DS_RUNNING) || (mod_info->ds == SR_DS_OPERATIONAL)) && (conn->opts & SR_CONN_CACHE_RUNNING)) {
-        /* we are caching, so in all cases load the module into cache if not yet there */
-        mod_cache = &conn->mod_cache;
-        if ((err_info = sr_modcache_module_running_update(mod_cache, mod, NULL, mod_info->data_cached))) {
-            return err_info;
-        }
+    *hit = 0;
+
+    /* INSTID CACHE LOCK */
+    if ((err_info = sr_mlock(&cache->lock, -1, __func__))) {
+        return err_info;
     }
 
-    if (!mod_info->data_cached) {
-        if (mod_cache) {
-            assert((mod_info->ds == SR_DS_RUNNING) || (mod_info->ds == SR_DS_OPERATIONAL));
+    i = sr_instid_cache_find(cache, mod->ly_mod);
+    if ((i < cache->mod_count) && cache->mods[i].ver && (cache->mods[i].ver == mod->shm_mod->ver)) {
+        for (j = 0; j < cache->mods[i].trg_mods->number; ++j) {
+            if (ly_set_add(trg_mods, cache->mods[i].trg_mods->set.g[j], 0) == -1) {
+                sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+                goto cleanup_unlock;
+            }
+        }
+        *hit = 1;
+    }
 
-            /* we are caching, copy module data from the cache and link it */
-            if (mod_info->ds == SR_DS_OPERATIONAL) {
-                /* copy only enabled module data */
-                if ((err_info = sr_module_oper_data_dup_enabled(mod_cache->data, conn->ext_shm.addr, mod, opts,
-                            &mod_data))) {
-                    return err_info;
-                }
-            } else {
-                /* copy all module data */
-                if ((err_info = sr_module_data_dup(mod_cache->data, mod->ly_mod, &mod_data))) {
-                    return err_info;
-                }
+cleanup_unlock:
+    /* INSTID CACHE UNLOCK */
+    sr_munlock(&cache->lock);
+
+    return err_info;
+}
+
+/**
+ * @brief Cache instance-identifier target modules of module running data.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module with the instance-identifiers.
+ * @param[in] ver Running data version of the module.
+ * @param[in,out] trg_mods Target modules, are spent.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_instid_cache_put(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, uint32_t ver, struct ly_set **trg_mods)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_instid_cache_s *cache = &conn->instid_cache;
+    uint32_t i;
+    void *mem;
+
+    /* INSTID CACHE LOCK */
+    if ((err_info = sr_mlock(&cache->lock, -1, __func__))) {
+        goto cleanup;
+    }
+
+    i = sr_instid_cache_find(cache, ly_mod);
+    if (i == cache->mod_count) {
+        /* new module */
+        mem = realloc(cache->mods, (i + 1) * sizeof *cache->mods);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+        cache->mods = mem;
+        ++cache->mod_count;
+
+        cache->mods[i].ly_mod = ly_mod;
+        cache->mods[i].trg_mods = NULL;
+    }
+
+    /* replace the targets */
+    ly_set_free(cache->mods[i].trg_mods);
+    cache->mods[i].trg_mods = *trg_mods;
+    cache->mods[i].ver = ver;
+    *trg_mods = NULL;
+
+cleanup_unlock:
+    /* INSTID CACHE UNLOCK */
+    sr_munlock(&cache->lock);
+
+cleanup:
+    ly_set_free(*trg_mods);
+    *trg_mods = NULL;
+    return err_info;
+}
+
+void
+sr_conn_instid_cache_free(sr_conn_ctx_t *conn)
+{
+    uint32_t i;
+
+    for (i = 0; i < conn->instid_cache.mod_count; ++i) {
+        ly_set_free(conn->instid_cache.mods[i].trg_mods);
+    }
+    free(conn->instid_cache.mods);
+    pthread_mutex_destroy(&conn->instid_cache.lock);
+}
+
+/**
+ * @brief Operational data retrieval from a single subscription.
+ */
+struct sr_oper_get_s {
+    sr_mod_oper_sub_t *shm_msub;    /**< SHM subscription. */
+    const char *sub_xpath;          /**< Subscription XPath. */
+    char *request_xpath;            /**< Paths of the data request requiring the subscription data, NULL if unknown. */
+    const char *page_after;         /**< Path of the instance the requested page follows, if any. */
+    uint32_t page_count;            /**< Number of the requested page instances, 0 if the whole data are requested. */
+    struct ly_set *parents;         /**< Data parents of the subscription, NULL for top-level data. */
+    uint32_t parent_idx;            /**< Index of the next parent to retrieve the data for. */
+
+    struct lyd_node *parent_dup;    /**< Stand-alone parent tree sent to the subscriber. */
+    char *parent_path;              /**< Path of the parent, if needed. */
+    uint32_t ttl_ms;                /**< Validity period of the retrieved data, 0 if not cached. */
+    uint32_t ver;                   /**< Version of the subscription data when the request was sent. */
+    int sent;                       /**< Whether there is a sent request not yet finished. */
+    sr_shmsub_oper_req_t req;       /**< Sent request. */
+    struct lyd_node *oper_data;     /**< Retrieved data not yet merged. */
+};
+
+/**
+ * @brief Check whether all the operational data of a subscription were retrieved.
+ *
+ * @param[in] get Operational data retrieval.
+ * @return 0 if not, non-zero if all were.
+ */
+static int
+sr_xpath_oper_data_get_done(const struct sr_oper_get_s *get)
+{
+    return get->parent_idx >= (get->parents ? get->parents->number : 1);
+}
+
+/**
+ * @brief Prepare the data parent tree for all the parents of a batched subscription.
+ *
+ * @param[in] ly_mod Module of the data to get.
+ * @param[in] request_xpath XPath of the data request.
+ * @param[in] parents Operational parents of the data to retrieve.
+ * @param[out] parent_tree Stand-alone tree with all the parents, NULL if all were filtered out.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_oper_data_batch_parents(const struct lys_module *ly_mod, const char *request_xpath, struct ly_set *parents,
+        struct lyd_node **parent_tree)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *parent_dup;
+    char *parent_path;
+    uint32_t i;
+    int required;
+
+    *parent_tree = NULL;
+
+    /* duplicate all the parents into one stand-alone tree */
+    for (i = 0; i < parents->number; ++i) {
+        if (request_xpath) {
+            /* check whether the parent would not be filtered out */
+            parent_path = lyd_path(parents->set.d[i]);
+            SR_CHECK_MEM_GOTO(!parent_path, err_info, error);
+            required = sr_xpath_oper_data_required(request_xpath, parent_path);
+            free(parent_path);
+            if (!required) {
+                continue;
             }
-            if (mod_info->data) {
-                sr_ly_link(mod_info->data, mod_data);
-            } else {
-                mod_info->data = mod_data;
+        }
+
+        parent_dup = lyd_dup(parents->set.d[i], LYD_DUP_OPT_WITH_PARENTS | LYD_DUP_OPT_WITH_KEYS);
+        if (!parent_dup) {
+            sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+            goto error;
+        }
+
+        /* go top-level */
+        for (; parent_dup->parent; parent_dup = parent_dup->parent);
+
+        if (!*parent_tree) {
+            *parent_tree = parent_dup;
+        } else if (lyd_merge(*parent_tree, parent_dup, LYD_OPT_DESTRUCT)) {
+            lyd_free_withsiblings(parent_dup);
+            sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+            goto error;
+        }
+    }
+
+    return NULL;
+
+error:
+    lyd_free_withsiblings(*parent_tree);
+    *parent_tree = NULL;
+    return err_info;
+}
+
+/**
+ * @brief Start getting operational data for the next parent (or all the parents for batched subscriptions)
+ * of a subscription. The data are either found in the cache or a request is sent to the subscriber.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the data to get.
+ * @param[in] request_xpath XPath of the data request.
+ * @param[in] sid Sysrepo session ID.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in,out] get Operational data retrieval.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_oper_data_get_start(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const char *request_xpath,
+        sr_sid_t sid, uint32_t timeout_ms, struct sr_oper_get_s *get)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *last_parent;
+    int hit;
+
+    assert(!get->sent && !get->parent_dup && !get->parent_path && !get->oper_data);
+
+    if (get->parents && (get->shm_msub->opts & SR_SUBSCR_OPER_BATCH)) {
+        /* all the parents at once, the data are never cached */
+        get->parent_idx = get->parents->number;
+        get->ttl_ms = 0;
+        if ((err_info = sr_xpath_oper_data_batch_parents(ly_mod, request_xpath, get->parents, &get->parent_dup))) {
+            return err_info;
+        }
+        if (!get->parent_dup) {
+            /* all the parents were filtered out */
+            return NULL;
+        }
+    } else {
+        /* provider data may be cached, unless only a page of them is requested */
+        get->ttl_ms = get->page_count ? 0 : ATOMIC_LOAD_RELAXED(get->shm_msub->cache_ttl_ms);
+
+        if (get->parents) {
+            /* duplicate parent so that it is a stand-alone subtree */
+            last_parent = lyd_dup(get->parents->set.d[get->parent_idx], LYD_DUP_OPT_WITH_PARENTS | LYD_DUP_OPT_WITH_KEYS);
+            ++get->parent_idx;
+            if (!last_parent) {
+                sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+                return err_info;
             }
-        } else {
-            /* get current persistent data */
-            if (mod_info->ds == SR_DS_OPERATIONAL) {
-                conf_ds = SR_DS_RUNNING;
-            } else {
-                conf_ds = mod_info->ds;
+
+            /* go top-level */
+            for (get->parent_dup = last_parent; get->parent_dup->parent; get->parent_dup = get->parent_dup->parent);
+
+            if (request_xpath || get->ttl_ms) {
+                get->parent_path = lyd_path(last_parent);
+                SR_CHECK_MEM_RET(!get->parent_path, err_info);
             }
-            if ((err_info = sr_module_file_data_append(mod->ly_mod, conf_ds, &mod_info->data))) {
+
+            if (request_xpath) {
+                /* check whether the parent would not be filtered out */
+                if (!sr_xpath_oper_data_required(request_xpath, get->parent_path)) {
+                    return NULL;
+                }
+            }
+        } else {
+            /* top-level data */
+            get->parent_idx = 1;
+        }
+
+        if (get->ttl_ms) {
+            /* try to use cached data */
+            if ((err_info = sr_oper_cache_get(&conn->oper_cache, ly_mod, get->shm_msub, sid, get->sub_xpath,
+                    get->parent_path, request_xpath, &get->oper_data, &hit))) {
                 return err_info;
             }
+            if (hit) {
+                /* no need to cache the data again */
+                get->ttl_ms = 0;
+                return NULL;
+            }
 
-            if (mod_info->ds == SR_DS_OPERATIONAL) {
-                /* keep only enabled module data */
-                if ((err_info = sr_module_oper_data_dup_enabled(mod_info->data, conn->ext_shm.addr, mod, opts,
-                            &mod_data))) {
+            /* remember the version before getting the data, in case it is invalidated meanwhile */
+            get->ver = ATOMIC_LOAD_RELAXED(get->shm_msub->cache_ver);
+        }
+    }
+
+    /* send the request to the client */
+    if ((err_info = sr_shmsub_oper_notify_send(ly_mod, get->sub_xpath, request_xpath, get->page_after, get->page_count,
+            get->parent_dup, sid, get->shm_msub->evpipe_num, (get->shm_msub->opts & SR_SUBSCR_OPER_CONCURRENT) ? SR_OPER_SUB_SLOT_COUNT : 1,
+            timeout_ms, &get->req))) {
+        return err_info;
+    }
+    get->sent = 1;
+
+    return NULL;
+}
+
+/**
+ * @brief Finish getting operational data started by ::sr_xpath_oper_data_get_start() and append them.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the data to get.
+ * @param[in] request_xpath XPath of the data request.
+ * @param[in] sid Sysrepo session ID.
+ * @param[in,out] get Operational data retrieval.
+ * @param[in,out] data Operational data tree, NULL to only finish the request and discard the data.
+ * @param[out] cb_error_info Callback error info returned by the client, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_oper_data_get_finish(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, const char *request_xpath,
+        sr_sid_t sid, struct sr_oper_get_s *get, struct lyd_node **data, sr_error_info_t **cb_error_info)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if (get->sent) {
+        /* wait for the data from the client */
+        get->sent = 0;
+        if ((err_info = sr_shmsub_oper_notify_recv(&get->req, &get->oper_data, cb_error_info))) {
+            goto cleanup;
+        }
+
+        if (get->oper_data) {
+            /* add default state data so that parents exist and we ask for descendants
+             * that can exist (it should not fail with TRUSTED flag, we do not care even if it does) */
+            lyd_validate_modules(&get->oper_data, &ly_mod, 1, LYD_OPT_DATA | LYD_OPT_TRUSTED);
+        }
+
+        if (get->ttl_ms && !*cb_error_info) {
+            /* cache the data */
+            if ((err_info = sr_oper_cache_store(&conn->oper_cache, ly_mod, get->shm_msub, sid, get->ttl_ms, get->ver,
+                    get->sub_xpath, get->parent_path, request_xpath, get->oper_data))) {
+                goto cleanup;
+            }
+        }
+    }
+
+    if (!data || !get->oper_data) {
+        /* nothing to merge */
+        goto cleanup;
+    }
+
+    /* merge into one data tree */
+    if (!*data) {
+        *data = get->oper_data;
+        get->oper_data = NULL;
+    } else if (lyd_merge(*data, get->oper_data, LYD_OPT_DESTRUCT)) {
+        sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+        goto cleanup;
+    } else {
+        get->oper_data = NULL;
+    }
+
+cleanup:
+    lyd_free_withsiblings(get->oper_data);
+    get->oper_data = NULL;
+    lyd_free_withsiblings(get->parent_dup);
+    get->parent_dup = NULL;
+    free(get->parent_path);
+    get->parent_path = NULL;
+    return err_info;
+}
+
+/**
+ * @brief Get operational data from several independent subscriptions at once. Requests
+ * to different subscriptions are all sent before waiting for any of them.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the data to get.
+ * @param[in] sid Sysrepo session ID.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] gets Operational data retrievals of the subscriptions, each with its own request XPath.
+ * @param[in] get_count Count of @p gets.
+ * @param[in,out] data Operational data tree.
+ * @param[out] cb_error_info Callback error info returned by the client, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_oper_data_get_parallel(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, sr_sid_t sid,
+        uint32_t timeout_ms, struct sr_oper_get_s *gets, uint32_t get_count, struct lyd_node **data,
+        sr_error_info_t **cb_error_info)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    struct sr_oper_get_s *get;
+    uint32_t i;
+    int pending;
+
+    do {
+        /* start getting the data from every subscription, only one request can be sent to a subscription */
+        for (i = 0; !err_info && (i < get_count); ++i) {
+            get = &gets[i];
+            while (!get->sent && !get->oper_data && !sr_xpath_oper_data_get_done(get)) {
+                if ((err_info = sr_xpath_oper_data_get_start(conn, ly_mod, get->request_xpath, sid, timeout_ms, get))) {
+                    break;
+                }
+                if (!get->sent && !get->oper_data) {
+                    /* parent filtered out */
+                    lyd_free_withsiblings(get->parent_dup);
+                    get->parent_dup = NULL;
+                    free(get->parent_path);
+                    get->parent_path = NULL;
+                }
+            }
+        }
+
+        /* finish all the requests, even on error so that no request is left unfinished */
+        pending = 0;
+        for (i = 0; i < get_count; ++i) {
+            get = &gets[i];
+            tmp_err = sr_xpath_oper_data_get_finish(conn, ly_mod, get->request_xpath, sid, get, err_info ? NULL : data,
+                    cb_error_info);
+            if (tmp_err) {
+                sr_errinfo_merge(&err_info, tmp_err);
+            }
+            if (!sr_xpath_oper_data_get_done(get)) {
+                pending = 1;
+            }
+        }
+    } while (!err_info && pending);
+
+    return err_info;
+}
+
+static sr_error_info_t *
+sr_module_oper_data_add_state_default(struct lyd_node **data, const struct lys_module *ly_mod)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node, *val_node, *sibling;
+    struct lyd_difflist *val_diff;
+    struct ly_set *set;
+    uint32_t i;
+
+    if (lyd_validate_modules(data, &ly_mod, 1, LYD_OPT_DATA | LYD_OPT_TRUSTED | LYD_OPT_VAL_DIFF, &val_diff)) {
+        sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+        SR_ERRINFO_VALID(&err_info);
+        return err_info;
+    }
+
+    /* remove added config nodes */
+    assert(val_diff);
+    for (i = 0; val_diff->type[i] != LYD_DIFF_END; ++i) {
+        if (val_diff->type[i] == LYD_DIFF_CREATED) {
+            /* get the sibling in the data */
+            if (val_diff->first[i]) {
+                set = lyd_find_path(*data, (char *)val_diff->first[i]);
+                if (!set) {
+                    sr_errinfo_new_ly(&err_info, ly_mod->ctx);
                     return err_info;
                 }
-                lyd_free_withsiblings(sr_module_data_unlink(&mod_info->data, mod->ly_mod));
-                if (mod_info->data) {
-                    sr_ly_link(mod_info->data, mod_data);
-                } else {
-                    mod_info->data = mod_data;
+                assert(set->number == 1);
+                sibling = set->set.d[0]->child;
+                ly_set_free(set);
+            } else {
+                sibling = *data;
+            }
+
+            LY_TREE_FOR(val_diff->second[i], val_node) {
+                if (val_node->schema->flags & LYS_CONFIG_R) {
+                    continue;
+                }
+
+                /* find the created node in the data and free it */
+                LY_TREE_FOR(sibling, node) {
+                    if (node->schema == val_node->schema) {
+                        lyd_free(node);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    lyd_free_val_diff(val_diff);
+    return NULL;
+}
+
+/**
+ * @brief Get a copy of the default data of a module with no data, create and cache them if not yet created.
+ *
+ * Used only when loading data for reading. Whenever the data are modified (apply changes, validate, copy-config),
+ * the defaults are created by validating the new data instead (::sr_modinfo_add_defaults(), ::sr_modinfo_validate())
+ * because they depend on the existing data (when conditions, choice cases, parents) and their creation must be part
+ * of the change diff.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] ly_mod Module of the default data.
+ * @param[in] state_only Whether to get only default state data or all default data.
+ * @param[out] data Default data of the module, NULL if there are none.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_dflt_cache_dup(sr_conn_ctx_t *conn, const struct lys_module *ly_mod, int state_only, struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_dflt_cache_s *cache = &conn->dflt_cache;
+    struct lyd_node **dflt;
+    uint8_t *created;
+    uint32_t i;
+    void *mem;
+
+    *data = NULL;
+
+    /* DFLT CACHE LOCK */
+    if ((err_info = sr_mlock(&cache->lock, -1, __func__))) {
+        return err_info;
+    }
+
+    for (i = 0; i < cache->mod_count; ++i) {
+        if (cache->mods[i].ly_mod == ly_mod) {
+            break;
+        }
+    }
+    if (i == cache->mod_count) {
+        /* new module */
+        mem = realloc(cache->mods, (i + 1) * sizeof *cache->mods);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_unlock);
+        cache->mods = mem;
+        ++cache->mod_count;
+
+        memset(&cache->mods[i], 0, sizeof *cache->mods);
+        cache->mods[i].ly_mod = ly_mod;
+    }
+
+    if (state_only) {
+        dflt = &cache->mods[i].state_dflt;
+        created = &cache->mods[i].state_dflt_created;
+    } else {
+        dflt = &cache->mods[i].dflt;
+        created = &cache->mods[i].dflt_created;
+    }
+
+    if (!*created) {
+        /* create the default data only once, they depend only on the schema */
+        if (state_only) {
+            if ((err_info = sr_module_oper_data_add_state_default(dflt, ly_mod))) {
+                goto cleanup_unlock;
+            }
+        } else {
+            /* it should not fail with TRUSTED flag, we do not care even if it does */
+            lyd_validate_modules(dflt, &ly_mod, 1, LYD_OPT_DATA | LYD_OPT_TRUSTED);
+        }
+        *created = 1;
+    }
+
+    if (*dflt) {
+        *data = lyd_dup_withsiblings(*dflt, LYD_DUP_OPT_RECURSIVE);
+        if (!*data) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+        }
+    }
+
+cleanup_unlock:
+    /* DFLT CACHE UNLOCK */
+    sr_munlock(&cache->lock);
+
+    return err_info;
+}
+
+void
+sr_conn_dflt_cache_free(sr_conn_ctx_t *conn)
+{
+    uint32_t i;
+
+    for (i = 0; i < conn->dflt_cache.mod_count; ++i) {
+        lyd_free_withsiblings(conn->dflt_cache.mods[i].dflt);
+        lyd_free_withsiblings(conn->dflt_cache.mods[i].state_dflt);
+    }
+    free(conn->dflt_cache.mods);
+    pthread_mutex_destroy(&conn->dflt_cache.lock);
+}
+
+/**
+ * @brief Learn whether the data provided by an operational subscription include the paged instances.
+ *
+ * @param[in] ly_mod Module of the subscription.
+ * @param[in] sub_xpath Subscription XPath.
+ * @param[in] page_snode Schema node of the paged instances.
+ * @return 0 if not, non-zero if they do.
+ */
+static int
+sr_oper_page_sub_provides(const struct lys_module *ly_mod, const char *sub_xpath, const struct lys_node *page_snode)
+{
+    const struct lys_node *parent;
+    struct ly_set *set;
+    char *schema_path;
+    uint32_t i;
+    int provides = 0;
+
+    schema_path = ly_path_data2schema(ly_mod->ctx, sub_xpath);
+    if (!schema_path) {
+        return 0;
+    }
+    set = lys_find_path(ly_mod, NULL, schema_path);
+    free(schema_path);
+    if (!set) {
+        return 0;
+    }
+
+    /* the subscription must provide the paged instances or one of their ancestors */
+    for (i = 0; !provides && (i < set->number); ++i) {
+        for (parent = page_snode; parent; parent = lys_parent(parent)) {
+            if (parent == set->set.s[i]) {
+                provides = 1;
+                break;
+            }
+        }
+    }
+
+    ly_set_free(set);
+    return provides;
+}
+
+/**
+ * @brief Update (replace or append) operational data for a specific module.
+ *
+ * @param[in] mod Mod info module to process.
+ * @param[in] sid Sysrepo session ID.
+ * @param[in] request_xpath XPath of the data request.
+ * @param[in] page Page of the requested data.
+ * @param[in] conn Connection to use.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] opts Get oper data options.
+ * @param[in,out] data Operational data tree.
+ * @param[out] cb_error_info Callback error info returned by the client, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_oper_data_update(struct sr_mod_info_mod_s *mod, sr_sid_t *sid, const char *request_xpath,
+        const struct sr_oper_page_s *page, sr_conn_ctx_t *conn, uint32_t timeout_ms, sr_get_oper_options_t opts,
+        struct lyd_node **data, sr_error_info_t **cb_error_info)
+{
+    char *ext_shm_addr = conn->ext_shm.addr;
+    sr_error_info_t *err_info = NULL;
+    sr_mod_oper_sub_t *shm_msub;
+    const char *sub_xpath;
+    char *parent_xpath = NULL, *sub_request_xpath = NULL;
+    uint16_t i;
+    uint32_t j, get_count = 0;
+    int required;
+    struct ly_set *set = NULL;
+    const struct lyd_node *diff;
+    struct sr_oper_get_s *gets = NULL;
+
+    if (!(opts & SR_OPER_NO_STORED)) {
+        /* apply stored operational diff, CACHE READ LOCK */
+        if ((err_info = sr_oper_diff_cache_rdlock(conn, mod->ly_mod, mod->shm_mod, &diff))) {
+            return err_info;
+        }
+        err_info = sr_diff_mod_apply(diff, mod->ly_mod, opts & SR_OPER_WITH_ORIGIN, data);
+
+        /* CACHE READ UNLOCK */
+        sr_rwunlock(&conn->oper_diff_cache.lock, SR_LOCK_READ, __func__);
+        if (err_info) {
+            return err_info;
+        }
+
+        if (!*data) {
+            /* add possible default state data nodes */
+            if ((err_info = sr_dflt_cache_dup(conn, mod->ly_mod, 0, data))) {
+                return err_info;
+            }
+        }
+    }
+
+    if ((opts & SR_OPER_NO_SUBS) || !mod->shm_mod->oper_sub_count) {
+        /* do not get data from subscribers */
+        return NULL;
+    }
+
+    assert(sid && timeout_ms && cb_error_info);
+
+    gets = calloc(mod->shm_mod->oper_sub_count, sizeof *gets);
+    SR_CHECK_MEM_RET(!gets, err_info);
+
+    /* XPaths are ordered based on depth */
+    i = 0;
+    while (i < mod->shm_mod->oper_sub_count) {
+        /* collect subscriptions whose data do not depend on each other */
+        for ( ; i < mod->shm_mod->oper_sub_count; ++i) {
+            shm_msub = &((sr_mod_oper_sub_t *)(ext_shm_addr + mod->shm_mod->oper_subs))[i];
+            sub_xpath = ext_shm_addr + shm_msub->xpath;
+
+            if ((shm_msub->sub_type == SR_OPER_SUB_CONFIG) && (opts & SR_OPER_NO_CONFIG)) {
+                /* useless to retrieve configuration data */
+                continue;
+            } else if ((shm_msub->sub_type == SR_OPER_SUB_STATE) && (opts & SR_OPER_NO_STATE)) {
+                /* useless to retrieve state data */
+                continue;
+            }
+
+            /* learn the paths of the request that need the data, the subscriber is asked only for those */
+            free(sub_request_xpath);
+            if ((err_info = sr_xpath_oper_data_request(request_xpath, sub_xpath, &sub_request_xpath, &required))) {
+                goto cleanup;
+            }
+            if (!required) {
+                /* useless to retrieve this data because they would be filtered out anyway */
+                continue;
+            }
+
+            for (j = 0; j < get_count; ++j) {
+                if (sr_xpath_oper_data_required(gets[j].sub_xpath, sub_xpath)) {
+                    break;
+                }
+            }
+            if (j < get_count) {
+                /* nested in the data of a previous subscription, must wait until they are retrieved */
+                break;
+            }
+
+            if ((shm_msub->sub_type == SR_OPER_SUB_CONFIG) || (shm_msub->sub_type == SR_OPER_SUB_MIXED)) {
+                /* remove any present data */
+                if ((err_info = sr_lyd_xpath_complement(data, sub_xpath))) {
+                    goto cleanup;
+                }
+            }
+
+            /* trim the last node to get the parent */
+            if ((err_info = sr_xpath_trim_last_node(sub_xpath, &parent_xpath))) {
+                goto cleanup;
+            }
+
+            if (parent_xpath) {
+                if (!*data) {
+                    /* parent does not exist for sure */
+                    free(parent_xpath);
+                    parent_xpath = NULL;
+                    continue;
+                }
+
+                set = lyd_find_path(*data, parent_xpath);
+                free(parent_xpath);
+                parent_xpath = NULL;
+                if (!set) {
+                    sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx);
+                    goto cleanup;
+                }
+
+                if (!set->number) {
+                    /* data parent does not exist */
+                    ly_set_free(set);
+                    set = NULL;
+                    continue;
+                }
+            }
+
+            /* nested data (for every parent) or top-level data */
+            gets[get_count].shm_msub = shm_msub;
+            gets[get_count].sub_xpath = sub_xpath;
+            gets[get_count].request_xpath = sub_request_xpath;
+            sub_request_xpath = NULL;
+            if (page->snode && !ATOMIC_LOAD_RELAXED(shm_msub->cache_ttl_ms)
+                    && sr_oper_page_sub_provides(mod->ly_mod, sub_xpath, page->snode)) {
+                /* the subscriber can return only the page, cached data are kept whole for all the pages */
+                gets[get_count].page_after = page->after_path;
+                gets[get_count].page_count = page->count;
+            }
+            gets[get_count].parents = set;
+            set = NULL;
+            ++get_count;
+        }
+
+        /* get the data from all the collected subscriptions */
+        if ((err_info = sr_xpath_oper_data_get_parallel(conn, mod->ly_mod, *sid, timeout_ms, gets, get_count, data,
+                cb_error_info))) {
+            goto cleanup;
+        }
+
+        /* prepare for the next subscriptions */
+        for (j = 0; j < get_count; ++j) {
+            free(gets[j].request_xpath);
+            ly_set_free(gets[j].parents);
+        }
+        memset(gets, 0, get_count * sizeof *gets);
+        get_count = 0;
+    }
+
+cleanup:
+    for (j = 0; j < get_count; ++j) {
+        free(gets[j].request_xpath);
+        ly_set_free(gets[j].parents);
+    }
+    free(gets);
+    free(sub_request_xpath);
+    return err_info;
+}
+
+/**
+ * @brief Duplicate operational (enabled) data from configuration data tree.
+ *
+ * @param[in] data Configuration data.
+ * @param[in] conn Connection to use.
+ * @param[in] mod Mod info module to process.
+ * @param[in] opts Get oper data options.
+ * @param[out] enabled_mod_data Enabled operational data of the module.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_module_oper_data_dup_enabled(const struct lyd_node *data, sr_conn_ctx_t *conn, struct sr_mod_info_mod_s *mod,
+        sr_get_oper_options_t opts, struct lyd_node **enabled_mod_data)
+{
+    sr_error_info_t *err_info = NULL;
+    char *ext_shm_addr = conn->ext_shm.addr;
+    sr_mod_change_sub_t *shm_changesubs;
+    struct lyd_node *root, *elem, *next;
+    uint16_t i, xp_i;
+    char **xpaths;
+    const char *origin;
+
+    *enabled_mod_data = NULL;
+
+    if (!data) {
+        /* no data is enabled */
+        return NULL;
+    }
+
+    /* first try to find a subscription for the whole module */
+    shm_changesubs = (sr_mod_change_sub_t *)(ext_shm_addr + mod->shm_mod->change_sub[SR_DS_RUNNING].subs);
+    for (i = 0; i < mod->shm_mod->change_sub[SR_DS_RUNNING].sub_count; ++i) {
+        if (!shm_changesubs[i].xpath && !(shm_changesubs[i].opts & SR_SUBSCR_PASSIVE)) {
+            /* the whole module is enabled */
+            if ((err_info = sr_module_data_dup(data, mod->ly_mod, enabled_mod_data))) {
+                return err_info;
+            }
+            return NULL;
+        }
+    }
+
+    /* collect all enabled subtress in the form of xpaths */
+    xpaths = NULL;
+    for (i = 0, xp_i = 0; i < mod->shm_mod->change_sub[SR_DS_RUNNING].sub_count; ++i) {
+        if (shm_changesubs[i].xpath && !(shm_changesubs[i].opts & SR_SUBSCR_PASSIVE)) {
+            xpaths = sr_realloc(xpaths, (xp_i + 1) * sizeof *xpaths);
+            SR_CHECK_MEM_RET(!xpaths, err_info);
+
+            xpaths[xp_i] = ext_shm_addr + shm_changesubs[i].xpath;
+            ++xp_i;
+        }
+    }
+
+    /* duplicate only enabled subtrees */
+    err_info = sr_lyd_xpath_dup(data, xpaths, xp_i, mod->ly_mod, enabled_mod_data);
+    free(xpaths);
+    if (err_info) {
+        return err_info;
+    }
+
+    /* add existing (valid) state NP containers and default values */
+    if (!*enabled_mod_data) {
+        /* nothing enabled, the defaults are always the same */
+        err_info = sr_dflt_cache_dup(conn, mod->ly_mod, 1, enabled_mod_data);
+    } else {
+        err_info = sr_module_oper_data_add_state_default(enabled_mod_data, mod->ly_mod);
+    }
+    if (err_info) {
+        return err_info;
+    }
+
+    if (opts & SR_OPER_WITH_ORIGIN) {
+        LY_TREE_FOR(*enabled_mod_data, root) {
+            /* add origin of all top-level nodes */
+            origin = (root->schema->flags & LYS_CONFIG_W) ? SR_CONFIG_ORIGIN : SR_OPER_ORIGIN;
+            if ((err_info = sr_edit_diff_set_origin(root, origin, 1))) {
+                return err_info;
+            }
+
+            LY_TREE_DFS_BEGIN(root, next, elem) {
+                /* add origin of default nodes */
+                if ((elem->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) && elem->dflt) {
+                    if ((err_info = sr_edit_diff_set_origin(elem, "default", 1))) {
+                        return err_info;
+                    }
+                }
+                LY_TREE_DFS_END(root, next, elem);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Update cached running module data (if required).
+ *
+ * @param[in] mod_cache Module cache.
+ * @param[in] mod Mod info module to process.
+ * @param[in] upd_mod_data Optional current (updated) module data to store in cache.
+ * @param[in] read_locked Whether the cache is READ locked.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modcache_module_running_update(struct sr_mod_cache_s *mod_cache, struct sr_mod_info_mod_s *mod,
+        struct lyd_node **upd_mod_data, int read_locked)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+    void *mem;
+
+    /* find the module in the cache */
+    for (i = 0; i < mod_cache->mod_count; ++i) {
+        if (mod->ly_mod == mod_cache->mods[i].ly_mod) {
+            break;
+        }
+    }
+
+    if (i < mod_cache->mod_count) {
+        /* this module data are already in the cache */
+        assert(mod->shm_mod->ver >= mod_cache->mods[i].ver);
+        if (mod->shm_mod->ver > mod_cache->mods[i].ver) {
+            if (read_locked) {
+                /* CACHE READ UNLOCK */
+                sr_rwunlock(&mod_cache->lock, SR_LOCK_READ, __func__);
+            }
+
+            /* CACHE WRITE LOCK */
+            if ((err_info = sr_rwlock(&mod_cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
+                goto error_rlock;
+            }
+
+            /* data needs to be updated, remove old data */
+            lyd_free_withsiblings(sr_module_data_unlink(&mod_cache->data, mod->ly_mod));
+            mod_cache->mods[i].ver = 0;
+        }
+    } else {
+        if (read_locked) {
+            /* CACHE READ UNLOCK */
+            sr_rwunlock(&mod_cache->lock, SR_LOCK_READ, __func__);
+        }
+
+        /* CACHE WRITE LOCK */
+        if ((err_info = sr_rwlock(&mod_cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
+            goto error_rlock;
+        }
+
+        /* module is not in cache yet, add an item */
+        mem = realloc(mod_cache->mods, (i + 1) * sizeof *mod_cache->mods);
+        SR_CHECK_MEM_RET(!mem, err_info);
+        mod_cache->mods = mem;
+        ++mod_cache->mod_count;
+
+        mod_cache->mods[i].ly_mod = mod->ly_mod;
+        mod_cache->mods[i].ver = 0;
+    }
+
+    /* append current data */
+    if (!mod_cache->mods[i].ver) {
+        if (upd_mod_data) {
+            /* current data were provided */
+            if (mod_cache->data) {
+                sr_ly_link(mod_cache->data, *upd_mod_data);
+            } else {
+                mod_cache->data = *upd_mod_data;
+            }
+            *upd_mod_data = NULL;
+        } else {
+            /* we need to load current data from persistent storage */
+            if ((err_info = sr_module_file_data_append(mod->ly_mod, SR_DS_RUNNING, &mod_cache->data))) {
+                goto error_wrunlock;
+            }
+        }
+        mod_cache->mods[i].ver = mod->shm_mod->ver;
+
+error_wrunlock:
+        /* CACHE WRITE UNLOCK */
+        sr_rwunlock(&mod_cache->lock, SR_LOCK_WRITE, __func__);
+
+error_rlock:
+        if (read_locked) {
+            /* CACHE READ LOCK */
+            if ((err_info = sr_rwlock(&mod_cache->lock, SR_MOD_CACHE_LOCK_TIMEOUT * 1000, SR_LOCK_READ, __func__))) {
+                return err_info;
+            }
+        }
+    }
+
+    return err_info;
+}
+
+/**
+ * @brief Trim all configuration/state nodes/origin from the data based on options.
+ *
+ * @param[in,out] data Data to trim.
+ * @param[in] sibling First sibling of the current data to trim.
+ * @param[in] opts Get oper data options.
+ */
+static void
+sr_oper_data_trim_r(struct lyd_node **data, struct lyd_node *sibling, sr_get_oper_options_t opts)
+{
+    struct lyd_node *next, *elem;
+    struct lyd_attr *attr;
+
+    if (!(opts & (SR_OPER_NO_STATE | SR_OPER_NO_CONFIG)) && (opts & SR_OPER_WITH_ORIGIN)) {
+        /* nothing to trim */
+        return;
+    }
+
+    LY_TREE_FOR_SAFE(sibling, next, elem) {
+        assert((elem->schema->nodetype != LYS_LEAF) || !lys_is_key((struct lys_node_leaf *)elem->schema, NULL));
+        if (elem->schema->flags & LYS_CONFIG_R) {
+            /* state subtree */
+            if (opts & SR_OPER_NO_STATE) {
+                /* free it whole */
+                if (*data == elem) {
+                    *data = (*data)->next;
+                }
+                lyd_free(elem);
+                continue;
+            }
+
+            if (opts & SR_OPER_WITH_ORIGIN) {
+                /* no need to go into state children */
+                continue;
+            }
+        }
+
+        /* trim all our children */
+        sr_oper_data_trim_r(data, sr_lyd_child(elem, 1), opts);
+
+        if ((elem->schema->flags & LYS_CONFIG_W) && (opts & SR_OPER_NO_CONFIG) && !sr_lyd_child(elem, 1)) {
+            /* config-only subtree (config node with no children) */
+            if (*data == elem) {
+                *data = (*data)->next;
+            }
+            lyd_free(elem);
+            continue;
+        }
+
+        if (!(opts & SR_OPER_WITH_ORIGIN)) {
+            /* trim origin */
+            LY_TREE_FOR(elem->attr, attr) {
+                if (!strcmp(attr->name, "origin") && !strcmp(attr->annotation->module->name, "ietf-origin")) {
+                    lyd_free_attr(elem->schema->module->ctx, elem, attr, 0);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Load module data of a specific module.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod Mod info module to process.
+ * @param[in] load_diff Whether to load stored operational diff of the module.
+ * @param[in] sid Sysrepo session ID.
+ * @param[in] request_xpath XPath of the data request.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] opts Get oper data options.
+ * @param[out] cb_error_info Callback error info returned by operational subscribers, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_module_data_load(struct sr_mod_info_s *mod_info, struct sr_mod_info_mod_s *mod, sr_sid_t *sid,
+        const char *request_xpath, uint32_t timeout_ms, sr_get_oper_options_t opts, sr_error_info_t **cb_error_info)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = mod_info->conn;
+    struct sr_mod_cache_s *mod_cache = NULL;
+    struct lyd_node *mod_data;
+    sr_datastore_t conf_ds;
+
+    if (((mod_info->ds == SR_DS_RUNNING) || (mod_info->ds == SR_DS_OPERATIONAL)) && (conn->opts & SR_CONN_CACHE_RUNNING)) {
+        /* we are caching, so in all cases load the module into cache if not yet there */
+        mod_cache = &conn->mod_cache;
+        if ((err_info = sr_modcache_module_running_update(mod_cache, mod, NULL, mod_info->data_cached))) {
+            return err_info;
+        }
+    }
+
+    if (!mod_info->data_cached) {
+        if (mod_cache) {
+            assert((mod_info->ds == SR_DS_RUNNING) || (mod_info->ds == SR_DS_OPERATIONAL));
+
+            /* we are caching, copy module data from the cache and link it */
+            if (mod_info->ds == SR_DS_OPERATIONAL) {
+                /* copy only enabled module data */
+                if ((err_info = sr_module_oper_data_dup_enabled(mod_cache->data, conn, mod, opts,
+                            &mod_data))) {
+                    return err_info;
+                }
+            } else {
+                /* copy all module data */
+                if ((err_info = sr_module_data_dup(mod_cache->data, mod->ly_mod, &mod_data))) {
+                    return err_info;
+                }
+            }
+            if (mod_info->data) {
+                sr_ly_link(mod_info->data, mod_data);
+            } else {
+                mod_info->data = mod_data;
+            }
+        } else {
+            /* get current persistent data */
+            if (mod_info->ds == SR_DS_OPERATIONAL) {
+                conf_ds = SR_DS_RUNNING;
+            } else {
+                conf_ds = mod_info->ds;
+            }
+            if ((err_info = sr_module_file_data_append(mod->ly_mod, conf_ds, &mod_info->data))) {
+                return err_info;
+            }
+
+            if (mod_info->ds == SR_DS_OPERATIONAL) {
+                /* keep only enabled module data */
+                if ((err_info = sr_module_oper_data_dup_enabled(mod_info->data, conn, mod, opts,
+                            &mod_data))) {
+                    return err_info;
+                }
+                lyd_free_withsiblings(sr_module_data_unlink(&mod_info->data, mod->ly_mod));
+                if (mod_info->data) {
+                    sr_ly_link(mod_info->data, mod_data);
+                } else {
+                    mod_info->data = mod_data;
+                }
+            }
+        }
+
+        if (mod_info->ds == SR_DS_OPERATIONAL) {
+            /* append any operational data provided by clients */
+            if ((err_info = sr_module_oper_data_update(mod, sid, request_xpath, &mod_info->oper_page, conn, timeout_ms,
+                        opts, &mod_info->data, cb_error_info))) {
+                return err_info;
+            }
+
+            /* trim any data according to options (they could not be trimmed before oper subscriptions) */
+            sr_oper_data_trim_r(&mod_info->data, mod_info->data, opts);
+        }
+    } else {
+        assert(mod_cache && SR_IS_CONVENTIONAL_DS(mod_info->ds));
+
+        /* just use cached data */
+        mod_info->data = mod_cache->data;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Collect modules that may be targeted by instance-identifiers.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] shm_deps SHM dependencies of relevant instance-identifiers.
+ * @param[in] shm_dep_count SHM dependency count.
+ * @param[in] data Data with the instance-identifiers.
+ * @param[in,out] trg_mods Set of target modules (const struct lys_module *) to add to.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_instid_trg_mods(sr_conn_ctx_t *conn, sr_mod_data_dep_t *shm_deps, uint16_t shm_dep_count,
+        const struct lyd_node *data, struct ly_set *trg_mods)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lys_module *ly_mod;
+    struct ly_set *set = NULL;
+    const char *val_str;
+    char *mod_name;
+    uint32_t i, j;
+
+    /* collect all possibly required modules (because of inst-ids) into a set */
+    for (i = 0; i < shm_dep_count; ++i) {
+        if (shm_deps[i].type == SR_DEP_INSTID) {
+            if (data) {
+                set = lyd_find_path(data, conn->ext_shm.addr + shm_deps[i].xpath);
+            } else {
+                /* no data, just fake empty set */
+                set = ly_set_new();
+            }
+            if (!set) {
+                sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+                goto cleanup;
+            }
+
+            if (set->number) {
+                /* extract module names from all the existing instance-identifiers */
+                for (j = 0; j < set->number; ++j) {
+                    assert(set->set.d[j]->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST));
+                    val_str = sr_ly_leaf_value_str(set->set.d[j]);
+
+                    mod_name = sr_get_first_ns(val_str);
+                    ly_mod = ly_ctx_get_module(conn->ly_ctx, mod_name, NULL, 1);
+                    free(mod_name);
+                    SR_CHECK_INT_GOTO(!ly_mod, err_info, cleanup);
+
+                    /* add the module so that duplicities can be found easily */
+                    if (ly_set_add(trg_mods, (void *)ly_mod, 0) == -1) {
+                        sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+                        goto cleanup;
+                    }
+                }
+            } else if (shm_deps[i].module) {
+                /* assume a default value will be used even though it may not be */
+                ly_mod = ly_ctx_get_module(conn->ly_ctx, conn->ext_shm.addr + shm_deps[i].module, NULL, 1);
+                SR_CHECK_INT_GOTO(!ly_mod, err_info, cleanup);
+
+                if (ly_set_add(trg_mods, (void *)ly_mod, 0) == -1) {
+                    sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+                    goto cleanup;
+                }
+            }
+            ly_set_free(set);
+            set = NULL;
+        }
+    }
+
+    /* success */
+
+cleanup:
+    ly_set_free(set);
+    return err_info;
+}
+
+/**
+ * @brief Add modules targeted by instance-identifiers to mod info with their data.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] trg_mods Set of target modules (const struct lys_module *).
+ * @param[in] sid Sysrepo session ID.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[out] cb_error_info Callback error info returned by oper subscribers, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_add_instid_trg_mods(struct sr_mod_info_s *mod_info, const struct ly_set *trg_mods, sr_sid_t *sid,
+        uint32_t timeout_ms, sr_error_info_t **cb_error_info)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = mod_info->conn;
+    sr_mod_t *dep_mod;
+    const struct lys_module *ly_mod;
+    uint32_t i, j;
+
+    /* add new modules to mod_info */
+    for (i = 0; i < trg_mods->number; ++i) {
+        ly_mod = (const struct lys_module *)trg_mods->set.g[i];
+
+        dep_mod = sr_shmmain_find_module(&conn->main_shm, conn->ext_shm.addr, ly_mod->name, 0);
+        SR_CHECK_INT_RET(!dep_mod, err_info);
+
+        /* remember how many modules there were and add this one */
+        j = mod_info->mod_count;
+        if ((err_info = sr_modinfo_add_mod(dep_mod, ly_mod, MOD_INFO_DEP, 0, mod_info))) {
+            return err_info;
+        }
+
+        /* add this module data if not already there */
+        if ((j < mod_info->mod_count) && (err_info = sr_modinfo_module_data_load(mod_info, &mod_info->mods[j], sid,
+                    NULL, timeout_ms, 0, cb_error_info))) {
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add modules and data dependencies of instance-identifiers to mod info.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] shm_deps SHM dependencies of relevant instance-identifiers.
+ * @param[in] shm_dep_count SHM dependency count.
+ * @param[in] data Data with the instance-identifiers.
+ * @param[in] sid Sysrepo session ID.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[out] cb_error_info Callback error info returned by oper subscribers, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_add_instid_deps_data(struct sr_mod_info_s *mod_info, sr_mod_data_dep_t *shm_deps, uint16_t shm_dep_count,
+        const struct lyd_node *data, sr_sid_t *sid, uint32_t timeout_ms, sr_error_info_t **cb_error_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *trg_mods;
+
+    trg_mods = ly_set_new();
+    SR_CHECK_MEM_RET(!trg_mods, err_info);
+
+    if ((err_info = sr_modinfo_instid_trg_mods(mod_info->conn, shm_deps, shm_dep_count, data, trg_mods))) {
+        goto cleanup;
+    }
+    err_info = sr_modinfo_add_instid_trg_mods(mod_info, trg_mods, sid, timeout_ms, cb_error_info);
+
+cleanup:
+    ly_set_free(trg_mods);
+    return err_info;
+}
+
+/**
+ * @brief Add modules and data dependencies of instance-identifiers of changed module data to mod info.
+ * Instance-identifier targets of the stored running data are cached so that only
+ * the instance-identifiers in the diff need to be evaluated.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] mod_idx Index of the changed mod info module.
+ * @param[in] sid Sysrepo session ID.
+ * @param[out] cb_error_info Callback error info returned by oper subscribers, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_add_instid_deps_changed(struct sr_mod_info_s *mod_info, uint32_t mod_idx, sr_sid_t *sid,
+        sr_error_info_t **cb_error_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_mod_s *mod = &mod_info->mods[mod_idx];
+    sr_mod_data_dep_t *shm_deps;
+    struct ly_set *trg_mods;
+    uint32_t i;
+    int hit = 0;
+
+    shm_deps = (sr_mod_data_dep_t *)(mod_info->conn->ext_shm.addr + mod->shm_mod->data_deps);
+    for (i = 0; i < mod->shm_mod->data_dep_count; ++i) {
+        if (shm_deps[i].type == SR_DEP_INSTID) {
+            break;
+        }
+    }
+    if (i == mod->shm_mod->data_dep_count) {
+        /* no instance-identifiers */
+        return NULL;
+    }
+
+    if (!mod->instid_trgs) {
+        mod->instid_trgs = ly_set_new();
+        SR_CHECK_MEM_RET(!mod->instid_trgs, err_info);
+    }
+    trg_mods = mod->instid_trgs;
+
+    if ((mod_info->ds == SR_DS_RUNNING) && mod_info->diff) {
+        /* use the targets of the stored data, if cached */
+        if ((err_info = sr_instid_cache_get(mod_info->conn, mod, trg_mods, &hit))) {
+            return err_info;
+        }
+    }
+
+    /* only changed inst-ids can have new targets, if we know those of the stored data (removed targets are kept,
+     * the set of targets is never smaller than needed) */
+    if ((err_info = sr_modinfo_instid_trg_mods(mod_info->conn, shm_deps, mod->shm_mod->data_dep_count,
+            hit ? mod_info->diff : mod_info->data, trg_mods))) {
+        return err_info;
+    }
+
+    /* mod may be moved */
+    return sr_modinfo_add_instid_trg_mods(mod_info, trg_mods, sid, 0, cb_error_info);
+}
+
+static sr_error_info_t *
+sr_modinfo_ly_val_diff_merge(struct sr_mod_info_s *mod_info, struct lyd_difflist *val_diff)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+    struct lys_node *snode;
+    uint32_t i, j;
+    int change;
+
+    assert(val_diff);
+
+    for (i = 0; val_diff->type[i] != LYD_DIFF_END; ++i) {
+        if ((err_info = sr_ly_val_diff_merge(&mod_info->diff, val_diff->type[i], val_diff->first[i],
+                val_diff->second[i], mod_info->conn->ly_ctx, &change))) {
+            return err_info;
+        }
+
+        /* additional modules can be modified */
+        if (change) {
+            if (val_diff->type[i] == LYD_DIFF_CREATED) {
+                node = val_diff->second[i];
+            } else {
+                node = val_diff->first[i];
+            }
+
+            /* get the module that actually owns the data (handle augments) */
+            for (snode = node->schema; lys_parent(snode); snode = lys_parent(snode));
+            for (j = 0; j < mod_info->mod_count; ++j) {
+                if (lys_node_module(snode) == mod_info->mods[j].ly_mod) {
+                    mod_info->mods[j].state |= MOD_INFO_CHANGED;
+                    break;
+                }
+            }
+            assert(j < mod_info->mod_count);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check whether data of a module could have become invalid because of the changes in mod info.
+ *
+ * @param[in] mod_info Mod info with the changed modules.
+ * @param[in] mod Mod info module to check.
+ * @return 0 if its data are still valid, non-zero if they need to be validated.
+ */
+static int
+sr_modinfo_validate_is_affected(const struct sr_mod_info_s *mod_info, const struct sr_mod_info_mod_s *mod)
+{
+    const struct sr_mod_info_mod_s *ch_mod;
+    off_t *shm_inv_deps;
+    uint32_t i, j;
+
+#ifdef SR_FULL_VALIDATION
+    /* validate everything */
+    return 1;
+#endif
+
+    if ((mod_info->ds == SR_DS_CANDIDATE) || (mod_info->ds == SR_DS_OPERATIONAL)) {
+        /* stored data do not have to be valid */
+        return 1;
+    }
+
+    if (mod->state & MOD_INFO_CHANGED) {
+        return 1;
+    }
+
+    /* unchanged data can become invalid only if data of a module they depend on were changed */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        ch_mod = &mod_info->mods[i];
+        if (!(ch_mod->state & MOD_INFO_CHANGED)) {
+            continue;
+        }
+
+        shm_inv_deps = (off_t *)(mod_info->conn->ext_shm.addr + ch_mod->shm_mod->inv_data_deps);
+        for (j = 0; j < ch_mod->shm_mod->inv_data_dep_count; ++j) {
+            if (shm_inv_deps[j] == mod->shm_mod->name) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Group of modules whose data can be validated independently of all the other modules.
+ */
+struct sr_modinfo_valid_group_s {
+    uint32_t comp;                          /**< Representative mod info module index of the group. */
+    const struct lys_module **valid_mods;   /**< Modules of the group to validate. */
+    uint32_t valid_mod_count;               /**< Count of modules to validate. */
+    struct lyd_node *data;                  /**< Separate sibling chain with the data of all the group modules. */
+    struct lyd_difflist *diff;              /**< Validation diff. */
+    sr_error_info_t *err_info;              /**< Validation error. */
+};
+
+/**
+ * @brief Shared context of threads validating module groups.
+ */
+struct sr_modinfo_valid_s {
+    struct sr_modinfo_valid_group_s *groups;    /**< Module groups. */
+    uint32_t group_count;                   /**< Module group count. */
+    ATOMIC_T next_group;                    /**< Index of the next group to validate. */
+    const struct ly_ctx *ly_ctx;            /**< libyang context. */
+    int flags;                              /**< Validation flags. */
+};
+
+/**
+ * @brief Find the representative of a mod info module in the module union-find forest.
+ *
+ * @param[in] comp Module union-find forest.
+ * @param[in] idx Mod info module index.
+ * @return Representative mod info module index.
+ */
+static uint32_t
+sr_modinfo_comp_find(uint32_t *comp, uint32_t idx)
+{
+    while (comp[idx] != idx) {
+        /* path halving */
+        comp[idx] = comp[comp[idx]];
+        idx = comp[idx];
+    }
+
+    return idx;
+}
+
+/**
+ * @brief Join 2 mod info modules in the module union-find forest.
+ *
+ * @param[in] comp Module union-find forest.
+ * @param[in] idx1 First mod info module index.
+ * @param[in] idx2 Second mod info module index.
+ */
+static void
+sr_modinfo_comp_join(uint32_t *comp, uint32_t idx1, uint32_t idx2)
+{
+    idx1 = sr_modinfo_comp_find(comp, idx1);
+    idx2 = sr_modinfo_comp_find(comp, idx2);
+    if (idx1 < idx2) {
+        comp[idx2] = idx1;
+    } else {
+        comp[idx1] = idx2;
+    }
+}
+
+/**
+ * @brief Find a mod info module index.
+ *
+ * @param[in] mod_info Mod info to use.
+ * @param[in] ly_mod Module to find.
+ * @return Mod info module index, mod count if not found.
+ */
+static uint32_t
+sr_modinfo_mod_idx(const struct sr_mod_info_s *mod_info, const struct lys_module *ly_mod)
+{
+    uint32_t i;
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        if (mod_info->mods[i].ly_mod == ly_mod) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/**
+ * @brief Split modules to be validated into groups with no data dependencies between them.
+ *
+ * @param[in] mod_info Mod info with the modules to validate flagged.
+ * @param[out] comp Module union-find forest, the groups.
+ * @param[out] groups Module groups with some modules to validate.
+ * @param[out] group_count Module group count, 0 if the modules cannot be split.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_validate_groups(const struct sr_mod_info_s *mod_info, uint32_t **comp,
+        struct sr_modinfo_valid_group_s **groups, uint32_t *group_count)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct sr_mod_info_mod_s *mod;
+    struct sr_modinfo_valid_group_s *group, *tmp;
+    sr_mod_data_dep_t *shm_deps;
+    const struct lys_module *trg_mod, **mods;
+    uint32_t i, j, k;
+
+    *groups = NULL;
+    *group_count = 0;
+
+    *comp = malloc(mod_info->mod_count * sizeof **comp);
+    SR_CHECK_MEM_RET(!*comp, err_info);
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        (*comp)[i] = i;
+    }
+
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+
+        /* data dependencies */
+        shm_deps = (sr_mod_data_dep_t *)(mod_info->conn->ext_shm.addr + mod->shm_mod->data_deps);
+        for (j = 0; j < mod->shm_mod->data_dep_count; ++j) {
+            if ((shm_deps[j].type == SR_DEP_INSTID) && (mod->state & MOD_INFO_VALIDATE) && !mod->instid_trgs) {
+                /* the instance-identifier targets are not known, validate everything together */
+                return NULL;
+            }
+
+            if (shm_deps[j].module) {
+                for (k = 0; k < mod_info->mod_count; ++k) {
+                    if (mod_info->mods[k].shm_mod->name == shm_deps[j].module) {
+                        sr_modinfo_comp_join(*comp, i, k);
+                        break;
+                    }
                 }
             }
         }
 
-        if (mod_info->ds == SR_DS_OPERATIONAL) {
-            /* append any operational data provided by clients */
-            if ((err_info = sr_module_oper_data_update(mod, sid, request_xpath, conn->ext_shm.addr,
-                        timeout_ms, opts, &mod_info->data, cb_error_info))) {
-                return err_info;
+        /* instance-identifier targets */
+        for (j = 0; mod->instid_trgs && (j < mod->instid_trgs->number); ++j) {
+            k = sr_modinfo_mod_idx(mod_info, mod->instid_trgs->set.g[j]);
+            if (k < mod_info->mod_count) {
+                sr_modinfo_comp_join(*comp, i, k);
             }
+        }
 
-            /* trim any data according to options (they could not be trimmed before oper subscriptions) */
-            sr_oper_data_trim_r(&mod_info->data, mod_info->data, opts);
+        /* augmented modules, the augment data are validated with the data of the target module */
+        for (j = 0; j < mod->ly_mod->augment_size; ++j) {
+            trg_mod = lys_node_module(mod->ly_mod->augment[j].target);
+            k = sr_modinfo_mod_idx(mod_info, trg_mod);
+            if (k < mod_info->mod_count) {
+                sr_modinfo_comp_join(*comp, i, k);
+            }
         }
-    } else {
-        assert(mod_cache && SR_IS_CONVENTIONAL_DS(mod_info->ds));
+    }
 
-        /* just use cached data */
-        mod_info->data = mod_cache->data;
+    /* create the groups */
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        mod = &mod_info->mods[i];
+        if (!(mod->state & MOD_INFO_VALIDATE)) {
+            continue;
+        }
+
+        k = sr_modinfo_comp_find(*comp, i);
+        for (j = 0; j < *group_count; ++j) {
+            if ((*groups)[j].comp == k) {
+                break;
+            }
+        }
+        if (j == *group_count) {
+            tmp = realloc(*groups, (*group_count + 1) * sizeof **groups);
+            SR_CHECK_MEM_RET(!tmp, err_info);
+            *groups = tmp;
+            memset(&(*groups)[j], 0, sizeof **groups);
+            (*groups)[j].comp = k;
+            ++(*group_count);
+        }
+        group = &(*groups)[j];
+
+        mods = realloc(group->valid_mods, (group->valid_mod_count + 1) * sizeof *group->valid_mods);
+        SR_CHECK_MEM_RET(!mods, err_info);
+        group->valid_mods = mods;
+        group->valid_mods[group->valid_mod_count] = mod->ly_mod;
+        ++group->valid_mod_count;
     }
 
     return NULL;
 }
 
 /**
- * @brief Add modules and data dependencies of instance-identifiers to mod info.
+ * @brief Append a sibling chain to another top-level sibling chain.
  *
- * @param[in] mod_info Mod info to use.
- * @param[in] shm_deps SHM dependencies of relevant instance-identifiers.
- * @param[in] shm_dep_count SHM dependency count.
- * @param[in] sid Sysrepo session ID.
- * @param[in] timeout_ms Operational callback timeout in milliseconds.
- * @param[out] cb_error_info Callback error info returned by oper subscribers, if any.
- * @return err_info, NULL on success.
+ * @param[in,out] first First sibling of the chain to append to.
+ * @param[in] chain Sibling chain to append.
  */
-static sr_error_info_t *
-sr_modinfo_add_instid_deps_data(struct sr_mod_info_s *mod_info, sr_mod_data_dep_t *shm_deps, uint16_t shm_dep_count,
-        const struct lyd_node *data, sr_sid_t *sid, uint32_t timeout_ms, sr_error_info_t **cb_error_info)
+static void
+sr_modinfo_data_append(struct lyd_node **first, struct lyd_node *chain)
 {
-    sr_error_info_t *err_info = NULL;
-    sr_conn_ctx_t *conn;
-    sr_mod_t *dep_mod;
-    const struct lys_module *ly_mod;
-    struct ly_set *set = NULL, *dep_set = NULL;
-    const char *val_str;
-    char *mod_name;
-    uint32_t i, j;
-
-    conn = mod_info->conn;
+    struct lyd_node *last;
 
-    dep_set = ly_set_new();
-    if (!dep_set) {
-        sr_errinfo_new_ly(&err_info, conn->ly_ctx);
-        goto cleanup;
+    if (!chain) {
+        return;
+    }
+    if (!*first) {
+        *first = chain;
+        return;
     }
 
-    /* collect all possibly required modules (because of inst-ids) into a set */
-    for (i = 0; i < shm_dep_count; ++i) {
-        if (shm_deps[i].type == SR_DEP_INSTID) {
-            if (data) {
-                set = lyd_find_path(data, conn->ext_shm.addr + shm_deps[i].xpath);
-            } else {
-                /* no data, just fake empty set */
-                set = ly_set_new();
-            }
-            if (!set) {
-                sr_errinfo_new_ly(&err_info, conn->ly_ctx);
-                goto cleanup;
-            }
-
-            if (set->number) {
-                /* extract module names from all the existing instance-identifiers */
-                for (j = 0; j < set->number; ++j) {
-                    assert(set->set.d[j]->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST));
-                    val_str = sr_ly_leaf_value_str(set->set.d[j]);
-
-                    mod_name = sr_get_first_ns(val_str);
-                    dep_mod = sr_shmmain_find_module(&conn->main_shm, conn->ext_shm.addr, mod_name, 0);
-                    free(mod_name);
-                    SR_CHECK_INT_GOTO(!dep_mod, err_info, cleanup);
+    last = chain->prev;
+    (*first)->prev->next = chain;
+    chain->prev = (*first)->prev;
+    (*first)->prev = last;
+}
 
-                    /* add module name offset so that duplicities can be found easily */
-                    if (ly_set_add(dep_set, (void *)dep_mod, 0) == -1) {
-                        sr_errinfo_new_ly(&err_info, conn->ly_ctx);
-                        goto cleanup;
-                    }
-                }
-            } else if (shm_deps[i].module) {
-                /* assume a default value will be used even though it may not be */
-                dep_mod = sr_shmmain_find_module(&conn->main_shm, NULL, NULL, shm_deps[i].module);
-                SR_CHECK_INT_GOTO(!dep_mod, err_info, cleanup);
+/**
+ * @brief Thread validating module groups.
+ *
+ * @param[in] arg Validation context.
+ * @return NULL.
+ */
+static void *
+sr_modinfo_validate_thread(void *arg)
+{
+    struct sr_modinfo_valid_s *valid = arg;
+    struct sr_modinfo_valid_group_s *group;
+    uint32_t i;
 
-                if (ly_set_add(dep_set, (void *)dep_mod, 0) == -1) {
-                    sr_errinfo_new_ly(&err_info, conn->ly_ctx);
-                    goto cleanup;
-                }
-            }
-            ly_set_free(set);
-            set = NULL;
+    while ((i = ATOMIC_INC_RELAXED(valid->next_group)) < valid->group_count) {
+        group = &valid->groups[i];
+        if (lyd_validate_modules(&group->data, group->valid_mods, group->valid_mod_count, valid->flags, &group->diff)) {
+            sr_errinfo_new_ly(&group->err_info, (struct ly_ctx *)valid->ly_ctx);
         }
     }
 
-    /* add new modules to mod_info */
-    for (i = 0; i < dep_set->number; ++i) {
-        dep_mod = (sr_mod_t *)dep_set->set.g[i];
+    return NULL;
+}
 
-        ly_mod = ly_ctx_get_module(mod_info->conn->ly_ctx, conn->ext_shm.addr + dep_mod->name, NULL, 1);
-        SR_CHECK_INT_GOTO(!ly_mod, err_info, cleanup);
+/**
+ * @brief Validation worker thread of a connection, takes part in every parallel validation.
+ *
+ * @param[in] arg Connection.
+ * @return NULL.
+ */
+static void *
+sr_valid_pool_thread(void *arg)
+{
+    struct sr_valid_pool_s *pool = &((sr_conn_ctx_t *)arg)->valid_pool;
+    struct sr_modinfo_valid_s *valid;
+    uint32_t last_id = 0;
 
-        /* remember how many modules there were and add this one */
-        j = mod_info->mod_count;
-        if ((err_info = sr_modinfo_add_mod(dep_mod, ly_mod, MOD_INFO_DEP, 0, mod_info))) {
-            goto cleanup;
-        }
+    /* POOL LOCK */
+    pthread_mutex_lock(&pool->lock.mutex);
 
-        /* add this module data if not already there */
-        if ((j < mod_info->mod_count) && (err_info = sr_modinfo_module_data_load(mod_info, &mod_info->mods[j], sid,
-                    NULL, timeout_ms, 0, cb_error_info))) {
-            goto cleanup;
+    while (!pool->stop) {
+        if (!pool->valid || (pool->valid_id == last_id)) {
+            /* wait for the next validation */
+            pthread_cond_wait(&pool->lock.cond, &pool->lock.mutex);
+            continue;
         }
+
+        /* take part in the validation */
+        valid = pool->valid;
+        last_id = pool->valid_id;
+        ++pool->worker_count;
+
+        /* POOL UNLOCK */
+        pthread_mutex_unlock(&pool->lock.mutex);
+
+        sr_modinfo_validate_thread(valid);
+
+        /* POOL LOCK */
+        pthread_mutex_lock(&pool->lock.mutex);
+
+        --pool->worker_count;
+        pthread_cond_broadcast(&pool->lock.cond);
     }
 
-    /* success */
+    /* POOL UNLOCK */
+    pthread_mutex_unlock(&pool->lock.mutex);
 
-cleanup:
-    ly_set_free(set);
-    ly_set_free(dep_set);
-    return err_info;
+    return NULL;
 }
 
-static sr_error_info_t *
-sr_modinfo_ly_val_diff_merge(struct sr_mod_info_s *mod_info, struct lyd_difflist *val_diff)
+/**
+ * @brief Create the validation worker threads of a connection, if not yet created. Pool lock is expected to be held.
+ *
+ * @param[in] conn Connection to use.
+ */
+static void
+sr_valid_pool_start(sr_conn_ctx_t *conn)
 {
-    sr_error_info_t *err_info = NULL;
-    struct lyd_node *node;
-    struct lys_node *snode;
-    uint32_t i, j;
-    int change;
+    struct sr_valid_pool_s *pool = &conn->valid_pool;
+    uint32_t thread_count;
+    long cpu_count;
+    int ret;
 
-    assert(val_diff);
+    if (pool->tids) {
+        /* already started */
+        return;
+    }
 
-    for (i = 0; val_diff->type[i] != LYD_DIFF_END; ++i) {
-        if ((err_info = sr_ly_val_diff_merge(&mod_info->diff, val_diff->type[i], val_diff->first[i],
-                val_diff->second[i], mod_info->conn->ly_ctx, &change))) {
-            return err_info;
+    /* the validating thread takes part too */
+    thread_count = SR_VALID_THREAD_MAX;
+    cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if ((cpu_count > 0) && ((uint32_t)cpu_count < thread_count)) {
+        thread_count = cpu_count;
+    }
+    if (thread_count < 2) {
+        return;
+    }
+
+    pool->tids = malloc((thread_count - 1) * sizeof *pool->tids);
+    if (!pool->tids) {
+        return;
+    }
+    while (pool->tid_count < thread_count - 1) {
+        ret = pthread_create(&pool->tids[pool->tid_count], NULL, sr_valid_pool_thread, conn);
+        if (ret) {
+            /* use the threads created so far */
+            SR_LOG_WRN("Creating a validation thread failed (%s).", strerror(ret));
+            break;
         }
+        ++pool->tid_count;
+    }
+}
 
-        /* additional modules can be modified */
-        if (change) {
-            if (val_diff->type[i] == LYD_DIFF_CREATED) {
-                node = val_diff->second[i];
-            } else {
-                node = val_diff->first[i];
+void
+sr_conn_valid_pool_free(sr_conn_ctx_t *conn)
+{
+    struct sr_valid_pool_s *pool = &conn->valid_pool;
+    uint32_t i;
+
+    /* POOL LOCK */
+    pthread_mutex_lock(&pool->lock.mutex);
+
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->lock.cond);
+
+    /* POOL UNLOCK */
+    pthread_mutex_unlock(&pool->lock.mutex);
+
+    for (i = 0; i < pool->tid_count; ++i) {
+        pthread_join(pool->tids[i], NULL);
+    }
+    free(pool->tids);
+    sr_rwlock_destroy(&pool->lock);
+}
+
+/**
+ * @brief Learn whether data have at least a number of nodes.
+ *
+ * @param[in] data Data to examine.
+ * @param[in] count Required node count.
+ * @return 0 if there are fewer nodes, non-zero otherwise.
+ */
+static int
+sr_modinfo_data_has_nodes(struct lyd_node *data, uint32_t count)
+{
+    struct lyd_node *root, *next, *elem;
+    uint32_t i = 0;
+
+    LY_TREE_FOR(data, root) {
+        LY_TREE_DFS_BEGIN(root, next, elem) {
+            if (++i >= count) {
+                return 1;
             }
+            LY_TREE_DFS_END(root, next, elem);
+        }
+    }
 
-            /* get the module that actually owns the data (handle augments) */
-            for (snode = node->schema; lys_parent(snode); snode = lys_parent(snode));
-            for (j = 0; j < mod_info->mod_count; ++j) {
-                if (lys_node_module(snode) == mod_info->mods[j].ly_mod) {
-                    mod_info->mods[j].state |= MOD_INFO_CHANGED;
+    return 0;
+}
+
+/**
+ * @brief Validate independent module groups in parallel, each with a separate data sibling chain.
+ *
+ * @param[in] mod_info Mod info with the data.
+ * @param[in] comp Module union-find forest.
+ * @param[in] groups Module groups.
+ * @param[in] group_count Module group count.
+ * @param[in] flags Validation flags.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_modinfo_validate_parallel(struct sr_mod_info_s *mod_info, uint32_t *comp, struct sr_modinfo_valid_group_s *groups,
+        uint32_t group_count, int flags)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_valid_pool_s *pool = &mod_info->conn->valid_pool;
+    struct sr_modinfo_valid_s valid;
+    struct lyd_node *node, *next, *rest = NULL;
+    uint32_t i, k;
+    int pooled = 0;
+
+    /* split the data into separate sibling chains */
+    for (node = mod_info->data; node; node = next) {
+        next = node->next;
+        node->next = NULL;
+        node->prev = node;
+
+        k = sr_modinfo_mod_idx(mod_info, lyd_node_module(node));
+        if (k < mod_info->mod_count) {
+            k = sr_modinfo_comp_find(comp, k);
+            for (i = 0; i < group_count; ++i) {
+                if (groups[i].comp == k) {
                     break;
                 }
             }
-            assert(j < mod_info->mod_count);
+        } else {
+            i = group_count;
         }
+
+        sr_modinfo_data_append(i < group_count ? &groups[i].data : &rest, node);
     }
+    mod_info->data = NULL;
 
-    return NULL;
+    valid.groups = groups;
+    valid.group_count = group_count;
+    ATOMIC_STORE_RELAXED(valid.next_group, 0);
+    valid.ly_ctx = mod_info->conn->ly_ctx;
+    valid.flags = flags;
+
+    /* POOL LOCK */
+    if ((err_info = sr_mlock(&pool->lock.mutex, -1, __func__))) {
+        goto relink;
+    }
+
+    if (!pool->valid) {
+        /* let the workers of the connection join, they are busy if another session is validating */
+        sr_valid_pool_start(mod_info->conn);
+        pool->valid = &valid;
+        ++pool->valid_id;
+        pthread_cond_broadcast(&pool->lock.cond);
+        pooled = 1;
+    }
+
+    /* POOL UNLOCK */
+    sr_munlock(&pool->lock.mutex);
+
+    /* this thread validates too */
+    sr_modinfo_validate_thread(&valid);
+
+    if (pooled) {
+        /* POOL LOCK */
+        pthread_mutex_lock(&pool->lock.mutex);
+
+        /* wait for all the workers to finish */
+        while (pool->worker_count) {
+            pthread_cond_wait(&pool->lock.cond, &pool->lock.mutex);
+        }
+        pool->valid = NULL;
+
+        /* POOL UNLOCK */
+        pthread_mutex_unlock(&pool->lock.mutex);
+    }
+
+    for (i = 0; i < group_count; ++i) {
+        sr_errinfo_merge(&err_info, groups[i].err_info);
+        groups[i].err_info = NULL;
+    }
+
+relink:
+    /* relink all the data back together */
+    sr_modinfo_data_append(&mod_info->data, rest);
+    for (i = 0; i < group_count; ++i) {
+        sr_modinfo_data_append(&mod_info->data, groups[i].data);
+        groups[i].data = NULL;
+    }
+    return err_info;
 }
 
 sr_error_info_t *
@@ -1302,7 +3060,8 @@ sr_modinfo_validate(struct sr_mod_info_s *mod_info, int finish_diff, sr_sid_t *s
     struct sr_mod_info_mod_s *mod;
     struct lyd_difflist *diff = NULL;
     const struct lys_module **valid_mods = NULL;
-    uint32_t i, j, valid_mod_count = 0;
+    struct sr_modinfo_valid_group_s *groups = NULL;
+    uint32_t i, j, valid_mod_count = 0, group_count = 0, *comp = NULL;
     int flags;
 
     assert(SR_IS_CONVENTIONAL_DS(mod_info->ds) || (sid && cb_error_info));
@@ -1312,50 +3071,89 @@ sr_modinfo_validate(struct sr_mod_info_s *mod_info, int finish_diff, sr_sid_t *s
         mod = &mod_info->mods[i];
         switch (mod->state & MOD_INFO_TYPE_MASK) {
         case MOD_INFO_REQ:
+            if (!sr_modinfo_validate_is_affected(mod_info, mod)) {
+                /* valid data not affected by the changes */
+                mod->state &= ~MOD_INFO_VALIDATE;
+                break;
+            }
+
             /* this module will be validated */
+            mod->state |= MOD_INFO_VALIDATE;
             ++valid_mod_count;
 
             if (mod->state & MOD_INFO_CHANGED) {
                 /* check all instids and add their target modules as deps, other inst-ids do not need to be revalidated */
-                if ((err_info = sr_modinfo_add_instid_deps_data(mod_info,
-                        (sr_mod_data_dep_t *)(mod_info->conn->ext_shm.addr + mod->shm_mod->data_deps),
-                        mod->shm_mod->data_dep_count, mod_info->data, sid, 0, cb_error_info))) {
+                if ((err_info = sr_modinfo_add_instid_deps_changed(mod_info, i, sid, cb_error_info))) {
                     goto cleanup;
                 }
             }
             break;
         case MOD_INFO_INV_DEP:
+            if (!sr_modinfo_validate_is_affected(mod_info, mod)) {
+                /* none of this module reference targets were changed */
+                mod->state &= ~MOD_INFO_VALIDATE;
+                break;
+            }
+
             /* this module reference targets could have been changed, needs to be validated */
+            mod->state |= MOD_INFO_VALIDATE;
             ++valid_mod_count;
-            /* fallthrough */
+            break;
         case MOD_INFO_DEP:
             /* this module will not be validated */
+            mod->state &= ~MOD_INFO_VALIDATE;
             break;
         default:
             SR_CHECK_INT_GOTO(0, err_info, cleanup);
         }
     }
 
+    if (!valid_mod_count) {
+        /* nothing was changed, all the data are still valid */
+        goto cleanup;
+    }
+
     /* create an array of all the modules that will be validated */
     valid_mods = malloc(valid_mod_count * sizeof *valid_mods);
     SR_CHECK_MEM_GOTO(!valid_mods, err_info, cleanup);
     for (i = 0, j = 0; i < mod_info->mod_count; ++i) {
         mod = &mod_info->mods[i];
-        switch (mod->state & MOD_INFO_TYPE_MASK) {
-        case MOD_INFO_REQ:
-        case MOD_INFO_INV_DEP:
+        if (mod->state & MOD_INFO_VALIDATE) {
             valid_mods[j] = mod->ly_mod;
             ++j;
-            break;
-        case MOD_INFO_DEP:
-            /* is not validated */
-            break;
         }
     }
     assert(j == valid_mod_count);
 
-    /* validate */
     flags = LYD_OPT_CONFIG | LYD_OPT_WHENAUTODEL | LYD_OPT_VAL_DIFF;
+
+    if ((SR_VALID_THREAD_MAX > 1) && (valid_mod_count > 1)
+            && sr_modinfo_data_has_nodes(mod_info->data, SR_VALID_PARALLEL_MIN_NODES)) {
+        /* enough data to be worth it, try to split the modules into independent groups */
+        if ((err_info = sr_modinfo_validate_groups(mod_info, &comp, &groups, &group_count))) {
+            goto cleanup;
+        }
+    }
+
+    if (group_count > 1) {
+        /* validate the groups in parallel */
+        if ((err_info = sr_modinfo_validate_parallel(mod_info, comp, groups, group_count, flags))) {
+            SR_ERRINFO_VALID(&err_info);
+            goto cleanup;
+        }
+
+        if (finish_diff) {
+            /* merge the changes made by the validation into our diff */
+            for (i = 0; i < group_count; ++i) {
+                if ((err_info = sr_modinfo_ly_val_diff_merge(mod_info, groups[i].diff))) {
+                    goto cleanup;
+                }
+            }
+        }
+        goto cleanup;
+    }
+
+    /* validate */
     if (lyd_validate_modules(&mod_info->data, valid_mods, valid_mod_count, flags, &diff)) {
         sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx);
         SR_ERRINFO_VALID(&err_info);
@@ -1372,6 +3170,12 @@ sr_modinfo_validate(struct sr_mod_info_s *mod_info, int finish_diff, sr_sid_t *s
     /* success */
 
 cleanup:
+    for (i = 0; i < group_count; ++i) {
+        lyd_free_val_diff(groups[i].diff);
+        free(groups[i].valid_mods);
+    }
+    free(groups);
+    free(comp);
     lyd_free_val_diff(diff);
     free(valid_mods);
     return err_info;
@@ -1409,7 +3213,8 @@ sr_modinfo_add_defaults(struct sr_mod_info_s *mod_info, int finish_diff)
         }
     }
 
-    /* just add default values and generate diff */
+    /* just add default values and generate diff, the default cache cannot be used because the defaults depend
+     * on the edited data and the validation diff of the created defaults is merged into our diff */
     flags = (mod_info->ds == SR_DS_OPERATIONAL ? LYD_OPT_DATA : LYD_OPT_CONFIG) | LYD_OPT_TRUSTED | LYD_OPT_VAL_DIFF;
     if (lyd_validate_modules(&mod_info->data, valid_mods, valid_mod_count, flags, &diff)) {
         sr_errinfo_new_ly(&err_info, mod_info->conn->ly_ctx);
@@ -1453,8 +3258,13 @@ sr_modinfo_op_validate(struct sr_mod_info_s *mod_info, struct lyd_node *op, sr_m
         mod = &mod_info->mods[i];
         switch (mod->state & MOD_INFO_TYPE_MASK) {
         case MOD_INFO_REQ:
-            /* this is the module of the nested operation and we need to check that operation's parent data node exists */
-            assert((mod->ly_mod == lyd_node_module(top_op)) && lys_parent(op->schema) && op->parent);
+            /* this is the module of a nested operation and we need to check that operation's parent data node exists */
+            assert(mod->ly_mod == lyd_node_module(top_op));
+            if (!lys_parent(op->schema)) {
+                /* top-level operation validated together with some nested ones */
+                break;
+            }
+            assert(op->parent);
             parent_xpath = lyd_path(op->parent);
             SR_CHECK_MEM_GOTO(!parent_xpath, err_info, cleanup);
 
@@ -1762,8 +3572,8 @@ sr_modinfo_generate_config_change_notif(struct sr_mod_info_s *mod_info, sr_sessi
     tmp_err_info = sr_replay_store(session, notif, notif_ts);
 
     /* send the notification (non-validated, if everything works correctly it must be valid) */
-    if (notif_sub_count && (err_info = sr_shmsub_notif_notify(notif, notif_ts, session->sid, (uint32_t *)notif_subs,
-            notif_sub_count))) {
+    if (notif_sub_count && (err_info = sr_shmsub_notif_notify(&notif, 1, notif_ts, session->sid,
+            (uint32_t *)notif_subs, notif_sub_count))) {
         goto cleanup;
     }
 
@@ -1789,7 +3599,7 @@ sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
     sr_error_info_t *err_info = NULL, *tmp_err_info = NULL;
     struct sr_mod_info_mod_s *mod;
     struct lyd_node *mod_data, *diff = NULL;
-    uint32_t i;
+    uint32_t i, oper_ver;
     int change, create_flags;
 
     assert(!mod_info->data_cached);
@@ -1805,20 +3615,25 @@ sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
         mod = &mod_info->mods[i];
         if (mod->state & MOD_INFO_CHANGED) {
             if (mod_info->ds == SR_DS_OPERATIONAL) {
-                /* load current diff and merge it with the new diff */
-                if ((err_info = sr_module_file_data_append(mod->ly_mod, SR_DS_OPERATIONAL, &diff))) {
+                /* get current diff (cached, if possible) and merge the new diff into it */
+                if ((err_info = sr_oper_diff_cache_take(mod_info->conn, mod->ly_mod, mod->shm_mod, &diff, &oper_ver))) {
                     goto cleanup;
                 }
                 if ((err_info = sr_diff_mod_merge(mod_info->diff, mod_info->conn, mod->ly_mod, &diff, &change))) {
                     goto cleanup;
                 }
 
-                /* store the new diff */
-                if (change && (err_info = sr_module_file_data_set(mod->ly_mod->name, SR_DS_OPERATIONAL, diff, 0, 0))) {
-                    goto cleanup;
+                if (change) {
+                    /* store the new diff */
+                    if ((err_info = sr_oper_diff_store(mod_info->conn, mod, &diff))) {
+                        goto cleanup;
+                    }
+                } else {
+                    /* unchanged, just cache it back */
+                    if ((err_info = sr_oper_diff_cache_put(mod_info->conn, mod->ly_mod, oper_ver, &diff))) {
+                        goto cleanup;
+                    }
                 }
-                lyd_free_withsiblings(diff);
-                diff = NULL;
             } else {
                 /* separate data of this module */
                 mod_data = sr_module_data_unlink(&mod_info->data, mod->ly_mod);
@@ -1832,6 +3647,16 @@ sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
                     /* update module running data version */
                     ++mod->shm_mod->ver;
 
+                    if (mod->instid_trgs) {
+                        /* remember the instance-identifier targets of the new data */
+                        tmp_err_info = sr_instid_cache_put(mod_info->conn, mod->ly_mod, mod->shm_mod->ver,
+                                &mod->instid_trgs);
+                        if (tmp_err_info) {
+                            /* just a cache, not critical */
+                            sr_errinfo_free(&tmp_err_info);
+                        }
+                    }
+
                     if (mod_info->conn->opts & SR_CONN_CACHE_RUNNING) {
                         /* we are caching so update cache with these data,
                          * HACK data are simply removed from mod_info because they are no longer
@@ -1852,19 +3677,18 @@ sr_modinfo_data_store(struct sr_mod_info_s *mod_info)
                     mod_info->data = mod_data;
                 }
 
-                if (mod_info->ds == SR_DS_RUNNING) {
-                    /* update diffs of stored operational data, if any */
-                    if ((err_info = sr_module_file_data_append(mod->ly_mod, SR_DS_OPERATIONAL, &diff))) {
+                if ((mod_info->ds == SR_DS_RUNNING) && (!mod_info->diff
+                        || (sr_diff_mod_subtrees(mod_info->diff, mod->ly_mod) & ATOMIC_LOAD_RELAXED(mod->shm_mod->oper_subtrees)))) {
+                    /* update diffs of stored operational data that may be affected by the changed subtrees */
+                    if ((err_info = sr_oper_diff_cache_take(mod_info->conn, mod->ly_mod, mod->shm_mod, &diff, &oper_ver))) {
                         goto cleanup;
                     }
                     if ((err_info = sr_diff_mod_update(&diff, mod->ly_mod, mod_data))) {
                         goto cleanup;
                     }
-                    if ((err_info = sr_module_file_data_set(mod->ly_mod->name, SR_DS_OPERATIONAL, diff, 0, 0))) {
+                    if ((err_info = sr_oper_diff_store(mod_info->conn, mod, &diff))) {
                         goto cleanup;
                     }
-                    lyd_free_withsiblings(diff);
-                    diff = NULL;
                 }
             }
         }
@@ -1908,6 +3732,8 @@ sr_modinfo_candidate_reset(struct sr_mod_info_s *mod_info)
 void
 sr_modinfo_free(struct sr_mod_info_s *mod_info)
 {
+    uint32_t i;
+
     lyd_free_withsiblings(mod_info->diff);
     if (mod_info->data_cached) {
         mod_info->data_cached = 0;
@@ -1918,5 +3744,8 @@ sr_modinfo_free(struct sr_mod_info_s *mod_info)
         lyd_free_withsiblings(mod_info->data);
     }
 
+    for (i = 0; i < mod_info->mod_count; ++i) {
+        ly_set_free(mod_info->mods[i].instid_trgs);
+    }
     free(mod_info->mods);
 }
@@ -34,6 +34,16 @@
 #define MOD_INFO_RLOCK   0x08 /* read-locked module */
 #define MOD_INFO_WLOCK   0x10 /* write-locked module */
 #define MOD_INFO_CHANGED 0x20 /* module data were changed */
+#define MOD_INFO_VALIDATE 0x40 /* module data will be validated */
+
+/**
+ * @brief Page of list or leaf-list instances requested from operational data providers.
+ */
+struct sr_oper_page_s {
+    const struct lys_node *snode;   /**< Schema node of the paged instances, NULL if no page is requested. */
+    const char *after_path;         /**< Path of the instance the page follows, NULL for the first page. */
+    uint32_t count;                 /**< Number of the instances required (following @p after_path). */
+};
 
 /**
  * @brief Mod info structure, used for keeping all relevant modules for a data operation.
@@ -44,6 +54,7 @@ struct sr_mod_info_s {
     struct lyd_node *data;      /**< Data tree. */
     int data_cached;            /**< Whether the data are actually in cache (conn cache READ lock is held). */
     sr_conn_ctx_t *conn;        /**< Associated connection. */
+    struct sr_oper_page_s oper_page;    /**< Page of the requested operational data, passed to the providers. */
 
     struct sr_mod_info_mod_s {
         sr_mod_t *shm_mod;      /**< Module SHM structure. */
@@ -51,6 +62,8 @@ struct sr_mod_info_s {
         const struct lys_module *ly_mod;    /**< Module libyang structure. */
 
         uint32_t request_id;    /**< Request ID of the published event. */
+        struct ly_set *instid_trgs; /**< Modules (const struct lys_module *) that may be targeted by
+                                     instance-identifiers in the changed running data, if learned. */
     } *mods;                    /**< Relevant modules. */
     uint32_t mod_count;         /**< Modules count. */
 };
@@ -132,6 +145,9 @@ sr_error_info_t *sr_modinfo_validate(struct sr_mod_info_s *mod_info, int finish_
 /**
  * @brief Add default values into data for modules in mod info.
  *
+ * Defaults are always created by libyang validation, not duplicated from the default data cache,
+ * so that they reflect the modified data and can be added into the diff.
+ *
  * @param[in] mod_info Mod info to use.
  * @param[in] finish_diff Whether to update diff with possible changes of default values.
  * @return err_info, NULL on success.
@@ -215,4 +231,39 @@ sr_error_info_t *sr_modinfo_candidate_reset(struct sr_mod_info_s *mod_info);
  */
 void sr_modinfo_free(struct sr_mod_info_s *mod_info);
 
+/**
+ * @brief Free the operational data cache of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_oper_cache_free(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Free the stored operational diff cache of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_oper_diff_cache_free(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Free the instance-identifier target cache of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_instid_cache_free(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Stop the validation worker threads of a connection and free the pool.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_valid_pool_free(sr_conn_ctx_t *conn);
+
+/**
+ * @brief Free the default data cache of a connection.
+ *
+ * @param[in] conn Connection to use.
+ */
+void sr_conn_dflt_cache_free(sr_conn_ctx_t *conn);
+
 #endif
@@ -265,7 +265,7 @@ cleanup:
 }
 
 /**
- * @brief Write notification into fd using vector IO.
+ * @brief Write notification into fd using vector IO. The file is not synchronized.
  *
  * @param[in] notif_lyb Notification in LYB format.
  * @param[in] notif_lyb_len Length of notification in LYB format.
@@ -275,7 +275,6 @@ cleanup:
 static sr_error_info_t *
 sr_writev_notif(int fd, const char *notif_lyb, uint32_t notif_lyb_len, time_t notif_ts)
 {
-    sr_error_info_t *err_info = NULL;
     struct iovec iov[3];
 
     /* timestamp */
@@ -290,18 +289,8 @@ sr_writev_notif(int fd, const char *notif_lyb, uint32_t notif_lyb_len, time_t no
     iov[2].iov_base = (void *)notif_lyb;
     iov[2].iov_len = notif_lyb_len;
 
-    /* write the vector */
-    if ((err_info = sr_writev(fd, iov, 3))) {
-        return err_info;
-    }
-
-    /* fsync */
-    if (fsync(fd) == -1) {
-        SR_ERRINFO_SYSERRNO(&err_info, "fsync");
-        return err_info;
-    }
-
-    return NULL;
+    /* write the vector, the caller synchronizes the file */
+    return sr_writev(fd, iov, 3);
 }
 
 /**
@@ -353,25 +342,26 @@ cleanup:
 }
 
 /**
- * @brief Store the notification into a replay file.
+ * @brief Store notifications into replay files.
  *
  * @param[in] ly_mod Notification module.
  * @param[in] shm_mod Notification SHM module.
- * @param[in] notif_lyb Notification in LYB format, is spent!
+ * @param[in] notif_lybs Notifications in LYB format, are spent!
+ * @param[in] notif_count Count of @p notif_lybs.
  * @param[in] notif_ts Notification timestamp.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
-sr_notif_write(const struct lys_module *ly_mod, sr_mod_t *shm_mod, char *notif_lyb, time_t notif_ts)
+sr_notif_write(const struct lys_module *ly_mod, sr_mod_t *shm_mod, char **notif_lybs, uint32_t notif_count,
+        time_t notif_ts)
 {
     sr_error_info_t *err_info = NULL;
     time_t from_ts, to_ts;
-    size_t file_size;
+    size_t file_size = 0;
     int notif_lyb_len, fd = -1;
+    uint32_t i = 0;
 
-    /* learn its length */
-    notif_lyb_len = lyd_lyb_data_length(notif_lyb);
-    SR_CHECK_INT_GOTO(notif_lyb_len == -1, err_info, cleanup);
+    assert(notif_count);
 
     /* REPLAY WRITE LOCK */
     if ((err_info = sr_rwlock(&shm_mod->replay_lock, SR_MOD_LOCK_TIMEOUT, SR_LOCK_WRITE, __func__))) {
@@ -393,34 +383,54 @@ sr_notif_write(const struct lys_module *ly_mod, sr_mod_t *shm_mod, char *notif_l
         if ((err_info = sr_file_get_size(fd, &file_size))) {
             goto cleanup_unlock;
         }
+    }
 
-        if (file_size + sizeof notif_ts + sizeof notif_lyb_len + notif_lyb_len <= SR_EV_NOTIF_FILE_MAX_SIZE * 1024) {
-            /* add the notification into the file if there is still space */
-            if ((err_info = sr_writev_notif(fd, notif_lyb, notif_lyb_len, notif_ts))) {
+    while (i < notif_count) {
+        /* learn its length */
+        notif_lyb_len = lyd_lyb_data_length(notif_lybs[i]);
+        SR_CHECK_INT_GOTO(notif_lyb_len == -1, err_info, cleanup_unlock);
+
+        if ((fd > -1) && (file_size + sizeof notif_ts + sizeof notif_lyb_len + notif_lyb_len > SR_EV_NOTIF_FILE_MAX_SIZE * 1024)) {
+            /* the file is full, finish it */
+            if (fsync(fd) == -1) {
+                SR_ERRINFO_SYSERRNO(&err_info, "fsync");
+                goto cleanup_unlock;
+            }
+            if ((to_ts != notif_ts) && (err_info = sr_replay_rename_file(ly_mod->name, from_ts, to_ts, notif_ts))) {
                 goto cleanup_unlock;
             }
 
-            /* update notification file name */
-            if ((err_info = sr_replay_rename_file(ly_mod->name, from_ts, to_ts, notif_ts))) {
+            /* we will create a new file, close this one */
+            close(fd);
+            fd = -1;
+        }
+
+        if (fd == -1) {
+            /* creating a new file */
+            if ((err_info = sr_replay_open_file(ly_mod->name, notif_ts, notif_ts, O_WRONLY | O_APPEND | O_CREAT | O_EXCL, &fd))) {
                 goto cleanup_unlock;
             }
+            from_ts = notif_ts;
+            to_ts = notif_ts;
+            file_size = 0;
+        }
 
-            /* we are done */
+        /* add the notification into the file */
+        if ((err_info = sr_writev_notif(fd, notif_lybs[i], notif_lyb_len, notif_ts))) {
             goto cleanup_unlock;
         }
-
-        /* we will create a new file, close this one */
-        close(fd);
-        fd = -1;
+        file_size += sizeof notif_ts + sizeof notif_lyb_len + notif_lyb_len;
+        ++i;
     }
 
-    /* creating a new file */
-    if ((err_info = sr_replay_open_file(ly_mod->name, notif_ts, notif_ts, O_WRONLY | O_APPEND | O_CREAT | O_EXCL, &fd))) {
+    /* synchronize all the notifications at once */
+    if (fsync(fd) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "fsync");
         goto cleanup_unlock;
     }
 
-    /* write the notification */
-    if ((err_info = sr_writev_notif(fd, notif_lyb, notif_lyb_len, notif_ts))) {
+    /* update notification file name */
+    if ((to_ts != notif_ts) && (err_info = sr_replay_rename_file(ly_mod->name, from_ts, to_ts, notif_ts))) {
         goto cleanup_unlock;
     }
 
@@ -433,7 +443,9 @@ cleanup:
     if (fd > -1) {
         close(fd);
     }
-    free(notif_lyb);
+    for (i = 0; i < notif_count; ++i) {
+        free(notif_lybs[i]);
+    }
     return err_info;
 }
 
@@ -503,21 +515,23 @@ error:
 
 sr_error_info_t *
 sr_replay_store(sr_session_ctx_t *sess, const struct lyd_node *notif, time_t notif_ts)
+{
+    return sr_replay_store_batch(sess, &notif, 1, notif_ts);
+}
+
+sr_error_info_t *
+sr_replay_store_batch(sr_session_ctx_t *sess, const struct lyd_node **notifs, uint32_t notif_count, time_t notif_ts)
 {
     sr_error_info_t *err_info = NULL;
     sr_mod_t *shm_mod;
-    char *notif_lyb;
+    char **notif_lybs = NULL;
     const struct lys_module *ly_mod;
     struct lyd_node *notif_op;
+    uint32_t i, lyb_count = 0;
 
-    assert(notif && !notif->parent);
+    assert(notif_count && !notifs[0]->parent);
 
-    ly_mod = lyd_node_module(notif);
-    notif_op = (struct lyd_node *)notif;
-    if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
-        return err_info;
-    }
-    SR_CHECK_INT_RET(notif_op->schema->nodetype != LYS_NOTIF, err_info);
+    ly_mod = lyd_node_module(notifs[0]);
 
     /* find SHM mod for replay lock and check if replay is even supported */
     shm_mod = sr_shmmain_find_module(&sess->conn->main_shm, sess->conn->ext_shm.addr, ly_mod->name, 0);
@@ -528,28 +542,52 @@ sr_replay_store(sr_session_ctx_t *sess, const struct lyd_node *notif, time_t not
         return NULL;
     }
 
-    /* convert notification into LYB */
-    if (lyd_print_mem(&notif_lyb, notif, LYD_LYB, LYP_WITHSIBLINGS)) {
-        sr_errinfo_new_ly(&err_info, ly_mod->ctx);
-        return err_info;
+    notif_lybs = malloc(notif_count * sizeof *notif_lybs);
+    SR_CHECK_MEM_RET(!notif_lybs, err_info);
+
+    for (i = 0; i < notif_count; ++i) {
+        assert(!notifs[i]->parent && (lyd_node_module(notifs[i]) == ly_mod));
+
+        notif_op = (struct lyd_node *)notifs[i];
+        if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+            goto cleanup;
+        }
+        SR_CHECK_INT_GOTO(notif_op->schema->nodetype != LYS_NOTIF, err_info, cleanup);
+
+        /* convert notification into LYB */
+        if (lyd_print_mem(&notif_lybs[i], notifs[i], LYD_LYB, LYP_WITHSIBLINGS)) {
+            sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+            goto cleanup;
+        }
+        ++lyb_count;
     }
 
-    /* notif_lyb is always spent! */
+    /* notif_lybs are always spent! */
     if (sess->notif_buf.tid) {
-        /* store the notification in the buffer */
-        if ((err_info = sr_notif_buf_store(&sess->notif_buf, ly_mod, notif_lyb, notif_ts))) {
-            return err_info;
+        /* store the notifications in the buffer */
+        for (i = 0; i < notif_count; ++i) {
+            err_info = sr_notif_buf_store(&sess->notif_buf, ly_mod, notif_lybs[i], notif_ts);
+            notif_lybs[i] = NULL;
+            if (err_info) {
+                goto cleanup;
+            }
         }
-        SR_LOG_INF("Notification \"%s\" buffered to be stored for replay.", notif_op->schema->name);
+        SR_LOG_INF("%u \"%s\" notification(s) buffered to be stored for replay.", notif_count, ly_mod->name);
     } else {
-        /* write the notification to a replay file */
-        if ((err_info = sr_notif_write(ly_mod, shm_mod, notif_lyb, notif_ts))) {
-            return err_info;
+        /* write the notifications to replay files */
+        lyb_count = 0;
+        if ((err_info = sr_notif_write(ly_mod, shm_mod, notif_lybs, notif_count, notif_ts))) {
+            goto cleanup;
         }
-        SR_LOG_INF("Notification \"%s\" stored for replay.", notif_op->schema->name);
+        SR_LOG_INF("%u \"%s\" notification(s) stored for replay.", notif_count, ly_mod->name);
     }
 
-    return NULL;
+cleanup:
+    for (i = 0; i < lyb_count; ++i) {
+        free(notif_lybs[i]);
+    }
+    free(notif_lybs);
+    return err_info;
 }
 
 void *
@@ -603,7 +641,7 @@ sr_notif_buf_thread(void *arg)
             }
 
             /* store the notification, continue normally on error (notif_lyb is spent!) */
-            err_info = sr_notif_write(first->notif_mod, shm_mod, first->notif_lyb, first->notif_ts);
+            err_info = sr_notif_write(first->notif_mod, shm_mod, &first->notif_lyb, 1, first->notif_ts);
             sr_errinfo_free(&err_info);
 
             /* next iter */
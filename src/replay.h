@@ -54,6 +54,18 @@ sr_error_info_t *sr_replay_find_file(const char *mod_name, time_t from_ts, time_
  */
 sr_error_info_t *sr_replay_store(sr_session_ctx_t *sess, const struct lyd_node *notif, time_t notif_ts);
 
+/**
+ * @brief Store several notifications of a single module for replay at once.
+ *
+ * @param[in] sess Session to use.
+ * @param[in] notifs Notifications to store.
+ * @param[in] notif_count Count of @p notifs.
+ * @param[in] notif_ts Notification timestamp to store.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_replay_store_batch(sr_session_ctx_t *sess, const struct lyd_node **notifs, uint32_t notif_count,
+        time_t notif_ts);
+
 /**
  * @brief Notification buffer thread.
  *
@@ -109,7 +109,10 @@ typedef enum sr_mod_oper_sub_type_e {
 typedef struct sr_mod_oper_sub_s {
     off_t xpath;                /**< XPath of the subscription. */
     sr_mod_oper_sub_type_t sub_type;  /**< Type of the subscription. */
+    int opts;                   /**< Subscription options. */
     uint32_t evpipe_num;        /** Event pipe number. */
+    ATOMIC_T cache_ttl_ms;      /**< Validity period of the provided data in milliseconds, 0 if not cached. */
+    ATOMIC_T cache_ver;         /**< Version of the provided data, changed to invalidate any cached data. */
 } sr_mod_oper_sub_t;
 
 /**
@@ -136,6 +139,9 @@ struct sr_mod_s {
     } data_lock_info[SR_DS_COUNT]; /**< Module data lock information for each datastore. */
     sr_rwlock_t replay_lock;    /**< Process-shared lock for accessing stored notifications for replay. */
     uint32_t ver;               /**< Module data version (non-zero). */
+    ATOMIC_T oper_ver;          /**< Module stored operational data version (non-zero), changed on every update. */
+    ATOMIC_T oper_subtrees;     /**< Summary of top-level subtrees with stored operational data, one bit per node
+                                     name hash (see ::sr_diff_mod_subtrees()), all bits set if unknown. */
 
     off_t name;                 /**< Module name. */
     char rev[11];               /**< Module revision. */
@@ -286,6 +292,16 @@ typedef struct sr_multi_sub_shm_s {
     uint32_t priority;          /**< Priority of the subscriber. */
     uint32_t subscriber_count;  /**< Number of subscribers to process this event. */
 } sr_multi_sub_shm_t;
+
+/**
+ * @brief Operational request sent to a subscriber and not finished yet.
+ */
+typedef struct sr_shmsub_oper_req_s {
+    const struct lys_module *ly_mod;    /**< Module of the requested data. */
+    sr_shm_t shm_sub;           /**< Mapped subscription SHM. */
+    uint32_t request_id;        /**< Request ID. */
+    struct timespec timeout_ts; /**< Absolute timeout of the request. */
+} sr_shmsub_oper_req_t;
 /*
  * change data subscription SHM (multi)
  *
@@ -312,7 +328,8 @@ typedef struct sr_multi_sub_shm_s {
  *
  * FOR SUBSCRIBER
  * followed by:
- * event SR_SUB_EV_OPER - char *request_xpath; char *parent_lyb - existing data tree parent
+ * event SR_SUB_EV_OPER - char *request_xpath; uint32_t page_count; char *page_after - requested page, if count
+ *                        is non-zero; char *parent_lyb - existing data tree parent
  *
  * FOR ORIGINATOR
  * followed by:
@@ -627,6 +644,44 @@ sr_error_info_t *sr_shmmain_check_data_files(sr_conn_ctx_t *conn);
 sr_error_info_t *sr_shmmod_collect_edit(sr_conn_ctx_t *conn, const struct lyd_node *edit, sr_datastore_t ds,
         struct sr_mod_info_s *mod_info);
 
+/**
+ * @brief Learn modules with data selected by an XPath.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath XPath to be evaluated.
+ * @param[in,out] conv_mods Optional set to add modules (const struct lys_module *) with selected data
+ * in conventional datastores to.
+ * @param[in,out] oper_mods Optional set to add modules with selected data in operational datastore to.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_xpath_modules(sr_conn_ctx_t *conn, const char *xpath, struct ly_set *conv_mods,
+        struct ly_set *oper_mods);
+
+/**
+ * @brief Collect required modules into mod info based on modules learned by ::sr_shmmod_xpath_modules().
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mods Modules with selected data.
+ * @param[in] ds Datastore.
+ * @param[in,out] mod_info Modified mod info.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_collect_xpath_modules(sr_conn_ctx_t *conn, const struct ly_set *mods, sr_datastore_t ds,
+        struct sr_mod_info_s *mod_info);
+
+/**
+ * @brief Collect required modules into mod info that were already resolved by ::sr_shmmod_collect_xpath_modules().
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mods Resolved modules with all their dependencies, sorted.
+ * @param[in] mod_count Count of @p mods.
+ * @param[in] ds Datastore.
+ * @param[in,out] mod_info Empty mod info to fill.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmmod_collect_resolved(sr_conn_ctx_t *conn, const struct sr_mod_info_mod_s *mods, uint32_t mod_count,
+        sr_datastore_t ds, struct sr_mod_info_s *mod_info);
+
 /**
  * @brief Collect required modules into mod info based on an XPath.
  *
@@ -772,11 +827,12 @@ sr_error_info_t *sr_shmmod_change_subscription_stop(sr_conn_ctx_t *conn, sr_mod_
  * @param[in] shm_mod SHM module.
  * @param[in] xpath Subscription XPath.
  * @param[in] sub_type Data-provide subscription type.
+ * @param[in] sub_opts Subscription options.
  * @param[in] evpipe_num Subscription event pipe number.
  * @return err_info, NULL on success.
  */
 sr_error_info_t *sr_shmmod_oper_subscription_add(sr_shm_t *shm_ext, sr_mod_t *shm_mod, const char *xpath,
-        sr_mod_oper_sub_type_t sub_type, uint32_t evpipe_num);
+        sr_mod_oper_sub_type_t sub_type, int sub_opts, uint32_t evpipe_num);
 
 /**
  * @brief Remove main SHM module operational subscription.
@@ -787,10 +843,11 @@ sr_error_info_t *sr_shmmod_oper_subscription_add(sr_shm_t *shm_ext, sr_mod_t *sh
  * @param[in] evpipe_num Subscription event pipe number.
  * @param[in] only_evpipe Whether to match only on \p evpipe_num.
  * @param[out] xpath_p Optionally return the xpath of the removed subscription.
+ * @param[out] sub_opts_p Optionally return the options of the removed subscription.
  * @return 0 if removed, 1 if no matching found.
  */
 int sr_shmmod_oper_subscription_del(char *ext_shm_addr, sr_mod_t *shm_mod, const char *xpath, uint32_t evpipe_num,
-        int only_evpipe, const char **xpath_p);
+        int only_evpipe, const char **xpath_p, int *sub_opts_p);
 
 /**
  * @brief Remove main SHM module operational subscription and do a proper cleanup.
@@ -932,21 +989,37 @@ sr_error_info_t *sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_i
 sr_error_info_t *sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, sr_sid_t sid, uint32_t timeout_ms);
 
 /**
- * @brief Notify about (generate) an operational event.
+ * @brief Notify about (generate) an operational event, do not wait for the subscriber.
+ * The request must always be finished by ::sr_shmsub_oper_notify_recv(), no other requests can be sent
+ * to the same subscription request slot until then. A free slot is used if there is any, otherwise
+ * the first slot is waited for.
  *
  * @param[in] ly_mod Module to use.
  * @param[in] xpath Subscription XPath.
  * @param[in] request_xpath Requested XPath.
- * @param[in] parent Existing parent to append the data to.
+ * @param[in] page_after Path of the instance the requested page follows, if any.
+ * @param[in] page_count Number of the requested page instances, 0 if no page is requested.
+ * @param[in] parent Existing parent to append the data to, first of all the parents for batched subscriptions.
  * @param[in] sid Originator sysrepo session ID.
  * @param[in] evpipe_num Subscriber event pipe number.
+ * @param[in] slot_count Number of request slots of the subscription.
  * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[out] req Sent request.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_oper_notify_send(const struct lys_module *ly_mod, const char *xpath, const char *request_xpath,
+        const char *page_after, uint32_t page_count, const struct lyd_node *parent, sr_sid_t sid, uint32_t evpipe_num,
+        uint32_t slot_count, uint32_t timeout_ms, sr_shmsub_oper_req_t *req);
+
+/**
+ * @brief Wait for the subscriber to process an operational event and get the provided data.
+ *
+ * @param[in] req Request sent by ::sr_shmsub_oper_notify_send(), is cleared.
  * @param[out] data Data provided by the subscriber.
  * @param[out] cb_err_info Callback error information generated by a subscriber, if any.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmsub_oper_notify(const struct lys_module *ly_mod, const char *xpath, const char *request_xpath,
-        const struct lyd_node *parent, sr_sid_t sid, uint32_t evpipe_num, uint32_t timeout_ms, struct lyd_node **data,
+sr_error_info_t *sr_shmsub_oper_notify_recv(sr_shmsub_oper_req_t *req, struct lyd_node **data,
         sr_error_info_t **cb_err_info);
 
 /**
@@ -980,16 +1053,17 @@ sr_error_info_t *sr_shmsub_rpc_notify_abort(sr_conn_ctx_t *conn, const char *op_
         sr_sid_t sid, uint32_t request_id);
 
 /**
- * @brief Notify about (generate) a notification event.
+ * @brief Notify about (generate) a notification event with one or more notifications.
  *
- * @param[in] notif Notification data tree.
+ * @param[in] notifs Notification data trees, all of the same module.
+ * @param[in] notif_count Count of @p notifs.
  * @param[in] notif_ts Notification timestamp.
  * @param[in] sid Originator sysrepo session ID.
  * @param[in] notif_sub_evpipe_nums Array of subscribers event pipe numbers.
  * @param[in] notif_sub_count Number of subscribers.
  * @return err_info, NULL on success.
  */
-sr_error_info_t *sr_shmsub_notif_notify(const struct lyd_node *notif, time_t notif_ts, sr_sid_t sid,
+sr_error_info_t *sr_shmsub_notif_notify(struct lyd_node **notifs, uint32_t notif_count, time_t notif_ts, sr_sid_t sid,
         uint32_t *notif_sub_evpipe_nums, uint32_t notif_sub_count);
 
 /**
@@ -1028,6 +1102,42 @@ sr_error_info_t *sr_shmsub_rpc_listen_process_rpc_events(struct opsub_rpc_s *rpc
  */
 sr_error_info_t *sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs, sr_conn_ctx_t *conn);
 
+/**
+ * @brief Check whether there may be a new event for module change subscriptions without locking.
+ * Subscription SHM must not be remapped concurrently.
+ *
+ * @param[in] change_subs Module change subscriptions.
+ * @return 0 if not, non-zero if there may be.
+ */
+int sr_shmsub_change_listen_module_has_event(struct modsub_change_s *change_subs);
+
+/**
+ * @brief Check whether there may be a new event for module operational subscriptions without locking.
+ * Subscription SHM must not be remapped concurrently.
+ *
+ * @param[in] oper_subs Module operational subscriptions.
+ * @return 0 if not, non-zero if there may be.
+ */
+int sr_shmsub_oper_listen_module_has_event(struct modsub_oper_s *oper_subs);
+
+/**
+ * @brief Check whether there may be a new event for RPC/action subscriptions without locking.
+ * Subscription SHM must not be remapped concurrently.
+ *
+ * @param[in] rpc_subs Operation RPC/action subscriptions.
+ * @return 0 if not, non-zero if there may be.
+ */
+int sr_shmsub_rpc_listen_has_event(struct opsub_rpc_s *rpc_subs);
+
+/**
+ * @brief Check whether there may be a new event for module notification subscriptions without locking.
+ * Subscription SHM must not be remapped concurrently.
+ *
+ * @param[in] notif_subs Module notification subscriptions.
+ * @return 0 if not, non-zero if there may be.
+ */
+int sr_shmsub_notif_listen_module_has_event(struct modsub_notif_s *notif_subs);
+
 /**
  * @brief Check whether there is a pending replay or stop time elapsed for a module notification subscription.
  *
@@ -1073,4 +1183,53 @@ sr_error_info_t *sr_shmsub_notif_listen_module_replay(struct modsub_notif_s *not
  */
 void *sr_shmsub_listen_thread(void *arg);
 
+/**
+ * @brief Start worker threads of a subscription structure that will process events of individual
+ * module/operation subscriptions in parallel. Subscriptions must be WRITE-locked.
+ *
+ * @param[in] subs Subscriptions structure without any worker threads.
+ * @param[in] thread_count Number of worker threads to start.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_pool_start(sr_subscription_ctx_t *subs, uint32_t thread_count);
+
+/**
+ * @brief Stop all worker threads of a subscription structure. All the queued tasks are processed first.
+ *
+ * @param[in] subs Subscriptions structure.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_pool_stop(sr_subscription_ctx_t *subs);
+
+/**
+ * @brief Queue a new task for the worker threads, if there is not one for the subscriptions already.
+ * Subscriptions must be READ-locked, the task holds its own READ lock until it is processed.
+ *
+ * @param[in] subs Subscriptions structure with worker threads.
+ * @param[in] type Type of the subscriptions.
+ * @param[in] sub Module/operation subscriptions or a single operational subscription to process.
+ * @param[in] mod_sub Operational subscriptions of the module of @p sub, NULL for other types.
+ * @param[in] slot Request slot index of the operational subscription @p sub to process, 0 for other types.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_pool_add_task(sr_subscription_ctx_t *subs, sr_subs_task_type_t type, void *sub, void *mod_sub,
+        uint32_t slot);
+
+/**
+ * @brief Wait until the worker threads of a subscription structure process all their tasks.
+ * Subscriptions must not be locked.
+ *
+ * @param[in] subs Subscriptions structure.
+ * @return err_info, NULL on success.
+ */
+sr_error_info_t *sr_shmsub_pool_wait(sr_subscription_ctx_t *subs);
+
+/**
+ * @brief Worker thread of a subscription structure.
+ *
+ * @param[in] arg Pointer to the subscription structure.
+ * @return Always NULL.
+ */
+void *sr_shmsub_worker_thread(void *arg);
+
 #endif
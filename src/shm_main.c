@@ -1426,6 +1426,9 @@ sr_shmmain_add_modules(char *ext_shm_addr, struct lyd_node *first_sr_mod, sr_mod
             return err_info;
         }
         first_shm_mod->ver = 1;
+        ATOMIC_STORE_RELAXED(first_shm_mod->oper_ver, 1);
+        /* there may be stored operational data from before */
+        ATOMIC_STORE_RELAXED(first_shm_mod->oper_subtrees, UINT32_MAX);
 
         /* set all arrays and pointers to ext SHM */
         LY_TREE_FOR(first_sr_mod->child, sr_child) {
@@ -156,9 +156,8 @@ sr_shmmod_collect_edit(sr_conn_ctx_t *conn, const struct lyd_node *edit, sr_data
 }
 
 sr_error_info_t *
-sr_shmmod_collect_xpath(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t ds, struct sr_mod_info_s *mod_info)
+sr_shmmod_xpath_modules(sr_conn_ctx_t *conn, const char *xpath, struct ly_set *conv_mods, struct ly_set *oper_mods)
 {
-    sr_mod_t *shm_mod;
     char *module_name;
     const struct lys_module *ly_mod;
     const struct lys_node *ctx_node;
@@ -166,9 +165,6 @@ sr_shmmod_collect_xpath(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t d
     sr_error_info_t *err_info = NULL;
     uint32_t i;
 
-    mod_info->ds = ds;
-    mod_info->conn = conn;
-
     /* get the module */
     module_name = sr_get_first_ns(xpath);
     if (!module_name) {
@@ -198,41 +194,114 @@ sr_shmmod_collect_xpath(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t d
         return err_info;
     }
 
-    /* add all the other modules */
-    ly_mod = NULL;
+    /* learn all the modules */
     for (i = 0; i < set->number; ++i) {
         /* skip uninteresting nodes */
-        if ((set->set.s[i]->nodetype & (LYS_RPC | LYS_NOTIF))
-                || ((set->set.s[i]->flags & LYS_CONFIG_R) && SR_IS_CONVENTIONAL_DS(ds))) {
+        if (set->set.s[i]->nodetype & (LYS_RPC | LYS_NOTIF)) {
             continue;
         }
 
-        if (lys_node_module(set->set.s[i]) == ly_mod) {
-            /* skip already-added modules */
-            continue;
-        }
         ly_mod = lys_node_module(set->set.s[i]);
-
         if (!ly_mod->implemented || !strcmp(ly_mod->name, SR_YANG_MOD) || !strcmp(ly_mod->name, "ietf-netconf")) {
             /* skip import-only modules, the internal sysrepo module, and ietf-netconf (as it has no data, only in libyang) */
             continue;
         }
 
+        /* state data are not in conventional datastores */
+        if (conv_mods && !(set->set.s[i]->flags & LYS_CONFIG_R)
+                && (ly_set_add(conv_mods, (void *)ly_mod, 0) == -1)) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+            goto cleanup;
+        }
+        if (oper_mods && (ly_set_add(oper_mods, (void *)ly_mod, 0) == -1)) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    ly_set_free(set);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmmod_collect_xpath_modules(sr_conn_ctx_t *conn, const struct ly_set *mods, sr_datastore_t ds,
+        struct sr_mod_info_s *mod_info)
+{
+    sr_mod_t *shm_mod;
+    const struct lys_module *ly_mod;
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    mod_info->ds = ds;
+    mod_info->conn = conn;
+
+    /* add all the modules */
+    for (i = 0; i < mods->number; ++i) {
+        ly_mod = (const struct lys_module *)mods->set.g[i];
+
         /* find the module in SHM and add it with any dependencies */
-        shm_mod = sr_shmmain_find_module(&mod_info->conn->main_shm, mod_info->conn->ext_shm.addr, ly_mod->name, 0);
-        SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+        shm_mod = sr_shmmain_find_module(&conn->main_shm, conn->ext_shm.addr, ly_mod->name, 0);
+        SR_CHECK_INT_RET(!shm_mod, err_info);
         if ((err_info = sr_modinfo_add_mod(shm_mod, ly_mod, MOD_INFO_REQ, MOD_INFO_DEP | MOD_INFO_INV_DEP, mod_info))) {
-            goto cleanup;
+            return err_info;
         }
     }
 
     /* sort the modules based on their offsets in the SHM so that we have a uniform order for locking */
     qsort(mod_info->mods, mod_info->mod_count, sizeof *mod_info->mods, sr_modinfo_qsort_cmp);
 
-    /* success */
+    return NULL;
+}
+
+sr_error_info_t *
+sr_shmmod_collect_resolved(sr_conn_ctx_t *conn, const struct sr_mod_info_mod_s *mods, uint32_t mod_count,
+        sr_datastore_t ds, struct sr_mod_info_s *mod_info)
+{
+    sr_error_info_t *err_info = NULL;
+
+    assert(!mod_info->mod_count);
+
+    mod_info->ds = ds;
+    mod_info->conn = conn;
+
+    if (!mod_count) {
+        return NULL;
+    }
+
+    /* just copy the modules, they are already sorted */
+    mod_info->mods = malloc(mod_count * sizeof *mod_info->mods);
+    SR_CHECK_MEM_RET(!mod_info->mods, err_info);
+    memcpy(mod_info->mods, mods, mod_count * sizeof *mod_info->mods);
+    mod_info->mod_count = mod_count;
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_shmmod_collect_xpath(sr_conn_ctx_t *conn, const char *xpath, sr_datastore_t ds, struct sr_mod_info_s *mod_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *mods;
+
+    mods = ly_set_new();
+    SR_CHECK_MEM_RET(!mods, err_info);
+
+    /* learn the modules with selected data */
+    if (SR_IS_CONVENTIONAL_DS(ds)) {
+        err_info = sr_shmmod_xpath_modules(conn, xpath, mods, NULL);
+    } else {
+        err_info = sr_shmmod_xpath_modules(conn, xpath, NULL, mods);
+    }
+    if (err_info) {
+        goto cleanup;
+    }
+
+    /* add them */
+    err_info = sr_shmmod_collect_xpath_modules(conn, mods, ds, mod_info);
 
 cleanup:
-    ly_set_free(set);
+    ly_set_free(mods);
     return err_info;
 }
 
@@ -804,7 +873,7 @@ sr_shmmod_change_subscription_stop(sr_conn_ctx_t *conn, sr_mod_t *shm_mod, const
 
 sr_error_info_t *
 sr_shmmod_oper_subscription_add(sr_shm_t *shm_ext, sr_mod_t *shm_mod, const char *xpath, sr_mod_oper_sub_type_t sub_type,
-        uint32_t evpipe_num)
+        int sub_opts, uint32_t evpipe_num)
 {
     sr_error_info_t *err_info = NULL;
     off_t xpath_off, oper_subs_off;
@@ -865,7 +934,10 @@ sr_shmmod_oper_subscription_add(sr_shm_t *shm_ext, sr_mod_t *shm_mod, const char
         shm_sub->xpath = 0;
     }
     shm_sub->sub_type = sub_type;
+    shm_sub->opts = sub_opts;
     shm_sub->evpipe_num = evpipe_num;
+    ATOMIC_STORE_RELAXED(shm_sub->cache_ttl_ms, 0);
+    ATOMIC_STORE_RELAXED(shm_sub->cache_ver, 0);
 
     ++shm_mod->oper_sub_count;
 
@@ -874,7 +946,7 @@ sr_shmmod_oper_subscription_add(sr_shm_t *shm_ext, sr_mod_t *shm_mod, const char
 
 int
 sr_shmmod_oper_subscription_del(char *ext_shm_addr, sr_mod_t *shm_mod, const char *xpath, uint32_t evpipe_num,
-        int only_evpipe, const char **xpath_p)
+        int only_evpipe, const char **xpath_p, int *sub_opts_p)
 {
     sr_mod_oper_sub_t *shm_sub;
     uint16_t i;
@@ -898,6 +970,9 @@ sr_shmmod_oper_subscription_del(char *ext_shm_addr, sr_mod_t *shm_mod, const cha
     if (xpath_p) {
         *xpath_p = ext_shm_addr + shm_sub[i].xpath;
     }
+    if (sub_opts_p) {
+        *sub_opts_p = shm_sub[i].opts;
+    }
 
     /* add wasted memory */
     *((size_t *)ext_shm_addr) += sizeof *shm_sub + sr_strshmlen(ext_shm_addr + shm_sub[i].xpath);
@@ -922,28 +997,34 @@ sr_shmmod_oper_subscription_stop(char *ext_shm_addr, sr_mod_t *shm_mod, const ch
 {
     sr_error_info_t *err_info = NULL;
     const char *mod_name;
-    char *path;
+    char *path, suffix[SR_OPER_SLOT_SUFFIX_SIZE];
+    uint32_t slot, slot_count;
+    int sub_opts;
 
     mod_name = ext_shm_addr + shm_mod->name;
 
     do {
         /* remove the subscriptions from the main SHM */
-        if (sr_shmmod_oper_subscription_del(ext_shm_addr, shm_mod, xpath, evpipe_num, all_evpipe, &xpath)) {
+        if (sr_shmmod_oper_subscription_del(ext_shm_addr, shm_mod, xpath, evpipe_num, all_evpipe, &xpath, &sub_opts)) {
             if (!all_evpipe) {
                 SR_ERRINFO_INT(&err_info);
             }
             break;
         }
 
-        /* delete the SHM file itself so that there is no leftover event */
-        if ((err_info = sr_path_sub_shm(mod_name, "oper", sr_str_hash(xpath), 0, &path))) {
-            break;
-        }
-        if (shm_unlink(path) == -1) {
-            SR_LOG_WRN("Failed to unlink SHM \"%s\" (%s).", path, strerror(errno));
+        /* delete the SHM files of all the request slots so that there is no leftover event */
+        slot_count = (sub_opts & SR_SUBSCR_OPER_CONCURRENT) ? SR_OPER_SUB_SLOT_COUNT : 1;
+        for (slot = 0; slot < slot_count; ++slot) {
+            sr_oper_slot_suffix(slot, suffix);
+            if ((err_info = sr_path_sub_shm(mod_name, suffix, sr_str_hash(xpath), 0, &path))) {
+                break;
+            }
+            if (shm_unlink(path) == -1) {
+                SR_LOG_WRN("Failed to unlink SHM \"%s\" (%s).", path, strerror(errno));
+            }
+            free(path);
         }
-        free(path);
-    } while (all_evpipe);
+    } while (!err_info && all_evpipe);
 
     return err_info;
 }
@@ -1105,6 +1186,8 @@ sr_shmmod_oper_stored_del_conn(sr_conn_ctx_t *conn, sr_conn_ctx_t *del_conn, pid
             if ((err_info = sr_module_file_data_set(ly_mod->name, SR_DS_OPERATIONAL, diff, 0, 0))) {
                 goto cleanup;
             }
+            ATOMIC_STORE_RELAXED(shm_mod->oper_subtrees, sr_diff_mod_subtrees(diff, ly_mod));
+            ATOMIC_INC_RELAXED(shm_mod->oper_ver);
             lyd_free_withsiblings(diff);
             diff = NULL;
         }
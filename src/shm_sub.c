@@ -338,6 +338,37 @@ sr_shmsub_change_is_valid(sr_sub_event_t ev, sr_subscr_options_t sub_opts)
     return 1;
 }
 
+/**
+ * @brief Whether a change subscription is interested in any changes from a diff.
+ * Must select the same changes as the diff filtering of the subscriber.
+ *
+ * @param[in] ext_shm_addr Ext SHM address.
+ * @param[in] shm_msub SHM change subscription.
+ * @param[in] diff Diff of the event.
+ * @return 0 if not, non-zero if it is.
+ */
+static int
+sr_shmsub_change_filter_is_valid(char *ext_shm_addr, sr_mod_change_sub_t *shm_msub, const struct lyd_node *diff)
+{
+    struct ly_set *set;
+    int valid;
+
+    if (!shm_msub->xpath) {
+        /* subscribed to the whole module */
+        return 1;
+    }
+
+    set = lyd_find_path(diff, ext_shm_addr + shm_msub->xpath);
+    if (!set) {
+        /* notify the subscriber anyway, it will fail to filter the diff and report the error */
+        return 1;
+    }
+
+    valid = set->number ? 1 : 0;
+    ly_set_free(set);
+    return valid;
+}
+
 /**
  * @brief Learn whether there is a subscription for a change event.
  *
@@ -345,12 +376,13 @@ sr_shmsub_change_is_valid(sr_sub_event_t ev, sr_subscr_options_t sub_opts)
  * @param[in] mod Mod info module to use.
  * @param[in] ds Datastore.
  * @param[in] ev Event.
+ * @param[in] diff Diff of the event.
  * @param[out] max_priority_p Highest priority among the valid subscribers.
  * @return 0 if not, non-zero if there is.
  */
 static int
 sr_shmsub_change_notify_has_subscription(char *ext_shm_addr, struct sr_mod_info_mod_s *mod, sr_datastore_t ds,
-        sr_sub_event_t ev, uint32_t *max_priority_p)
+        sr_sub_event_t ev, const struct lyd_node *diff, uint32_t *max_priority_p)
 {
     int has_sub = 0;
     uint32_t i;
@@ -363,6 +395,15 @@ sr_shmsub_change_notify_has_subscription(char *ext_shm_addr, struct sr_mod_info_
             continue;
         }
 
+        /* skip subscriptions whose XPath does not select any changes */
+        if ((shm_msub[i].priority <= *max_priority_p) && has_sub) {
+            /* no need to evaluate the filter, would not change anything */
+            continue;
+        }
+        if (!sr_shmsub_change_filter_is_valid(ext_shm_addr, &shm_msub[i], diff)) {
+            continue;
+        }
+
         /* valid subscription */
         has_sub = 1;
         if (shm_msub[i].priority > *max_priority_p) {
@@ -380,6 +421,7 @@ sr_shmsub_change_notify_has_subscription(char *ext_shm_addr, struct sr_mod_info_
  * @param[in] mod Mod info module to use.
  * @param[in] ds Datastore.
  * @param[in] ev Change event.
+ * @param[in] diff Diff of the event.
  * @param[in] last_priority Last priorty of a subscriber.
  * @param[out] next_priorty_p Next priorty of a subsciber(s).
  * @param[out] sub_count_p Number of subscribers with this priority.
@@ -387,7 +429,8 @@ sr_shmsub_change_notify_has_subscription(char *ext_shm_addr, struct sr_mod_info_
  */
 static void
 sr_shmsub_change_notify_next_subscription(char *ext_shm_addr, struct sr_mod_info_mod_s *mod, sr_datastore_t ds,
-        sr_sub_event_t ev, uint32_t last_priority, uint32_t *next_priority_p, uint32_t *sub_count_p, int *opts_p)
+        sr_sub_event_t ev, const struct lyd_node *diff, uint32_t last_priority, uint32_t *next_priority_p,
+        uint32_t *sub_count_p, int *opts_p)
 {
     uint32_t i;
     sr_mod_change_sub_t *shm_msub;
@@ -402,6 +445,15 @@ sr_shmsub_change_notify_next_subscription(char *ext_shm_addr, struct sr_mod_info
 
         /* valid subscription */
         if (last_priority > shm_msub[i].priority) {
+            if (*sub_count_p && (*next_priority_p > shm_msub[i].priority)) {
+                /* lower priority than the one already found, no need to evaluate the filter */
+                continue;
+            }
+            if (!sr_shmsub_change_filter_is_valid(ext_shm_addr, &shm_msub[i], diff)) {
+                /* not interested in any of the changes */
+                continue;
+            }
+
             /* a subscription that was not notified yet */
             if (*sub_count_p) {
                 if (*next_priority_p < shm_msub[i].priority) {
@@ -471,12 +523,13 @@ cleanup:
  * @param[in] mod Mod info module to use.
  * @param[in] ds Datastore.
  * @param[in] ev Change event.
+ * @param[in] diff Diff of the event.
  * @param[in] priority Priority of the subscribers with new event.
  * @return err_info, NULL on success.
  */
 static sr_error_info_t *
 sr_shmsub_change_notify_evpipe(char *ext_shm_addr, struct sr_mod_info_mod_s *mod, sr_datastore_t ds, sr_sub_event_t ev,
-        uint32_t priority)
+        const struct lyd_node *diff, uint32_t priority)
 {
     sr_error_info_t *err_info = NULL;
     uint32_t i;
@@ -489,7 +542,7 @@ sr_shmsub_change_notify_evpipe(char *ext_shm_addr, struct sr_mod_info_mod_s *mod
         }
 
         /* valid subscription */
-        if (shm_msub[i].priority == priority) {
+        if ((shm_msub[i].priority == priority) && sr_shmsub_change_filter_is_valid(ext_shm_addr, &shm_msub[i], diff)) {
             if ((err_info = sr_shmsub_notify_evpipe(shm_msub[i].evpipe_num))) {
                 return err_info;
             }
@@ -519,7 +572,7 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
     while ((mod = sr_modinfo_next_mod(mod, mod_info, mod_info->diff))) {
         /* just find out whether there are any subscriptions and if so, what is the highest priority */
         if (!sr_shmsub_change_notify_has_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_UPDATE,
-                &cur_priority)) {
+                mod_info->diff, &cur_priority)) {
             continue;
         }
 
@@ -539,7 +592,7 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
 
         /* correctly start the loop, with fake last priority 1 higher than the actual highest */
         sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_UPDATE,
-                cur_priority + 1, &cur_priority, &subscriber_count, NULL);
+                mod_info->diff, cur_priority + 1, &cur_priority, &subscriber_count, NULL);
 
         do {
             /* there cannot be more subscribers on one module with the same priority */
@@ -566,7 +619,7 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
 
             /* notify using event pipe and wait until all the subscribers have processed the event */
             if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn->ext_shm.addr, mod, mod_info->ds,
-                    SR_SUB_EV_UPDATE, cur_priority))) {
+                    SR_SUB_EV_UPDATE, mod_info->diff, cur_priority))) {
                 goto cleanup;
             }
 
@@ -621,7 +674,7 @@ sr_shmsub_change_notify_update(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
 
             /* find out what is the next priority and how many subscribers have it */
             sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_UPDATE,
-                    cur_priority, &cur_priority, &subscriber_count, NULL);
+                    mod_info->diff, cur_priority, &cur_priority, &subscriber_count, NULL);
         } while (subscriber_count);
 
         sr_shm_clear(&shm_sub);
@@ -656,7 +709,8 @@ sr_shmsub_change_notify_clear(struct sr_mod_info_s *mod_info, sr_sub_event_t ev)
         multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
 
         /* just find out whether there are any subscriptions and if so, what is the highest priority */
-        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, ev, &cur_priority)) {
+        if (!sr_shmsub_change_notify_has_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, ev, mod_info->diff,
+                &cur_priority)) {
             /* it is still possible that the subscription unsubscribed already */
 
             /* SUB WRITE LOCK */
@@ -681,7 +735,7 @@ sr_shmsub_change_notify_clear(struct sr_mod_info_s *mod_info, sr_sub_event_t ev)
         }
 
         /* correctly start the loop, with fake last priority 1 higher than the actual highest */
-        sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, ev,
+        sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, ev, mod_info->diff,
                 cur_priority + 1, &cur_priority, &subscriber_count, NULL);
 
         do {
@@ -717,7 +771,7 @@ clear_event:
 
             /* find out what is the next priority and how many subscribers have it */
             sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, ev,
-                    cur_priority, &cur_priority, &subscriber_count, NULL);
+                    mod_info->diff, cur_priority, &cur_priority, &subscriber_count, NULL);
         } while (subscriber_count);
 
         /* this module event succeeded, let us check the next one */
@@ -749,10 +803,10 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
 
     while ((mod = sr_modinfo_next_mod(mod, mod_info, mod_info->diff))) {
         /* just find out whether there are any subscriptions and if so, what is the highest priority */
-        if (!sr_shmsub_change_notify_has_subscription(ext_shm_addr, mod, mod_info->ds, SR_SUB_EV_CHANGE,
+        if (!sr_shmsub_change_notify_has_subscription(ext_shm_addr, mod, mod_info->ds, SR_SUB_EV_CHANGE, mod_info->diff,
                     &cur_priority)) {
             if (!sr_shmsub_change_notify_has_subscription(ext_shm_addr, mod, mod_info->ds, SR_SUB_EV_DONE,
-                    &cur_priority)) {
+                    mod_info->diff, &cur_priority)) {
                 if (mod_info->ds == SR_DS_RUNNING) {
                     SR_LOG_INF("There are no subscribers for changes of the module \"%s\" in %s DS.",
                             mod->ly_mod->name, sr_ds2str(mod_info->ds));
@@ -778,7 +832,7 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
         multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
 
         /* correctly start the loop, with fake last priority 1 higher than the actual highest */
-        sr_shmsub_change_notify_next_subscription(ext_shm_addr, mod, mod_info->ds, SR_SUB_EV_CHANGE,
+        sr_shmsub_change_notify_next_subscription(ext_shm_addr, mod, mod_info->ds, SR_SUB_EV_CHANGE, mod_info->diff,
                 cur_priority + 1, &cur_priority, &subscriber_count, &opts);
 
         do {
@@ -815,7 +869,7 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
 
             /* notify using event pipe and wait until all the subscribers have processed the event */
             if ((err_info = sr_shmsub_change_notify_evpipe(ext_shm_addr, mod, mod_info->ds,
-                    SR_SUB_EV_CHANGE, cur_priority))) {
+                    SR_SUB_EV_CHANGE, mod_info->diff, cur_priority))) {
                 goto cleanup;
             }
 
@@ -836,7 +890,7 @@ sr_shmsub_change_notify_change(struct sr_mod_info_s *mod_info, sr_sid_t sid, uin
             }
 
             /* find out what is the next priority and how many subscribers have it */
-            sr_shmsub_change_notify_next_subscription(ext_shm_addr, mod, mod_info->ds, SR_SUB_EV_CHANGE,
+            sr_shmsub_change_notify_next_subscription(ext_shm_addr, mod, mod_info->ds, SR_SUB_EV_CHANGE, mod_info->diff,
                     cur_priority, &cur_priority, &subscriber_count, &opts);
         } while (subscriber_count);
 
@@ -877,7 +931,7 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, sr_sid_t sid
 
     while ((mod = sr_modinfo_next_mod(mod, mod_info, mod_info->diff))) {
         if (!sr_shmsub_change_notify_has_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_DONE,
-                &cur_priority)) {
+                mod_info->diff, &cur_priority)) {
             /* no subscriptions interested in this event */
             continue;
         }
@@ -900,7 +954,7 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, sr_sid_t sid
 
         /* correctly start the loop, with fake last priority 1 higher than the actual highest */
         sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_DONE,
-                cur_priority + 1, &cur_priority, &subscriber_count, NULL);
+                mod_info->diff, cur_priority + 1, &cur_priority, &subscriber_count, NULL);
 
         do {
             /* SUB WRITE LOCK */
@@ -923,7 +977,7 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, sr_sid_t sid
 
             /* notify using event pipe and do not wait for subscribers */
             if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn->ext_shm.addr, mod, mod_info->ds,
-                    SR_SUB_EV_DONE, cur_priority))) {
+                    SR_SUB_EV_DONE, mod_info->diff, cur_priority))) {
                 goto cleanup_wrunlock;
             }
 
@@ -945,7 +999,7 @@ sr_shmsub_change_notify_change_done(struct sr_mod_info_s *mod_info, sr_sid_t sid
 
             /* find out what is the next priority and how many subscribers have it */
             sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_DONE,
-                    cur_priority, &cur_priority, &subscriber_count, NULL);
+                    mod_info->diff, cur_priority, &cur_priority, &subscriber_count, NULL);
         } while (subscriber_count);
 
         sr_shm_clear(&shm_sub);
@@ -968,13 +1022,15 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, sr_sid_t si
 {
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
     sr_multi_sub_shm_t *multi_sub_shm;
-    struct lyd_node *abort_diff;
+    struct lyd_node *abort_diff = NULL;
     struct sr_mod_info_mod_s *mod = NULL;
     uint32_t cur_priority, err_priority, subscriber_count, err_subscriber_count, diff_lyb_len;
     char *diff_lyb = NULL;
     sr_shm_t shm_sub = SR_SHM_INITIALIZER;
     int last_subscr = 0;
 
+    assert(mod_info->diff);
+
     while ((mod = sr_modinfo_next_mod(mod, mod_info, mod_info->diff))) {
         /* open sub SHM and map it */
         if ((err_info = sr_shmsub_open_map(mod->ly_mod->name, sr_ds2str(mod_info->ds), -1, &shm_sub, sizeof *multi_sub_shm))) {
@@ -982,8 +1038,10 @@ sr_shmsub_change_notify_change_abort(struct sr_mod_info_s *mod_info, sr_sid_t si
         }
         multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
 
+        /* subscriptions are filtered based on the change diff so that exactly those notified about the "change"
+         * event are notified and counted, the same as the subscribers that did not process it */
         if (!sr_shmsub_change_notify_has_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_ABORT,
-                &cur_priority)) {
+                mod_info->diff, &cur_priority)) {
             /* no subscriptions interested in this event, but we still want to clear the event */
 clear_shm:
             /* SUB WRITE LOCK */
@@ -1019,8 +1077,6 @@ clear_shm:
             last_subscr = 1;
         }
 
-        assert(mod_info->diff);
-
         /* prepare the diff to write into subscription SHM */
         if (!diff_lyb) {
             /* first reverse change diff for abort */
@@ -1029,17 +1085,15 @@ clear_shm:
             }
 
             if (lyd_print_mem(&diff_lyb, abort_diff, LYD_LYB, LYP_WITHSIBLINGS)) {
-                lyd_free_withsiblings(abort_diff);
                 sr_errinfo_new_ly(&err_info, mod->ly_mod->ctx);
                 goto cleanup;
             }
-            lyd_free_withsiblings(abort_diff);
             diff_lyb_len = lyd_lyb_data_length(diff_lyb);
         }
 
         /* correctly start the loop, with fake last priority 1 higher than the actual highest */
         sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_ABORT,
-                cur_priority + 1, &cur_priority, &subscriber_count, NULL);
+                mod_info->diff, cur_priority + 1, &cur_priority, &subscriber_count, NULL);
         if (last_subscr && (err_priority == cur_priority)) {
             /* do not notify subscribers that did not process the previous event */
             subscriber_count -= err_subscriber_count;
@@ -1066,7 +1120,7 @@ clear_shm:
 
             /* notify using event pipe */
             if ((err_info = sr_shmsub_change_notify_evpipe(mod_info->conn->ext_shm.addr, mod, mod_info->ds,
-                    SR_SUB_EV_ABORT, cur_priority))) {
+                    SR_SUB_EV_ABORT, mod_info->diff, cur_priority))) {
                 goto cleanup_wrunlock;
             }
 
@@ -1093,7 +1147,7 @@ clear_shm:
 
             /* find out what is the next priority and how many subscribers have it */
             sr_shmsub_change_notify_next_subscription(mod_info->conn->ext_shm.addr, mod, mod_info->ds, SR_SUB_EV_ABORT,
-                    cur_priority, &cur_priority, &subscriber_count, NULL);
+                    mod_info->diff, cur_priority, &cur_priority, &subscriber_count, NULL);
 
             if (last_subscr && (err_priority == cur_priority)) {
                 /* do not notify subscribers that did not process the previous event */
@@ -1106,83 +1160,174 @@ clear_shm:
 
     /* unreachable unless the failed subscription was not found */
     SR_ERRINFO_INT(&err_info);
-    return err_info;
+    goto cleanup;
 
 cleanup_wrunlock:
     /* SUB WRITE UNLOCK */
     sr_rwunlock(&multi_sub_shm->lock, SR_LOCK_WRITE, __func__);
 cleanup:
+    lyd_free_withsiblings(abort_diff);
     free(diff_lyb);
     sr_shm_clear(&shm_sub);
     return err_info;
 }
 
 sr_error_info_t *
-sr_shmsub_oper_notify(const struct lys_module *ly_mod, const char *xpath, const char *request_xpath,
-        const struct lyd_node *parent, sr_sid_t sid, uint32_t evpipe_num, uint32_t timeout_ms, struct lyd_node **data,
-        sr_error_info_t **cb_err_info)
+sr_shmsub_oper_notify_send(const struct lys_module *ly_mod, const char *xpath, const char *request_xpath,
+        const char *page_after, uint32_t page_count, const struct lyd_node *parent, sr_sid_t sid, uint32_t evpipe_num,
+        uint32_t slot_count, uint32_t timeout_ms, sr_shmsub_oper_req_t *req)
 {
     sr_error_info_t *err_info = NULL;
-    char *parent_lyb = NULL;
-    uint32_t parent_lyb_len, request_id;
-    sr_sub_shm_t *sub_shm;
-    sr_shm_t shm_sub = SR_SHM_INITIALIZER;
+    char *parent_lyb = NULL, *data = NULL, suffix[SR_OPER_SLOT_SUFFIX_SIZE];
+    uint32_t parent_lyb_len, data_len, slot;
+    size_t page_len;
+    sr_sub_shm_t *sub_shm = NULL;
+
+    memset(req, 0, sizeof *req);
+    req->ly_mod = ly_mod;
+    req->shm_sub.fd = -1;
 
     if (!request_xpath) {
         request_xpath = "";
     }
+    if (!page_after) {
+        page_after = "";
+    }
 
-    /* print the parent (or nothing) into LYB */
-    if (lyd_print_mem(&parent_lyb, parent, LYD_LYB, 0)) {
+    /* print the parent (or nothing) into LYB, there can be more parents for batched subscriptions */
+    if (lyd_print_mem(&parent_lyb, parent, LYD_LYB, LYP_WITHSIBLINGS)) {
         sr_errinfo_new_ly(&err_info, ly_mod->ctx);
-        goto cleanup;
+        goto error;
     }
     parent_lyb_len = lyd_lyb_data_length(parent_lyb);
 
-    /* open sub SHM and map it */
-    if ((err_info = sr_shmsub_open_map(ly_mod->name, "oper", sr_str_hash(xpath), &shm_sub, sizeof *sub_shm))) {
-        goto cleanup;
+    /* prepare event data, the requested page followed by the parent */
+    page_len = SR_SHM_SIZE(sizeof page_count) + sr_strshmlen(page_after);
+    data_len = page_len + parent_lyb_len;
+    data = malloc(data_len);
+    SR_CHECK_MEM_GOTO(!data, err_info, error);
+    memcpy(data, &page_count, sizeof page_count);
+    strcpy(data + SR_SHM_SIZE(sizeof page_count), page_after);
+    memcpy(data + page_len, parent_lyb, parent_lyb_len);
+
+    /* try to find a request slot without an event so that we do not have to wait */
+    for (slot = 1; slot < slot_count; ++slot) {
+        /* open sub SHM and map it */
+        sr_oper_slot_suffix(slot, suffix);
+        if ((err_info = sr_shmsub_open_map(ly_mod->name, suffix, sr_str_hash(xpath), &req->shm_sub, sizeof *sub_shm))) {
+            goto error;
+        }
+        sub_shm = (sr_sub_shm_t *)req->shm_sub.addr;
+
+        /* SUB WRITE LOCK, if possible right away */
+        if (!pthread_mutex_trylock(&sub_shm->lock.mutex)) {
+            if (!sub_shm->lock.readers && !sub_shm->event) {
+                break;
+            }
+
+            /* MUTEX UNLOCK */
+            pthread_mutex_unlock(&sub_shm->lock.mutex);
+        }
+        sr_shm_clear(&req->shm_sub);
+        sub_shm = NULL;
     }
-    sub_shm = (sr_sub_shm_t *)shm_sub.addr;
 
-    /* SUB WRITE LOCK */
-    if ((err_info = sr_shmsub_notify_new_wrlock(sub_shm, ly_mod->name, 0))) {
-        goto cleanup;
+    if (!sub_shm) {
+        /* all the additional slots are busy (or there are none), wait for the first one */
+        if ((err_info = sr_shmsub_open_map(ly_mod->name, "oper", sr_str_hash(xpath), &req->shm_sub, sizeof *sub_shm))) {
+            goto error;
+        }
+        sub_shm = (sr_sub_shm_t *)req->shm_sub.addr;
+
+        /* SUB WRITE LOCK */
+        if ((err_info = sr_shmsub_notify_new_wrlock(sub_shm, ly_mod->name, 0))) {
+            goto error;
+        }
     }
 
-    /* remap to make space for additional data (parent) */
-    if ((err_info = sr_shm_remap(&shm_sub, sizeof *sub_shm + parent_lyb_len))) {
-        goto cleanup_wrunlock;
+    /* remap to make space for additional data (page and parent) */
+    if ((err_info = sr_shm_remap(&req->shm_sub, sizeof *sub_shm + sr_strshmlen(request_xpath) + data_len))) {
+        goto error_wrunlock;
     }
-    sub_shm = (sr_sub_shm_t *)shm_sub.addr;
+    sub_shm = (sr_sub_shm_t *)req->shm_sub.addr;
 
     /* write the request for state data */
-    request_id = sub_shm->request_id + 1;
-    sr_shmsub_notify_write_event(sub_shm, request_id, SR_SUB_EV_OPER, &sid, request_xpath, parent_lyb, parent_lyb_len);
+    req->request_id = sub_shm->request_id + 1;
+    sr_shmsub_notify_write_event(sub_shm, req->request_id, SR_SUB_EV_OPER, &sid, request_xpath, data, data_len);
 
-    /* notify using event pipe and wait until the subscriber has processed the event */
+    /* notify using event pipe */
     if ((err_info = sr_shmsub_notify_evpipe(evpipe_num))) {
-        goto cleanup;
+        /* clear SHM */
+        sr_shmsub_notify_write_event(sub_shm, req->request_id, 0, NULL, NULL, NULL, 0);
+        goto error_wrunlock;
     }
 
+    /* the subscriber can process the event now, no other event can be written until this one is finished */
+    sr_time_get(&req->timeout_ts, timeout_ms);
+
+    /* SUB WRITE UNLOCK */
+    sr_rwunlock(&sub_shm->lock, SR_LOCK_WRITE, __func__);
+
+    free(parent_lyb);
+    free(data);
+    return NULL;
+
+error_wrunlock:
     /* SUB WRITE UNLOCK */
+    sr_rwunlock(&sub_shm->lock, SR_LOCK_WRITE, __func__);
+error:
+    sr_shm_clear(&req->shm_sub);
+    free(parent_lyb);
+    free(data);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_oper_notify_recv(sr_shmsub_oper_req_t *req, struct lyd_node **data, sr_error_info_t **cb_err_info)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct lys_module *ly_mod = req->ly_mod;
+    struct timespec cur_ts;
+    int64_t timeout_ms;
+    sr_sub_shm_t *sub_shm;
+    int ret;
+
+    *data = NULL;
+    sub_shm = (sr_sub_shm_t *)req->shm_sub.addr;
+
+    /* SUB WRITE LOCK (the event written by us is still there) */
+    sr_time_get(&cur_ts, SR_MAIN_LOCK_TIMEOUT * 1000);
+    if ((ret = pthread_mutex_timedlock(&sub_shm->lock.mutex, &cur_ts))) {
+        SR_ERRINFO_LOCK(&err_info, __func__, ret);
+        goto cleanup;
+    }
+
+    /* learn the time left from the original timeout */
+    sr_time_get(&cur_ts, 0);
+    timeout_ms = (req->timeout_ts.tv_sec - cur_ts.tv_sec) * 1000 + (req->timeout_ts.tv_nsec - cur_ts.tv_nsec) / 1000000;
+    if (timeout_ms < 1) {
+        timeout_ms = 1;
+    }
+
+    /* wait until the subscriber has processed the event, SUB WRITE UNLOCK */
     if ((err_info = sr_shmsub_notify_finish_wrunlock(sub_shm, sizeof *sub_shm, timeout_ms, cb_err_info))) {
         goto cleanup;
     }
 
     if (*cb_err_info) {
         /* failed callback or timeout */
-        SR_LOG_WRN("Event \"operational\" with ID %u failed (%s).", request_id, sr_strerror((*cb_err_info)->err_code));
+        SR_LOG_WRN("Event \"operational\" with ID %u failed (%s).", req->request_id,
+                sr_strerror((*cb_err_info)->err_code));
 
         /* SUB WRITE LOCK */
         if ((err_info = sr_rwlock(&sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
             goto cleanup;
         }
         /* clear SHM */
-        sr_shmsub_notify_write_event(sub_shm, request_id, 0, NULL, NULL, NULL, 0);
+        sr_shmsub_notify_write_event(sub_shm, req->request_id, 0, NULL, NULL, NULL, 0);
         goto cleanup_wrunlock;
     } else {
-        SR_LOG_INF("Event \"operational\" with ID %u succeeded.", request_id);
+        SR_LOG_INF("Event \"operational\" with ID %u succeeded.", req->request_id);
     }
 
     /* SUB READ LOCK */
@@ -1191,14 +1336,14 @@ sr_shmsub_oper_notify(const struct lys_module *ly_mod, const char *xpath, const
     }
 
     /* remap sub SHM */
-    if ((err_info = sr_shm_remap(&shm_sub, 0))) {
+    if ((err_info = sr_shm_remap(&req->shm_sub, 0))) {
         goto cleanup_rdunlock;
     }
-    sub_shm = (sr_sub_shm_t *)shm_sub.addr;
+    sub_shm = (sr_sub_shm_t *)req->shm_sub.addr;
 
     /* parse returned data */
     ly_errno = 0;
-    *data = lyd_parse_mem(ly_mod->ctx, shm_sub.addr + sizeof *sub_shm, LYD_LYB, LYD_OPT_DATA | LYD_OPT_STRICT);
+    *data = lyd_parse_mem(ly_mod->ctx, req->shm_sub.addr + sizeof *sub_shm, LYD_LYB, LYD_OPT_DATA | LYD_OPT_STRICT);
     if (ly_errno) {
         sr_errinfo_new_ly(&err_info, ly_mod->ctx);
         sr_errinfo_new(&err_info, SR_ERR_VALIDATION_FAILED, NULL, "Failed to parse returned \"operational\" data.");
@@ -1216,8 +1361,7 @@ cleanup_wrunlock:
     /* SUB WRITE UNLOCK */
     sr_rwunlock(&sub_shm->lock, SR_LOCK_WRITE, __func__);
 cleanup:
-    sr_shm_clear(&shm_sub);
-    free(parent_lyb);
+    sr_shm_clear(&req->shm_sub);
     return err_info;
 }
 
@@ -1631,26 +1775,43 @@ cleanup:
 }
 
 sr_error_info_t *
-sr_shmsub_notif_notify(const struct lyd_node *notif, time_t notif_ts, sr_sid_t sid, uint32_t *notif_sub_evpipe_nums,
-        uint32_t notif_sub_count)
+sr_shmsub_notif_notify(struct lyd_node **notifs, uint32_t notif_count, time_t notif_ts, sr_sid_t sid,
+        uint32_t *notif_sub_evpipe_nums, uint32_t notif_sub_count)
 {
     sr_error_info_t *err_info = NULL;
     struct lys_module *ly_mod;
-    char *notif_lyb = NULL;
-    uint32_t notif_lyb_len, request_id, i;
+    char *notif_lyb = NULL, *data = NULL;
+    uint32_t notif_lyb_len, data_len = 0, request_id, i;
     sr_multi_sub_shm_t *multi_sub_shm;
     sr_shm_t shm_sub = SR_SHM_INITIALIZER;
+    void *mem;
 
-    assert(!notif->parent);
+    assert(notif_count);
 
-    ly_mod = lyd_node_module(notif);
+    ly_mod = lyd_node_module(notifs[0]);
 
-    /* print the notification into LYB */
-    if (lyd_print_mem(&notif_lyb, notif, LYD_LYB, 0)) {
-        sr_errinfo_new_ly(&err_info, ly_mod->ctx);
-        goto cleanup;
+    /* print all the notifications into LYB, each preceded by its timestamp */
+    for (i = 0; i < notif_count; ++i) {
+        assert(!notifs[i]->parent && (lyd_node_module(notifs[i]) == ly_mod));
+
+        if (lyd_print_mem(&notif_lyb, notifs[i], LYD_LYB, 0)) {
+            sr_errinfo_new_ly(&err_info, ly_mod->ctx);
+            goto cleanup;
+        }
+        notif_lyb_len = lyd_lyb_data_length(notif_lyb);
+
+        mem = realloc(data, data_len + sizeof notif_ts + notif_lyb_len);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+        data = mem;
+
+        memcpy(data + data_len, &notif_ts, sizeof notif_ts);
+        data_len += sizeof notif_ts;
+        memcpy(data + data_len, notif_lyb, notif_lyb_len);
+        data_len += notif_lyb_len;
+
+        free(notif_lyb);
+        notif_lyb = NULL;
     }
-    notif_lyb_len = lyd_lyb_data_length(notif_lyb);
 
     /* open sub SHM and map it */
     if ((err_info = sr_shmsub_open_map(ly_mod->name, "notif", -1, &shm_sub, sizeof *multi_sub_shm))) {
@@ -1664,15 +1825,15 @@ sr_shmsub_notif_notify(const struct lyd_node *notif, time_t notif_ts, sr_sid_t s
     }
 
     /* remap to make space for additional data */
-    if ((err_info = sr_shm_remap(&shm_sub, sizeof *multi_sub_shm + sizeof notif_ts + notif_lyb_len))) {
+    if ((err_info = sr_shm_remap(&shm_sub, sizeof *multi_sub_shm + data_len))) {
         goto cleanup_wrunlock;
     }
     multi_sub_shm = (sr_multi_sub_shm_t *)shm_sub.addr;
 
-    /* write the notification, we do not wait for any reply */
+    /* write the notifications (timestamps are part of the data), we do not wait for any reply */
     request_id = multi_sub_shm->request_id + 1;
     sr_shmsub_multi_notify_write_event(multi_sub_shm, request_id, 0, SR_SUB_EV_NOTIF, &sid, notif_sub_count,
-            notif_ts, notif_lyb, notif_lyb_len);
+            0, data, data_len);
 
     /* notify all subscribers using event pipe and do not wait for them */
     for (i = 0; i < notif_sub_count; ++i) {
@@ -1689,6 +1850,7 @@ cleanup_wrunlock:
 cleanup:
     sr_shm_clear(&shm_sub);
     free(notif_lyb);
+    free(data);
     return err_info;
 }
 
@@ -1893,7 +2055,7 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
     sr_error_info_t *err_info = NULL, *tmp_err;
     uint32_t i, data_len = 0, valid_subscr_count, request_id;
     char *data = NULL;
-    int ret, timed_out = 0;
+    int ret, timed_out = 0, filtered_out;
     struct lyd_node *diff = NULL, *abort_diff;
     sr_error_t err_code = SR_ERR_OK;
     struct modsub_changesub_s *change_sub;
@@ -1937,6 +2099,15 @@ sr_shmsub_change_listen_process_module_events(struct modsub_change_s *change_sub
     event = multi_sub_shm->event;
     request_id = multi_sub_shm->request_id;
 
+    if (event == SR_SUB_EV_ABORT) {
+        /* subscriptions are filtered based on the original change diff, the same as by the notifier */
+        if ((err_info = sr_diff_reverse(diff, &abort_diff))) {
+            goto cleanup_rdunlock;
+        }
+        lyd_free_withsiblings(diff);
+        diff = abort_diff;
+    }
+
     /* process individual subscriptions (starting at the last found subscription, it was valid) */
     valid_subscr_count = 0;
     goto process_event;
@@ -1957,7 +2128,16 @@ process_event:
 
         ret = 0;
         /* whole diff may have been filtered out */
-        if (tmp_sess.dt[tmp_sess.ds].diff) {
+        filtered_out = tmp_sess.dt[tmp_sess.ds].diff ? 0 : 1;
+        if (!filtered_out && (event == SR_SUB_EV_ABORT)) {
+            /* callback gets the reversed filtered change diff */
+            if ((err_info = sr_diff_reverse(tmp_sess.dt[tmp_sess.ds].diff, &abort_diff))) {
+                goto cleanup;
+            }
+            lyd_free_withsiblings(tmp_sess.dt[tmp_sess.ds].diff);
+            tmp_sess.dt[tmp_sess.ds].diff = abort_diff;
+        }
+        if (!filtered_out) {
             ret = change_sub->cb(&tmp_sess, change_subs->module_name, change_sub->xpath, sr_ev2api(event), request_id,
                     change_sub->private_data);
         }
@@ -1967,6 +2147,13 @@ process_event:
             goto cleanup;
         }
 
+        if (filtered_out) {
+            /* the notifier did not count this subscription, it is not interested in any of the changes */
+            change_sub->request_id = request_id;
+            change_sub->event = event;
+            continue;
+        }
+
         if ((event == SR_SUB_EV_UPDATE) || (event == SR_SUB_EV_CHANGE)) {
             /* check that SHM is valid even after the callback returned */
             if ((event != multi_sub_shm->event) || (request_id != multi_sub_shm->request_id)) {
@@ -2029,6 +2216,11 @@ process_event:
         goto cleanup;
     }
 
+    if (!valid_subscr_count && (err_code == SR_ERR_OK)) {
+        /* no subscription processed the event, nothing to write */
+        goto cleanup_rdunlock;
+    }
+
     /*
      * prepare additional event data written into subscription SHM (after the structure)
      */
@@ -2141,16 +2333,68 @@ sr_shmsub_listen_write_event(sr_sub_shm_t *sub_shm, const char *data, uint32_t d
     return NULL;
 }
 
-sr_error_info_t *
-sr_shmsub_oper_listen_process_module_events(struct modsub_oper_s *oper_subs, sr_conn_ctx_t *conn)
+/**
+ * @brief Set origin of all the nodes provided by a batched operational subscription, if they have none.
+ *
+ * @param[in] sub_xpath Subscription XPath.
+ * @param[in] first First top-level sibling of the provided data.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_oper_listen_batch_set_origin(const char *sub_xpath, struct lyd_node *first)
+{
+    sr_error_info_t *err_info = NULL;
+    char *parent_xpath = NULL;
+    struct ly_set *set = NULL;
+    struct lyd_node *node;
+    const char *origin;
+    uint32_t i;
+
+    /* find all the parents */
+    if ((err_info = sr_xpath_trim_last_node(sub_xpath, &parent_xpath))) {
+        goto cleanup;
+    }
+    set = lyd_find_path(first, parent_xpath);
+    if (!set) {
+        sr_errinfo_new_ly(&err_info, lyd_node_module(first)->ctx);
+        goto cleanup;
+    }
+
+    for (i = 0; i < set->number; ++i) {
+        LY_TREE_FOR(sr_lyd_child(set->set.d[i], 1), node) {
+            sr_edit_diff_get_origin(node, &origin, NULL);
+            if ((!origin || !strcmp(origin, SR_CONFIG_ORIGIN))
+                    && (err_info = sr_edit_diff_set_origin(node, SR_OPER_ORIGIN, 0))) {
+                goto cleanup;
+            }
+        }
+    }
+
+cleanup:
+    free(parent_xpath);
+    ly_set_free(set);
+    return err_info;
+}
+
+/**
+ * @brief Process a new event in a single request slot of an operational subscription.
+ *
+ * @param[in] oper_subs Operational subscriptions of the module.
+ * @param[in] oper_sub Operational subscription of the slot.
+ * @param[in] slot Request slot to process.
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_oper_listen_process_slot_event(struct modsub_oper_s *oper_subs, struct modsub_opersub_s *oper_sub,
+        struct modsub_operslot_s *slot, sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i, data_len = 0, request_id;
-    char *data = NULL, *request_xpath = NULL;
+    uint32_t data_len = 0, request_id;
+    char *data = NULL, *request_xpath = NULL, *page_after = NULL, *event_data;
     const char *origin;
     int timed_out = 0;
     sr_error_t err_code = SR_ERR_OK;
-    struct modsub_opersub_s *oper_sub;
     struct lyd_node *parent = NULL, *orig_parent, *node;
     sr_sub_shm_t *sub_shm;
     sr_session_ctx_t tmp_sess;
@@ -2160,162 +2404,212 @@ sr_shmsub_oper_listen_process_module_events(struct modsub_oper_s *oper_subs, sr_
     tmp_sess.ds = SR_DS_OPERATIONAL;
     tmp_sess.ev = SR_SUB_EV_CHANGE;
 
-    for (i = 0; (err_code == SR_ERR_OK) && (i < oper_subs->sub_count); ++i) {
-        oper_sub = &oper_subs->subs[i];
-        sub_shm = (sr_sub_shm_t *)oper_sub->sub_shm.addr;
+    sub_shm = (sr_sub_shm_t *)slot->sub_shm.addr;
 
-        /* SUB READ LOCK */
-        if ((err_info = sr_rwlock(&sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_READ, __func__))) {
-            goto error;
-        }
+    /* SUB READ LOCK */
+    if ((err_info = sr_rwlock(&sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_READ, __func__))) {
+        goto cleanup;
+    }
 
-        /* no new event */
-        if ((sub_shm->event != SR_SUB_EV_OPER) || (sub_shm->request_id == oper_sub->request_id)) {
-            /* SUB READ UNLOCK */
-            sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
-            continue;
-        }
-        request_id = sub_shm->request_id;
+    /* no new event */
+    if ((sub_shm->event != SR_SUB_EV_OPER) || (sub_shm->request_id == slot->request_id)) {
+        /* SUB READ UNLOCK */
+        sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
+        return NULL;
+    }
+    request_id = sub_shm->request_id;
 
-        /* read SID */
-        tmp_sess.sid = sub_shm->sid;
+    /* read SID */
+    tmp_sess.sid = sub_shm->sid;
 
-        /* remap SHM */
-        if ((err_info = sr_shm_remap(&oper_sub->sub_shm, 0))) {
-            goto error_rdunlock;
-        }
-        sub_shm = (sr_sub_shm_t *)oper_sub->sub_shm.addr;
+    /* remap SHM */
+    if ((err_info = sr_shm_remap(&slot->sub_shm, 0))) {
+        goto error_rdunlock;
+    }
+    sub_shm = (sr_sub_shm_t *)slot->sub_shm.addr;
 
-        /* load xpath */
-        request_xpath = strdup(oper_sub->sub_shm.addr + sizeof(sr_sub_shm_t));
-        SR_CHECK_MEM_GOTO(!request_xpath, err_info, error_rdunlock);
+    /* load xpath */
+    request_xpath = strdup(slot->sub_shm.addr + sizeof(sr_sub_shm_t));
+    SR_CHECK_MEM_GOTO(!request_xpath, err_info, error_rdunlock);
+    event_data = slot->sub_shm.addr + sizeof(sr_sub_shm_t) + sr_strshmlen(request_xpath);
 
-        /* parse data parent */
-        ly_errno = 0;
-        parent = lyd_parse_mem(conn->ly_ctx, oper_sub->sub_shm.addr + sizeof(sr_sub_shm_t) + sr_strshmlen(request_xpath),
-                LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
-        SR_CHECK_INT_GOTO(ly_errno, err_info, error_rdunlock);
+    /* load the requested page */
+    memcpy(&tmp_sess.oper_page.count, event_data, sizeof tmp_sess.oper_page.count);
+    event_data += SR_SHM_SIZE(sizeof tmp_sess.oper_page.count);
+    page_after = strdup(event_data);
+    SR_CHECK_MEM_GOTO(!page_after, err_info, error_rdunlock);
+    event_data += sr_strshmlen(page_after);
+    if (tmp_sess.oper_page.count && page_after[0]) {
+        tmp_sess.oper_page.after_path = page_after;
+    }
+
+    /* parse data parent */
+    ly_errno = 0;
+    parent = lyd_parse_mem(conn->ly_ctx, event_data, LYD_LYB, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    SR_CHECK_INT_GOTO(ly_errno, err_info, error_rdunlock);
+    if (!(oper_sub->opts & SR_SUBSCR_OPER_BATCH)) {
         /* go to the actual parent, not the root */
         if ((err_info = sr_ly_find_last_parent(&parent, 0))) {
             goto error_rdunlock;
         }
+    }
 
-        /* SUB READ UNLOCK */
-        sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
+    /* SUB READ UNLOCK */
+    sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
+
+    /* process event */
+    SR_LOG_INF("Processing \"operational\" \"%s\" event with ID %u.", oper_subs->module_name, request_id);
 
-        /* process event */
-        SR_LOG_INF("Processing \"operational\" \"%s\" event with ID %u.", oper_subs->module_name, request_id);
+    /* call callback */
+    orig_parent = parent;
+    err_code = oper_sub->cb(&tmp_sess, oper_subs->module_name, oper_sub->xpath, request_xpath[0] ? request_xpath : NULL,
+            request_id, &parent, oper_sub->private_data);
 
-        /* call callback */
-        orig_parent = parent;
-        err_code = oper_sub->cb(&tmp_sess, oper_subs->module_name, oper_sub->xpath, request_xpath[0] ? request_xpath : NULL,
-                request_id, &parent, oper_sub->private_data);
-
-        /* go again to the top-level root for printing */
-        if (parent) {
-            /* set origin if none */
-            LY_TREE_FOR(orig_parent ? sr_lyd_child(parent, 1) : parent, node) {
-                sr_edit_diff_get_origin(node, &origin, NULL);
-                if ((!origin || !strcmp(origin, SR_CONFIG_ORIGIN))
-                        && (err_info = sr_edit_diff_set_origin(node, SR_OPER_ORIGIN, 0))) {
-                    goto error;
-                }
-            }
+    /* go again to the top-level root for printing */
+    if (parent && orig_parent && (oper_sub->opts & SR_SUBSCR_OPER_BATCH)) {
+        while (parent->parent) {
+            parent = parent->parent;
+        }
+        while (parent->prev->next) {
+            parent = parent->prev;
+        }
 
-            while (parent->parent) {
-                parent = parent->parent;
+        /* set origin of the children of all the parents if none */
+        if ((err_info = sr_shmsub_oper_listen_batch_set_origin(oper_sub->xpath, parent))) {
+            goto cleanup;
+        }
+    } else if (parent) {
+        /* set origin if none */
+        LY_TREE_FOR(orig_parent ? sr_lyd_child(parent, 1) : parent, node) {
+            sr_edit_diff_get_origin(node, &origin, NULL);
+            if ((!origin || !strcmp(origin, SR_CONFIG_ORIGIN))
+                    && (err_info = sr_edit_diff_set_origin(node, SR_OPER_ORIGIN, 0))) {
+                goto cleanup;
             }
         }
 
-        /* SUB READ LOCK */
-        if ((err_info = sr_rwlock(&sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_READ, __func__))) {
-            goto error;
+        while (parent->parent) {
+            parent = parent->parent;
         }
+    }
 
-        /* check that SHM is valid even after the callback returned */
-        if ((SR_SUB_EV_OPER != sub_shm->event) || (request_id != sub_shm->request_id)) {
-            timed_out = 1;
-        }
+    /* SUB READ LOCK */
+    if ((err_info = sr_rwlock(&sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_READ, __func__))) {
+        goto cleanup;
+    }
 
-        /* SUB READ UNLOCK */
-        sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
+    /* check that SHM is valid even after the callback returned */
+    if ((SR_SUB_EV_OPER != sub_shm->event) || (request_id != sub_shm->request_id)) {
+        timed_out = 1;
+    }
 
-        if (!timed_out && (err_code == SR_ERR_CALLBACK_SHELVE)) {
-            /* this subscription did not process the event yet, skip it */
-            SR_LOG_INF("Shelved processing \"operational\" event with ID %u.", request_id);
-            goto next_iter;
-        } else if (timed_out) {
-            sr_errinfo_new(&err_info, SR_ERR_TIME_OUT, NULL, "Unable to finish processing event \"operational\" with"
-                    " ID %u (timeout probably).", request_id);
-            goto error;
-        }
+    /* SUB READ UNLOCK */
+    sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
 
-        /* SUB WRITE LOCK */
-        if ((err_info = sr_rwlock(&sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
-            goto error;
-        }
+    if (!timed_out && (err_code == SR_ERR_CALLBACK_SHELVE)) {
+        /* this subscription did not process the event yet, skip it */
+        SR_LOG_INF("Shelved processing \"operational\" event with ID %u.", request_id);
+        goto cleanup;
+    } else if (timed_out) {
+        sr_errinfo_new(&err_info, SR_ERR_TIME_OUT, NULL, "Unable to finish processing event \"operational\" with"
+                " ID %u (timeout probably).", request_id);
+        goto cleanup;
+    }
 
-        /* remember request ID so that we do not process it again */
-        oper_sub->request_id = sub_shm->request_id;
+    /* SUB WRITE LOCK */
+    if ((err_info = sr_rwlock(&sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
+        goto cleanup;
+    }
 
-        /*
-         * prepare additional event data written into subscription SHM (after the structure)
-         */
-        if (err_code != SR_ERR_OK) {
-            if ((err_info = sr_shmsub_prepare_error(err_code, &tmp_sess, &data, &data_len))) {
-                goto error_wrunlock;
-            }
-        } else {
-            if (lyd_print_mem(&data, parent, LYD_LYB, LYP_WITHSIBLINGS)) {
-                sr_errinfo_new_ly(&err_info, conn->ly_ctx);
-                goto error_wrunlock;
-            }
-            data_len = lyd_lyb_data_length(data);
-        }
+    /* remember request ID so that we do not process it again */
+    slot->request_id = sub_shm->request_id;
 
-        /* remap SHM having the lock */
-        if ((err_info = sr_shm_remap(&oper_sub->sub_shm, sizeof *sub_shm + data_len))) {
+    /*
+     * prepare additional event data written into subscription SHM (after the structure)
+     */
+    if (err_code != SR_ERR_OK) {
+        if ((err_info = sr_shmsub_prepare_error(err_code, &tmp_sess, &data, &data_len))) {
             goto error_wrunlock;
         }
-        sub_shm = (sr_sub_shm_t *)oper_sub->sub_shm.addr;
-
-        /* finish event */
-        if ((err_info = sr_shmsub_listen_write_event(sub_shm, data, data_len, err_code))) {
+    } else {
+        if (lyd_print_mem(&data, parent, LYD_LYB, LYP_WITHSIBLINGS)) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx);
             goto error_wrunlock;
         }
+        data_len = lyd_lyb_data_length(data);
+    }
 
-        /* SUB WRITE UNLOCK */
-        sr_rwunlock(&sub_shm->lock, SR_LOCK_WRITE, __func__);
-
-next_iter:
-        /* next iteration */
-        free(data);
-        data = NULL;
-        lyd_free_withsiblings(parent);
-        parent = NULL;
-        free(request_xpath);
-        request_xpath = NULL;
+    /* remap SHM having the lock */
+    if ((err_info = sr_shm_remap(&slot->sub_shm, sizeof *sub_shm + data_len))) {
+        goto error_wrunlock;
     }
+    sub_shm = (sr_sub_shm_t *)slot->sub_shm.addr;
 
-    /* success */
-    sr_clear_sess(&tmp_sess);
-    return NULL;
+    /* finish event */
+    if ((err_info = sr_shmsub_listen_write_event(sub_shm, data, data_len, err_code))) {
+        goto error_wrunlock;
+    }
 
-error_wrunlock:
     /* SUB WRITE UNLOCK */
     sr_rwunlock(&sub_shm->lock, SR_LOCK_WRITE, __func__);
-    goto error;
 
-error_rdunlock:
-    /* SUB READ UNLOCK */
-    sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
-
-error:
+cleanup:
     sr_clear_sess(&tmp_sess);
     free(data);
     lyd_free_withsiblings(parent);
     free(request_xpath);
+    free(page_after);
     return err_info;
+
+error_wrunlock:
+    /* SUB WRITE UNLOCK */
+    sr_rwunlock(&sub_shm->lock, SR_LOCK_WRITE, __func__);
+    goto cleanup;
+
+error_rdunlock:
+    /* SUB READ UNLOCK */
+    sr_rwunlock(&sub_shm->lock, SR_LOCK_READ, __func__);
+    goto cleanup;
+}
+
+/**
+ * @brief Process all the new events of a single operational subscription.
+ *
+ * @param[in] oper_subs Operational subscriptions of the module.
+ * @param[in] oper_sub Operational subscription to process.
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_shmsub_oper_listen_process_sub_events(struct modsub_oper_s *oper_subs, struct modsub_opersub_s *oper_sub,
+        sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t j;
+
+    /* process the events in all the request slots */
+    for (j = 0; j < oper_sub->slot_count; ++j) {
+        if ((err_info = sr_shmsub_oper_listen_process_slot_event(oper_subs, oper_sub, &oper_sub->slots[j], conn))) {
+            return err_info;
+        }
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_shmsub_oper_listen_process_module_events(struct modsub_oper_s *oper_subs, sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    uint32_t i;
+
+    for (i = 0; i < oper_subs->sub_count; ++i) {
+        if ((err_info = sr_shmsub_oper_listen_process_sub_events(oper_subs, &oper_subs->subs[i], conn))) {
+            return err_info;
+        }
+    }
+
+    return NULL;
 }
 
 /**
@@ -2684,12 +2978,15 @@ sr_error_info_t *
 sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs, sr_conn_ctx_t *conn)
 {
     sr_error_info_t *err_info = NULL;
-    uint32_t i;
-    struct lyd_node *notif = NULL, *notif_op;
+    uint32_t i, j, notif_count = 0;
+    struct lyd_node **notifs = NULL, *notif_op;
     struct ly_set *set;
-    time_t notif_ts;
+    time_t *notif_tss = NULL;
     sr_multi_sub_shm_t *multi_sub_shm;
     sr_sid_t sid;
+    char *data;
+    int lyb_len;
+    void *mem;
 
     multi_sub_shm = (sr_multi_sub_shm_t *)notif_subs->sub_shm.addr;
 
@@ -2709,14 +3006,31 @@ sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs,
     }
     multi_sub_shm = (sr_multi_sub_shm_t *)notif_subs->sub_shm.addr;
 
-    /* parse timestamp */
-    notif_ts = *(time_t *)(notif_subs->sub_shm.addr + sizeof *multi_sub_shm);
+    /* parse all the notifications, each preceded by its timestamp */
+    data = notif_subs->sub_shm.addr + sizeof *multi_sub_shm;
+    while (data + sizeof *notif_tss < notif_subs->sub_shm.addr + notif_subs->sub_shm.size) {
+        mem = realloc(notifs, (notif_count + 1) * sizeof *notifs);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_rdunlock);
+        notifs = mem;
+        mem = realloc(notif_tss, (notif_count + 1) * sizeof *notif_tss);
+        SR_CHECK_MEM_GOTO(!mem, err_info, cleanup_rdunlock);
+        notif_tss = mem;
+
+        /* parse timestamp */
+        notif_tss[notif_count] = *(time_t *)data;
+        data += sizeof *notif_tss;
+
+        /* parse notification */
+        ly_errno = 0;
+        notifs[notif_count] = lyd_parse_mem(conn->ly_ctx, data, LYD_LYB, LYD_OPT_NOTIF | LYD_OPT_STRICT | LYD_OPT_TRUSTED, NULL);
+        SR_CHECK_INT_GOTO(ly_errno, err_info, cleanup_rdunlock);
+        ++notif_count;
 
-    /* parse notification */
-    ly_errno = 0;
-    notif = lyd_parse_mem(conn->ly_ctx, notif_subs->sub_shm.addr + sizeof *multi_sub_shm + sizeof notif_ts, LYD_LYB,
-            LYD_OPT_NOTIF | LYD_OPT_STRICT | LYD_OPT_TRUSTED, NULL);
-    SR_CHECK_INT_GOTO(ly_errno, err_info, cleanup_rdunlock);
+        lyb_len = lyd_lyb_data_length(data);
+        SR_CHECK_INT_GOTO(lyb_len < 1, err_info, cleanup_rdunlock);
+        data += lyb_len;
+    }
+    SR_CHECK_INT_GOTO(!notif_count, err_info, cleanup_rdunlock);
 
     /* remember request ID so that we do not process it again */
     notif_subs->request_id = multi_sub_shm->request_id;
@@ -2727,7 +3041,8 @@ sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs,
     /* SUB READ UNLOCK */
     sr_rwunlock(&multi_sub_shm->lock, SR_LOCK_READ, __func__);
 
-    SR_LOG_INF("Processing \"notif\" \"%s\" event with ID %u.", notif_subs->module_name, multi_sub_shm->request_id);
+    SR_LOG_INF("Processing \"notif\" \"%s\" event with ID %u (%u notifications).", notif_subs->module_name,
+            multi_sub_shm->request_id, notif_count);
 
     /* SUB WRITE LOCK */
     if ((err_info = sr_rwlock(&multi_sub_shm->lock, SR_MAIN_LOCK_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
@@ -2744,27 +3059,29 @@ sr_shmsub_notif_listen_process_module_events(struct modsub_notif_s *notif_subs,
         goto cleanup;
     }
 
-    /* go to the operation, not the root */
-    notif_op = notif;
-    if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
-        goto cleanup;
-    }
+    for (j = 0; j < notif_count; ++j) {
+        /* go to the operation, not the root */
+        notif_op = notifs[j];
+        if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
+            goto cleanup;
+        }
 
-    /* call callbacks if xpath filter matches */
-    for (i = 0; i < notif_subs->sub_count; ++i) {
-        if (notif_subs->subs[i].xpath) {
-            set = lyd_find_path(notif_op, notif_subs->subs[i].xpath);
-            SR_CHECK_INT_GOTO(!set, err_info, cleanup);
-            if (!set->number) {
+        /* call callbacks if xpath filter matches */
+        for (i = 0; i < notif_subs->sub_count; ++i) {
+            if (notif_subs->subs[i].xpath) {
+                set = lyd_find_path(notif_op, notif_subs->subs[i].xpath);
+                SR_CHECK_INT_GOTO(!set, err_info, cleanup);
+                if (!set->number) {
+                    ly_set_free(set);
+                    continue;
+                }
                 ly_set_free(set);
-                continue;
             }
-            ly_set_free(set);
-        }
 
-        if ((err_info = sr_notif_call_callback(conn, notif_subs->subs[i].cb, notif_subs->subs[i].tree_cb,
-                notif_subs->subs[i].private_data, SR_EV_NOTIF_REALTIME, notif_op, notif_ts, sid))) {
-            goto cleanup;
+            if ((err_info = sr_notif_call_callback(conn, notif_subs->subs[i].cb, notif_subs->subs[i].tree_cb,
+                    notif_subs->subs[i].private_data, SR_EV_NOTIF_REALTIME, notif_op, notif_tss[j], sid))) {
+                goto cleanup;
+            }
         }
     }
 
@@ -2775,10 +3092,97 @@ cleanup_rdunlock:
     /* SUB READ UNLOCK */
     sr_rwunlock(&multi_sub_shm->lock, SR_LOCK_READ, __func__);
 cleanup:
-    lyd_free_withsiblings(notif);
+    for (j = 0; j < notif_count; ++j) {
+        lyd_free_withsiblings(notifs[j]);
+    }
+    free(notifs);
+    free(notif_tss);
     return err_info;
 }
 
+int
+sr_shmsub_change_listen_module_has_event(struct modsub_change_s *change_subs)
+{
+    sr_multi_sub_shm_t *multi_sub_shm;
+    uint32_t i;
+
+    multi_sub_shm = (sr_multi_sub_shm_t *)change_subs->sub_shm.addr;
+
+    /* only a hint, the event is checked again while holding the lock */
+    for (i = 0; i < change_subs->sub_count; ++i) {
+        if (sr_shmsub_change_listen_is_new_event(multi_sub_shm, &change_subs->subs[i])) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check whether there is a new event in a single request slot of an operational subscription.
+ *
+ * @param[in] slot Request slot.
+ * @return 0 if not, non-zero if there is.
+ */
+static int
+sr_shmsub_oper_listen_slot_has_event(struct modsub_operslot_s *slot)
+{
+    sr_sub_shm_t *sub_shm;
+
+    /* only a hint, the event is checked again while holding the lock */
+    sub_shm = (sr_sub_shm_t *)slot->sub_shm.addr;
+    return (sub_shm->event == SR_SUB_EV_OPER) && (sub_shm->request_id != slot->request_id);
+}
+
+int
+sr_shmsub_oper_listen_module_has_event(struct modsub_oper_s *oper_subs)
+{
+    uint32_t i, j;
+
+    for (i = 0; i < oper_subs->sub_count; ++i) {
+        for (j = 0; j < oper_subs->subs[i].slot_count; ++j) {
+            if (sr_shmsub_oper_listen_slot_has_event(&oper_subs->subs[i].slots[j])) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int
+sr_shmsub_rpc_listen_has_event(struct opsub_rpc_s *rpc_subs)
+{
+    sr_multi_sub_shm_t *multi_sub_shm;
+    uint32_t i;
+
+    multi_sub_shm = (sr_multi_sub_shm_t *)rpc_subs->sub_shm.addr;
+
+    /* only a hint, the event is checked again while holding the lock */
+    for (i = 0; i < rpc_subs->sub_count; ++i) {
+        if (sr_shmsub_rpc_listen_is_new_event(multi_sub_shm, &rpc_subs->subs[i])) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int
+sr_shmsub_notif_listen_module_has_event(struct modsub_notif_s *notif_subs)
+{
+    sr_multi_sub_shm_t *multi_sub_shm;
+
+    multi_sub_shm = (sr_multi_sub_shm_t *)notif_subs->sub_shm.addr;
+
+    /* only a hint, the event is checked again while holding the lock */
+    if ((multi_sub_shm->event == SR_SUB_EV_NOTIF) && (multi_sub_shm->request_id != notif_subs->request_id)) {
+        return 1;
+    }
+
+    return 0;
+}
+
 int
 sr_shmsub_notif_listen_module_has_replay_or_stop(struct modsub_notif_s *notif_subs)
 {
@@ -2993,3 +3397,316 @@ error:
     pthread_detach(pthread_self());
     return NULL;
 }
+
+/**
+ * @brief Get the busy flag of module/operation subscriptions processed by worker thread tasks.
+ *
+ * @param[in] type Type of the subscriptions.
+ * @param[in] sub Module/operation subscriptions.
+ * @param[in] slot Request slot index, only for ::SR_SUBS_TASK_OPER.
+ * @return Pointer to the busy flag.
+ */
+static int *
+sr_shmsub_pool_task_busy(sr_subs_task_type_t type, void *sub, uint32_t slot)
+{
+    switch (type) {
+    case SR_SUBS_TASK_CHANGE:
+        return &((struct modsub_change_s *)sub)->busy;
+    case SR_SUBS_TASK_OPER:
+        return &((struct modsub_opersub_s *)sub)->slots[slot].busy;
+    case SR_SUBS_TASK_NOTIF:
+        return &((struct modsub_notif_s *)sub)->busy;
+    case SR_SUBS_TASK_RPC:
+        break;
+    }
+
+    return &((struct opsub_rpc_s *)sub)->busy;
+}
+
+/**
+ * @brief Check whether there are any new events for module/operation subscriptions of a worker thread task.
+ *
+ * @param[in] type Type of the subscriptions.
+ * @param[in] sub Module/operation subscriptions.
+ * @param[in] slot Request slot index, only for ::SR_SUBS_TASK_OPER.
+ * @return 0 if not, non-zero if there are.
+ */
+static int
+sr_shmsub_pool_task_has_event(sr_subs_task_type_t type, void *sub, uint32_t slot)
+{
+    switch (type) {
+    case SR_SUBS_TASK_CHANGE:
+        return sr_shmsub_change_listen_module_has_event(sub);
+    case SR_SUBS_TASK_OPER:
+        return sr_shmsub_oper_listen_slot_has_event(&((struct modsub_opersub_s *)sub)->slots[slot]);
+    case SR_SUBS_TASK_NOTIF:
+        return sr_shmsub_notif_listen_module_has_event(sub);
+    case SR_SUBS_TASK_RPC:
+        break;
+    }
+
+    return sr_shmsub_rpc_listen_has_event(sub);
+}
+
+sr_error_info_t *
+sr_shmsub_pool_start(sr_subscription_ctx_t *subs, uint32_t thread_count)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err;
+    int ret;
+
+    assert(!subs->pool.tid_count && thread_count);
+
+    subs->pool.tids = malloc(thread_count * sizeof *subs->pool.tids);
+    SR_CHECK_MEM_RET(!subs->pool.tids, err_info);
+
+    /* start the worker threads */
+    ATOMIC_STORE_RELAXED(subs->pool.running, 1);
+    while (subs->pool.tid_count < thread_count) {
+        ret = pthread_create(&subs->pool.tids[subs->pool.tid_count], NULL, sr_shmsub_worker_thread, subs);
+        if (ret) {
+            sr_errinfo_new(&err_info, SR_ERR_INTERNAL, NULL, "Creating a new thread failed (%s).", strerror(ret));
+
+            /* stop the threads started so far */
+            tmp_err = sr_shmsub_pool_stop(subs);
+            sr_errinfo_merge(&err_info, tmp_err);
+            return err_info;
+        }
+        ++subs->pool.tid_count;
+    }
+
+    return NULL;
+}
+
+sr_error_info_t *
+sr_shmsub_pool_stop(sr_subscription_ctx_t *subs)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_subs_task_s *task;
+    uint32_t i;
+    int ret;
+
+    if (!subs->pool.tids) {
+        /* no worker threads */
+        return NULL;
+    }
+
+    /* signal the threads to quit */
+    ATOMIC_STORE_RELAXED(subs->pool.running, 0);
+
+    /* POOL LOCK */
+    if ((err_info = sr_rwlock(&subs->pool.lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
+        return err_info;
+    }
+
+    /* POOL UNLOCK (wakes up all the threads) */
+    sr_rwunlock(&subs->pool.lock, SR_LOCK_WRITE, __func__);
+
+    /* join the threads, they process all the queued tasks before quitting */
+    for (i = 0; i < subs->pool.tid_count; ++i) {
+        ret = pthread_join(subs->pool.tids[i], NULL);
+        if (ret) {
+            sr_errinfo_new(&err_info, SR_ERR_SYS, NULL, "Joining a worker thread failed (%s).", strerror(ret));
+        }
+    }
+    free(subs->pool.tids);
+    subs->pool.tids = NULL;
+    subs->pool.tid_count = 0;
+
+    /* drop any tasks left after a thread failure */
+    while ((task = subs->pool.first)) {
+        subs->pool.first = task->next;
+        *sr_shmsub_pool_task_busy(task->type, task->sub, task->slot) = 0;
+        --subs->pool.active;
+        free(task);
+
+        /* SUBS READ UNLOCK (held by the task) */
+        sr_rwunlock(&subs->subs_lock, SR_LOCK_READ, __func__);
+    }
+    subs->pool.last = NULL;
+    subs->pool.rescan = 0;
+
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_pool_add_task(sr_subscription_ctx_t *subs, sr_subs_task_type_t type, void *sub, void *mod_sub, uint32_t slot)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_subs_task_s *task;
+    int *busy;
+
+    /* POOL LOCK */
+    if ((err_info = sr_rwlock(&subs->pool.lock, SR_SUB_SUBS_LOCK_TIMEOUT, SR_LOCK_WRITE, __func__))) {
+        return err_info;
+    }
+
+    busy = sr_shmsub_pool_task_busy(type, sub, slot);
+    if (*busy) {
+        /* any new events will be processed after the current task is finished */
+        subs->pool.rescan = 1;
+        goto cleanup_unlock;
+    }
+
+    /* the subscriptions are not being processed so their SHM can be safely accessed */
+    if (!sr_shmsub_pool_task_has_event(type, sub, slot)) {
+        /* nothing to do */
+        goto cleanup_unlock;
+    }
+
+    task = malloc(sizeof *task);
+    SR_CHECK_MEM_GOTO(!task, err_info, cleanup_unlock);
+    task->type = type;
+    task->sub = sub;
+    task->mod_sub = mod_sub;
+    task->slot = slot;
+    task->next = NULL;
+
+    /* SUBS READ LOCK (held by the task so that the subscriptions cannot be modified) */
+    if ((err_info = sr_rwlock(&subs->subs_lock, SR_SUB_SUBS_LOCK_TIMEOUT, SR_LOCK_READ, __func__))) {
+        free(task);
+        goto cleanup_unlock;
+    }
+
+    /* queue the task */
+    if (subs->pool.last) {
+        subs->pool.last->next = task;
+    } else {
+        subs->pool.first = task;
+    }
+    subs->pool.last = task;
+    ++subs->pool.active;
+    *busy = 1;
+
+cleanup_unlock:
+    /* POOL UNLOCK (wakes up the worker threads) */
+    sr_rwunlock(&subs->pool.lock, SR_LOCK_WRITE, __func__);
+    return err_info;
+}
+
+sr_error_info_t *
+sr_shmsub_pool_wait(sr_subscription_ctx_t *subs)
+{
+    sr_error_info_t *err_info = NULL;
+    struct timespec timeout_ts;
+    int ret;
+
+    sr_time_get(&timeout_ts, SR_SUB_EVENT_LOOP_TIMEOUT * 1000);
+
+    /* MUTEX LOCK */
+    ret = pthread_mutex_timedlock(&subs->pool.lock.mutex, &timeout_ts);
+    if (ret) {
+        SR_ERRINFO_LOCK(&err_info, __func__, ret);
+        return err_info;
+    }
+
+    /* wait until there are no tasks */
+    ret = 0;
+    while (!ret && subs->pool.active) {
+        /* COND WAIT */
+        ret = pthread_cond_timedwait(&subs->pool.lock.cond, &subs->pool.lock.mutex, &timeout_ts);
+    }
+
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&subs->pool.lock.mutex);
+
+    if (ret) {
+        SR_ERRINFO_COND(&err_info, __func__, ret);
+    }
+    return err_info;
+}
+
+void *
+sr_shmsub_worker_thread(void *arg)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_subscription_ctx_t *subs = (sr_subscription_ctx_t *)arg;
+    struct sr_subs_task_s *task;
+    struct modsub_opersub_s *oper_sub;
+    int ret, rescan;
+
+    while (1) {
+        /* MUTEX LOCK */
+        ret = pthread_mutex_lock(&subs->pool.lock.mutex);
+        if (ret) {
+            SR_ERRINFO_LOCK(&err_info, __func__, ret);
+            break;
+        }
+
+        /* wait for a task, process all the queued tasks before quitting */
+        ret = 0;
+        while (!ret && ATOMIC_LOAD_RELAXED(subs->pool.running) && !subs->pool.first) {
+            /* COND WAIT */
+            ret = pthread_cond_wait(&subs->pool.lock.cond, &subs->pool.lock.mutex);
+        }
+        if (ret || !subs->pool.first) {
+            /* MUTEX UNLOCK */
+            pthread_mutex_unlock(&subs->pool.lock.mutex);
+
+            if (ret) {
+                SR_ERRINFO_COND(&err_info, __func__, ret);
+            }
+            break;
+        }
+
+        /* dequeue the task */
+        task = subs->pool.first;
+        subs->pool.first = task->next;
+        if (!subs->pool.first) {
+            subs->pool.last = NULL;
+        }
+
+        /* MUTEX UNLOCK */
+        pthread_mutex_unlock(&subs->pool.lock.mutex);
+
+        /* process the events, errors were already printed */
+        switch (task->type) {
+        case SR_SUBS_TASK_CHANGE:
+            err_info = sr_shmsub_change_listen_process_module_events(task->sub, subs->conn);
+            break;
+        case SR_SUBS_TASK_OPER:
+            oper_sub = task->sub;
+            err_info = sr_shmsub_oper_listen_process_slot_event(task->mod_sub, oper_sub, &oper_sub->slots[task->slot],
+                    subs->conn);
+            break;
+        case SR_SUBS_TASK_NOTIF:
+            err_info = sr_shmsub_notif_listen_process_module_events(task->sub, subs->conn);
+            break;
+        case SR_SUBS_TASK_RPC:
+            err_info = sr_shmsub_rpc_listen_process_rpc_events(task->sub, subs->conn);
+            break;
+        }
+        sr_errinfo_free(&err_info);
+
+        /* MUTEX LOCK */
+        ret = pthread_mutex_lock(&subs->pool.lock.mutex);
+        if (ret) {
+            SR_ERRINFO_LOCK(&err_info, __func__, ret);
+            break;
+        }
+
+        /* the task is finished, the subscriptions may be modified once the lock is released */
+        *sr_shmsub_pool_task_busy(task->type, task->sub, task->slot) = 0;
+        --subs->pool.active;
+        rescan = subs->pool.rescan;
+        subs->pool.rescan = 0;
+
+        /* wake up anyone waiting for the tasks to finish */
+        pthread_cond_broadcast(&subs->pool.lock.cond);
+
+        /* MUTEX UNLOCK */
+        pthread_mutex_unlock(&subs->pool.lock.mutex);
+
+        /* SUBS READ UNLOCK (held by the task) */
+        sr_rwunlock(&subs->subs_lock, SR_LOCK_READ, __func__);
+        free(task);
+
+        if (rescan) {
+            /* some events were skipped because their subscriptions were busy, generate a new event */
+            err_info = sr_shmsub_notify_evpipe(subs->evpipe_num);
+            sr_errinfo_free(&err_info);
+        }
+    }
+
+    sr_errinfo_free(&err_info);
+    return NULL;
+}
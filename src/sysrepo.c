@@ -28,17 +28,21 @@
 #include <string.h>
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 #include <time.h>
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/epoll.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <pthread.h>
 
 #include <libyang/libyang.h>
 
 static sr_error_info_t *_sr_session_stop(sr_session_ctx_t *session);
 static sr_error_info_t *_sr_unsubscribe(sr_subscription_ctx_t *subscription);
+static sr_error_info_t *sr_apply_queue_stop(sr_conn_ctx_t *conn);
 
 /**
  * @brief Allocate a new connection structure.
@@ -81,9 +85,47 @@ sr_conn_new(const sr_conn_options_t opts, sr_conn_ctx_t **conn_p)
         goto error5;
     }
 
+    if ((err_info = sr_mutex_init(&conn->oper_cache.lock, 0))) {
+        goto error6;
+    }
+
+    if ((err_info = sr_rwlock_init(&conn->oper_diff_cache.lock, 0))) {
+        goto error7;
+    }
+
+    if ((err_info = sr_mutex_init(&conn->instid_cache.lock, 0))) {
+        goto error8;
+    }
+
+    if ((err_info = sr_mutex_init(&conn->dflt_cache.lock, 0))) {
+        goto error9;
+    }
+
+    if ((err_info = sr_rwlock_init(&conn->apply_queue.lock, 0))) {
+        goto error10;
+    }
+
+    if ((err_info = sr_rwlock_init(&conn->valid_pool.lock, 0))) {
+        goto error11;
+    }
+
     *conn_p = conn;
     return NULL;
 
+error11:
+    sr_rwlock_destroy(&conn->apply_queue.lock);
+error10:
+    pthread_mutex_destroy(&conn->dflt_cache.lock);
+error9:
+    pthread_mutex_destroy(&conn->instid_cache.lock);
+error8:
+    sr_rwlock_destroy(&conn->oper_diff_cache.lock);
+error7:
+    pthread_mutex_destroy(&conn->oper_cache.lock);
+error6:
+    if (conn->opts & SR_CONN_CACHE_RUNNING) {
+        sr_rwlock_destroy(&conn->mod_cache.lock);
+    }
 error5:
     sr_rwlock_destroy(&conn->ext_remap_lock);
 error4:
@@ -112,6 +154,12 @@ sr_conn_free(sr_conn_ctx_t *conn)
             lyd_free_withsiblings(conn->mod_cache.data);
             free(conn->mod_cache.mods);
         }
+        sr_conn_oper_cache_free(conn);
+        sr_conn_oper_diff_cache_free(conn);
+        sr_conn_instid_cache_free(conn);
+        sr_conn_dflt_cache_free(conn);
+        sr_rwlock_destroy(&conn->apply_queue.lock);
+        sr_conn_valid_pool_free(conn);
 
         ly_ctx_destroy(conn->ly_ctx, NULL);
         pthread_mutex_destroy(&conn->ptr_lock);
@@ -360,6 +408,10 @@ sr_disconnect(sr_conn_ctx_t *conn)
         return sr_api_ret(NULL, NULL);
     }
 
+    /* apply all the queued changes first, subscribers may need to be notified */
+    tmp_err = sr_apply_queue_stop(conn);
+    sr_errinfo_merge(&err_info, tmp_err);
+
     /* stop all subscriptions */
     for (i = 0; i < conn->session_count; ++i) {
         while (conn->sessions[i]->subscription_count && conn->sessions[i]->subscriptions[0]) {
@@ -502,20 +554,23 @@ sr_set_diff_check_callback(sr_conn_ctx_t *conn, sr_diff_check_cb callback)
     conn->diff_check_cb = callback;
 }
 
-API int
-sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_session_ctx_t **session)
+/**
+ * @brief Start a new session.
+ *
+ * @param[in] conn Connection of the session.
+ * @param[in] datastore Datastore of the session.
+ * @param[out] session Created session.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+_sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_session_ctx_t **session)
 {
     sr_error_info_t *err_info = NULL;
     sr_main_shm_t *main_shm;
     uid_t uid;
 
-    SR_CHECK_ARG_APIRET(!conn || !session, NULL, err_info);
-
     *session = calloc(1, sizeof **session);
-    if (!*session) {
-        SR_ERRINFO_MEM(&err_info);
-        return sr_api_ret(NULL, err_info);
-    }
+    SR_CHECK_MEM_RET(!*session, err_info);
 
     /* use new SR session ID and increment it (no lock needed, we are just reading and main SHM is never remapped) */
     main_shm = (sr_main_shm_t *)conn->main_shm.addr;
@@ -547,12 +602,23 @@ sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_session
 
     SR_LOG_INF("Session %u (user \"%s\") created.", (*session)->sid.sr, (*session)->sid.user);
 
-    return sr_api_ret(NULL, NULL);
+    return NULL;
 
 error:
     free((*session)->sid.user);
     free(*session);
     *session = NULL;
+    return err_info;
+}
+
+API int
+sr_session_start(sr_conn_ctx_t *conn, const sr_datastore_t datastore, sr_session_ctx_t **session)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!conn || !session, NULL, err_info);
+
+    err_info = _sr_session_start(conn, datastore, session);
     return sr_api_ret(NULL, err_info);
 }
 
@@ -604,6 +670,7 @@ _sr_session_stop(sr_session_ctx_t *session)
     for (i = 0; i < SR_DS_COUNT; ++i) {
         lyd_free_withsiblings(session->dt[i].edit);
     }
+    lyd_free_withsiblings(session->read_txn.data);
     sr_errinfo_free(&session->err_info);
     pthread_mutex_destroy(&session->ptr_lock);
     sr_rwlock_destroy(&session->notif_buf.lock);
@@ -757,6 +824,20 @@ sr_session_get_nc_id(sr_session_ctx_t *session)
     return session->sid.nc;
 }
 
+API int
+sr_session_get_oper_page(sr_session_ctx_t *session, const char **after_path, uint32_t *count)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !count, NULL, err_info);
+
+    if (after_path) {
+        *after_path = session->oper_page.after_path;
+    }
+    *count = session->oper_page.count;
+    return SR_ERR_OK;
+}
+
 API int
 sr_session_set_user(sr_session_ctx_t *session, const char *user)
 {
@@ -1521,245 +1602,854 @@ sr_get_module_info(sr_conn_ctx_t *conn, struct lyd_node **sysrepo_data)
     return sr_api_ret(NULL, err_info);
 }
 
-API int
-sr_get_item(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr_val_t **value)
+/**
+ * @brief Check whether a get operation is served from a read transaction snapshot of the session.
+ *
+ * @param[in] session Session to use.
+ * @return Whether the snapshot is used.
+ */
+static int
+sr_get_read_txn(sr_session_ctx_t *session)
 {
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    struct ly_set *set = NULL;
-    struct sr_mod_info_s mod_info;
+    return session->read_txn.active && (session->read_txn.ds == session->ds);
+}
 
-    SR_CHECK_ARG_APIRET(!session || !path || !value, session, err_info);
+/**
+ * @brief SHM READ lock, collect all modules required by a get operation, check read perm, and MODULES READ lock.
+ * Nothing is locked or collected if the read transaction snapshot of the session is used.
+ *
+ * @param[in] session Session to use.
+ * @param[in] xpath Selected data.
+ * @param[in] prepared Optional prepared @p xpath, its resolved modules are used unless the context changed.
+ * @param[in,out] mod_info Mod info to fill.
+ * @return err_info, NULL on success (everything is unlocked on error).
+ */
+static sr_error_info_t *
+sr_get_mods_lock(sr_session_ctx_t *session, const char *xpath, const sr_xpath_t *prepared, struct sr_mod_info_s *mod_info)
+{
+    sr_error_info_t *err_info = NULL;
+    const struct sr_xpath_mods_s *rmods;
 
-    if (!timeout_ms) {
-        timeout_ms = SR_OPER_CB_TIMEOUT;
+    if (sr_get_read_txn(session)) {
+        /* the snapshot was loaded and its modules checked when the transaction was started */
+        return NULL;
     }
-    *value = NULL;
-    memset(&mod_info, 0, sizeof mod_info);
 
     /* SHM LOCK (READ lock for accessing subscriptions is using oper data) */
     if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
-        return sr_api_ret(session, err_info);
+        return err_info;
     }
 
     /* collect all required modules */
-    if ((err_info = sr_shmmod_collect_xpath(session->conn, path, session->ds, &mod_info))) {
-        goto cleanup_shm_unlock;
+    if (prepared && (prepared->mod_set_id == ly_ctx_get_module_set_id(session->conn->ly_ctx))) {
+        /* modules with all their dependencies were already resolved */
+        rmods = SR_IS_CONVENTIONAL_DS(session->ds) ? &prepared->conv : &prepared->oper;
+        err_info = sr_shmmod_collect_resolved(session->conn, rmods->mods, rmods->mod_count, session->ds, mod_info);
+    } else {
+        err_info = sr_shmmod_collect_xpath(session->conn, xpath, session->ds, mod_info);
+    }
+    if (err_info) {
+        goto error_shm_unlock;
     }
 
     /* check read perm */
-    if ((err_info = sr_modinfo_perm_check(&mod_info, 0))) {
-        goto cleanup_shm_unlock;
+    if ((err_info = sr_modinfo_perm_check(mod_info, 0))) {
+        goto error_shm_unlock;
     }
 
     /* MODULES READ LOCK */
-    if ((err_info = sr_shmmod_modinfo_rdlock(&mod_info, 0, session->sid))) {
-        goto cleanup_mods_unlock;
-    }
-
-    /* load modules data */
-    if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_REQ, 1, &session->sid, path, timeout_ms, 0, &cb_err_info))
-            || cb_err_info) {
-        goto cleanup_mods_unlock;
+    if ((err_info = sr_shmmod_modinfo_rdlock(mod_info, 0, session->sid))) {
+        goto error_mods_unlock;
     }
 
-    /* filter the required data */
-    if ((err_info = sr_modinfo_get_filter(&mod_info, path, session, &set))) {
-        goto cleanup_mods_unlock;
-    }
+    return NULL;
 
-    if (set->number > 1) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "More subtrees match \"%s\".", path);
-        goto cleanup_mods_unlock;
-    } else if (!set->number) {
-        sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, NULL, "No data found for \"%s\".", path);
-        goto cleanup_mods_unlock;
-    }
+error_mods_unlock:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(mod_info, 0);
 
-    /* create return value */
-    *value = malloc(sizeof **value);
-    SR_CHECK_MEM_GOTO(!*value, err_info, cleanup_mods_unlock);
+error_shm_unlock:
+    /* SHM UNLOCK */
+    sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
+    return err_info;
+}
 
-    if ((err_info = sr_val_ly2sr(set->set.d[0], *value))) {
-        goto cleanup_mods_unlock;
+/**
+ * @brief MODULES and SHM unlock after a get operation locked by ::sr_get_mods_lock.
+ *
+ * @param[in] session Session to use.
+ * @param[in] mod_info Mod info with the locked modules.
+ */
+static void
+sr_get_mods_unlock(sr_session_ctx_t *session, struct sr_mod_info_s *mod_info)
+{
+    if (sr_get_read_txn(session)) {
+        /* nothing was locked */
+        return;
     }
 
-    /* success */
-
-cleanup_mods_unlock:
     /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info, 0);
+    sr_shmmod_modinfo_unlock(mod_info, 0);
 
-cleanup_shm_unlock:
     /* SHM UNLOCK */
     sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
+}
 
-    ly_set_free(set);
-    sr_modinfo_free(&mod_info);
-    if (cb_err_info) {
-        /* return callback error if some was generated */
-        sr_errinfo_merge(&err_info, cb_err_info);
-        err_info->err_code = SR_ERR_CALLBACK_FAILED;
+/**
+ * @brief Load data of the required modules and select the requested nodes.
+ * Read transaction snapshot of the session is used, if there is one.
+ *
+ * @param[in] session Session to use.
+ * @param[in] mod_info Mod info with the required modules.
+ * @param[in] xpath Selected data.
+ * @param[in] filter_xpath Optional XPath selecting only some of the nodes selected by @p xpath, which are then returned.
+ * @param[in] cache Whether it is safe to use cached data.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] opts Get oper data options.
+ * @param[out] set Set of the selected nodes.
+ * @param[out] cb_err_info Callback error info returned by operational subscribers, if any.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_get_load_filter(sr_session_ctx_t *session, struct sr_mod_info_s *mod_info, const char *xpath, const char *filter_xpath,
+        int cache, uint32_t timeout_ms, sr_get_oper_options_t opts, struct ly_set **set, sr_error_info_t **cb_err_info)
+{
+    sr_error_info_t *err_info = NULL;
+
+    if (sr_get_read_txn(session)) {
+        /* filter the snapshot of the read transaction */
+        *set = session->read_txn.data ? lyd_find_path(session->read_txn.data, filter_xpath ? filter_xpath : xpath)
+                : ly_set_new();
+        if (!*set) {
+            sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
+        }
+        return err_info;
     }
-    return sr_api_ret(session, err_info);
+
+    /* load modules data */
+    if ((err_info = sr_modinfo_data_load(mod_info, MOD_INFO_REQ, cache, &session->sid, xpath, timeout_ms, opts,
+            cb_err_info)) || *cb_err_info) {
+        return err_info;
+    }
+
+    /* filter the required data */
+    return sr_modinfo_get_filter(mod_info, filter_xpath ? filter_xpath : xpath, session, set);
 }
 
-API int
-sr_get_items(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms, const sr_get_oper_options_t opts,
-        sr_val_t **values, size_t *value_cnt)
+/**
+ * @brief Create the union of several XPaths.
+ *
+ * @param[in] xpaths Array of XPaths.
+ * @param[in] xpath_count Count of @p xpaths.
+ * @param[out] union_xpath Union of all the XPaths.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_union(const char **xpaths, uint32_t xpath_count, char **union_xpath)
 {
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    struct ly_set *set = NULL;
-    struct sr_mod_info_s mod_info;
+    sr_error_info_t *err_info = NULL;
     uint32_t i;
+    size_t len;
 
-    SR_CHECK_ARG_APIRET(!session || !xpath || !values || !value_cnt || ((session->ds != SR_DS_OPERATIONAL) && opts),
-            session, err_info);
-
-    if (!timeout_ms) {
-        timeout_ms = SR_OPER_CB_TIMEOUT;
+    len = 0;
+    for (i = 0; i < xpath_count; ++i) {
+        len += strlen(xpaths[i]) + 3;
     }
-    *values = NULL;
-    *value_cnt = 0;
-    memset(&mod_info, 0, sizeof mod_info);
+    *union_xpath = malloc(len + 1);
+    SR_CHECK_MEM_RET(!*union_xpath, err_info);
 
-    /* SHM LOCK */
-    if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
-        return sr_api_ret(session, err_info);
+    len = 0;
+    for (i = 0; i < xpath_count; ++i) {
+        len += sprintf(*union_xpath + len, "%s%s", i ? " | " : "", xpaths[i]);
     }
 
-    /* collect all required modules */
-    if ((err_info = sr_shmmod_collect_xpath(session->conn, xpath, session->ds, &mod_info))) {
-        goto cleanup_shm_unlock;
-    }
+    return NULL;
+}
 
-    /* check read perm */
-    if ((err_info = sr_modinfo_perm_check(&mod_info, 0))) {
-        goto cleanup_shm_unlock;
+API int
+sr_read_begin(sr_session_ctx_t *session, const char **xpaths, uint32_t xpath_count, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    struct sr_mod_info_s mod_info;
+    char *union_xpath = NULL;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!session || !xpaths || !xpath_count || (session->ev != SR_SUB_EV_NONE)
+            || ((session->ds != SR_DS_OPERATIONAL) && opts), session, err_info);
+    for (i = 0; i < xpath_count; ++i) {
+        SR_CHECK_ARG_APIRET(!xpaths[i], session, err_info);
     }
 
-    /* MODULES READ LOCK */
-    if ((err_info = sr_shmmod_modinfo_rdlock(&mod_info, 0, session->sid))) {
-        goto cleanup_mods_unlock;
+    if (session->read_txn.active) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Read transaction already started.");
+        return sr_api_ret(session, err_info);
     }
 
-    /* load modules data */
-    if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_REQ, 1, &session->sid, xpath, timeout_ms, opts, &cb_err_info))
-            || cb_err_info) {
-        goto cleanup_mods_unlock;
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
     }
+    memset(&mod_info, 0, sizeof mod_info);
 
-    /* filter the required data */
-    if ((err_info = sr_modinfo_get_filter(&mod_info, xpath, session, &set))) {
-        goto cleanup_mods_unlock;
+    /* the snapshot is formed by the data selected by all the paths */
+    if ((err_info = sr_xpath_union(xpaths, xpath_count, &union_xpath))) {
+        return sr_api_ret(session, err_info);
     }
 
-    if (set->number) {
-        *values = calloc(set->number, sizeof **values);
-        SR_CHECK_MEM_GOTO(!*values, err_info, cleanup_mods_unlock);
+    /* SHM LOCK, collect all required modules of all the paths, check read perm, and MODULES READ LOCK */
+    if ((err_info = sr_get_mods_lock(session, union_xpath, NULL, &mod_info))) {
+        goto cleanup;
     }
 
-    for (i = 0; i < set->number; ++i) {
-        if ((err_info = sr_val_ly2sr(set->set.d[i], (*values) + i))) {
-            goto cleanup_mods_unlock;
-        }
-        ++(*value_cnt);
+    /* load modules data only once, providers are asked for the union of the paths, and never use the cache because
+     * the data are kept after the modules are unlocked */
+    if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_REQ, 0, &session->sid, union_xpath, timeout_ms, opts,
+            &cb_err_info)) || cb_err_info) {
+        goto cleanup_unlock;
     }
 
+    /* keep the data as the snapshot */
+    session->read_txn.data = mod_info.data;
+    mod_info.data = NULL;
+    session->read_txn.ds = session->ds;
+    session->read_txn.active = 1;
+
     /* success */
 
-cleanup_mods_unlock:
+cleanup_unlock:
     /* MODULES UNLOCK */
     sr_shmmod_modinfo_unlock(&mod_info, 0);
 
-cleanup_shm_unlock:
     /* SHM UNLOCK */
     sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
 
-    ly_set_free(set);
+cleanup:
+    free(union_xpath);
     sr_modinfo_free(&mod_info);
     if (cb_err_info) {
         /* return callback error if some was generated */
         sr_errinfo_merge(&err_info, cb_err_info);
         err_info->err_code = SR_ERR_CALLBACK_FAILED;
     }
-    if (err_info) {
-        sr_free_values(*values, *value_cnt);
-        *values = NULL;
-        *value_cnt = 0;
-    }
     return sr_api_ret(session, err_info);
 }
 
 API int
-sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, struct lyd_node **subtree)
+sr_read_end(sr_session_ctx_t *session)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session, session, err_info);
+
+    /* free the snapshot */
+    session->read_txn.active = 0;
+    lyd_free_withsiblings(session->read_txn.data);
+    session->read_txn.data = NULL;
+
+    return sr_api_ret(session, NULL);
+}
+
+API int
+sr_get_item(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, sr_val_t **value)
 {
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    struct sr_mod_info_s mod_info;
     struct ly_set *set = NULL;
+    struct sr_mod_info_s mod_info;
 
-    SR_CHECK_ARG_APIRET(!session || !path || !subtree, session, err_info);
+    SR_CHECK_ARG_APIRET(!session || !path || !value, session, err_info);
 
     if (!timeout_ms) {
         timeout_ms = SR_OPER_CB_TIMEOUT;
     }
+    *value = NULL;
     memset(&mod_info, 0, sizeof mod_info);
 
-    /* SHM LOCK */
-    if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
-        return sr_api_ret(session, err_info);
-    }
-
-    /* collect all required modules */
-    if ((err_info = sr_shmmod_collect_xpath(session->conn, path, session->ds, &mod_info))) {
-        goto cleanup_shm_unlock;
+    /* SHM LOCK, collect all required modules, check read perm, and MODULES READ LOCK */
+    if ((err_info = sr_get_mods_lock(session, path, NULL, &mod_info))) {
+        goto cleanup;
     }
 
-    /* check read perm */
-    if ((err_info = sr_modinfo_perm_check(&mod_info, 0))) {
-        goto cleanup_shm_unlock;
+    /* load modules data and filter the required data */
+    if ((err_info = sr_get_load_filter(session, &mod_info, path, NULL, 1, timeout_ms, 0, &set, &cb_err_info)) || cb_err_info) {
+        goto cleanup_unlock;
     }
 
-    /* MODULES READ LOCK */
-    if ((err_info = sr_shmmod_modinfo_rdlock(&mod_info, 0, session->sid))) {
-        goto cleanup_mods_unlock;
+    if (set->number > 1) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "More subtrees match \"%s\".", path);
+        goto cleanup_unlock;
+    } else if (!set->number) {
+        sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, NULL, "No data found for \"%s\".", path);
+        goto cleanup_unlock;
     }
 
-    /* load modules data */
-    if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_REQ, 1, &session->sid, path, timeout_ms, 0, &cb_err_info))
+    /* create return value */
+    *value = malloc(sizeof **value);
+    SR_CHECK_MEM_GOTO(!*value, err_info, cleanup_unlock);
+
+    if ((err_info = sr_val_ly2sr(set->set.d[0], *value))) {
+        goto cleanup_unlock;
+    }
+
+    /* success */
+
+cleanup_unlock:
+    /* MODULES UNLOCK, SHM UNLOCK */
+    sr_get_mods_unlock(session, &mod_info);
+
+cleanup:
+    ly_set_free(set);
+    sr_modinfo_free(&mod_info);
+    if (cb_err_info) {
+        /* return callback error if some was generated */
+        sr_errinfo_merge(&err_info, cb_err_info);
+        err_info->err_code = SR_ERR_CALLBACK_FAILED;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+/**
+ * @brief Retrieve an array of data elements selected by an XPath.
+ *
+ * @param[in] session Session to use.
+ * @param[in] xpath Selected data.
+ * @param[in] prepared Optional prepared @p xpath.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] opts Get oper data options.
+ * @param[out] values Array of the selected data elements.
+ * @param[out] value_cnt Number of @p values.
+ * @return err_code (SR_ERR_OK on success).
+ */
+static int
+_sr_get_items(sr_session_ctx_t *session, const char *xpath, const sr_xpath_t *prepared, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts, sr_val_t **values, size_t *value_cnt)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    struct ly_set *set = NULL;
+    struct sr_mod_info_s mod_info;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!session || !xpath || !values || !value_cnt || ((session->ds != SR_DS_OPERATIONAL) && opts),
+            session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
+    }
+    *values = NULL;
+    *value_cnt = 0;
+    memset(&mod_info, 0, sizeof mod_info);
+
+    /* SHM LOCK, collect all required modules, check read perm, and MODULES READ LOCK */
+    if ((err_info = sr_get_mods_lock(session, xpath, prepared, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* load modules data and filter the required data */
+    if ((err_info = sr_get_load_filter(session, &mod_info, xpath, NULL, 1, timeout_ms, opts, &set, &cb_err_info))
             || cb_err_info) {
-        goto cleanup_mods_unlock;
+        goto cleanup_unlock;
+    }
+
+    if (set->number) {
+        *values = calloc(set->number, sizeof **values);
+        SR_CHECK_MEM_GOTO(!*values, err_info, cleanup_unlock);
+    }
+
+    for (i = 0; i < set->number; ++i) {
+        if ((err_info = sr_val_ly2sr(set->set.d[i], (*values) + i))) {
+            goto cleanup_unlock;
+        }
+        ++(*value_cnt);
+    }
+
+    /* success */
+
+cleanup_unlock:
+    /* MODULES UNLOCK, SHM UNLOCK */
+    sr_get_mods_unlock(session, &mod_info);
+
+cleanup:
+    ly_set_free(set);
+    sr_modinfo_free(&mod_info);
+    if (cb_err_info) {
+        /* return callback error if some was generated */
+        sr_errinfo_merge(&err_info, cb_err_info);
+        err_info->err_code = SR_ERR_CALLBACK_FAILED;
+    }
+    if (err_info) {
+        sr_free_values(*values, *value_cnt);
+        *values = NULL;
+        *value_cnt = 0;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_get_items(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms, const sr_get_oper_options_t opts,
+        sr_val_t **values, size_t *value_cnt)
+{
+    return _sr_get_items(session, xpath, NULL, timeout_ms, opts, values, value_cnt);
+}
+
+API int
+sr_get_items_prepared(sr_session_ctx_t *session, const sr_xpath_t *prepared, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts, sr_val_t **values, size_t *value_cnt)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !prepared || (prepared->conn != session->conn), session, err_info);
+
+    return _sr_get_items(session, prepared->xpath, prepared, timeout_ms, opts, values, value_cnt);
+}
+
+API int
+sr_get_items_iter(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms, const sr_get_oper_options_t opts,
+        sr_val_iter_t **iter)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    struct ly_set *set = NULL;
+    struct sr_mod_info_s mod_info;
+
+    SR_CHECK_ARG_APIRET(!session || !xpath || !iter || ((session->ds != SR_DS_OPERATIONAL) && opts), session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
+    }
+    *iter = NULL;
+    memset(&mod_info, 0, sizeof mod_info);
+
+    /* SHM LOCK, collect all required modules, check read perm, and MODULES READ LOCK */
+    if ((err_info = sr_get_mods_lock(session, xpath, NULL, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* load modules data and filter the required data, never use the cache directly because the data are kept
+     * after the modules are unlocked */
+    if ((err_info = sr_get_load_filter(session, &mod_info, xpath, NULL, 0, timeout_ms, opts, &set, &cb_err_info))
+            || cb_err_info) {
+        goto cleanup_unlock;
+    }
+
+    /* create the iterator, it takes the data */
+    *iter = malloc(sizeof **iter);
+    SR_CHECK_MEM_GOTO(!*iter, err_info, cleanup_unlock);
+    (*iter)->data = mod_info.data;
+    mod_info.data = NULL;
+    (*iter)->set = set;
+    set = NULL;
+    (*iter)->idx = 0;
+
+    /* success */
+
+cleanup_unlock:
+    /* MODULES UNLOCK, SHM UNLOCK */
+    sr_get_mods_unlock(session, &mod_info);
+
+cleanup:
+    ly_set_free(set);
+    sr_modinfo_free(&mod_info);
+    if (cb_err_info) {
+        /* return callback error if some was generated */
+        sr_errinfo_merge(&err_info, cb_err_info);
+        err_info->err_code = SR_ERR_CALLBACK_FAILED;
+    }
+    if (err_info) {
+        sr_free_val_iter(*iter);
+        *iter = NULL;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_get_item_next(sr_session_ctx_t *session, sr_val_iter_t *iter, sr_val_t **value)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !iter || !value, session, err_info);
+
+    *value = NULL;
+    if (iter->idx == iter->set->number) {
+        /* no more elements */
+        return SR_ERR_NOT_FOUND;
+    }
+
+    /* create return value */
+    *value = calloc(1, sizeof **value);
+    SR_CHECK_MEM_GOTO(!*value, err_info, cleanup);
+
+    if ((err_info = sr_val_ly2sr(iter->set->set.d[iter->idx], *value))) {
+        goto cleanup;
+    }
+    ++iter->idx;
+
+    /* success */
+
+cleanup:
+    if (err_info) {
+        sr_free_val(*value);
+        *value = NULL;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_get_items_next(sr_session_ctx_t *session, sr_val_iter_t *iter, size_t max_count, sr_val_t **values,
+        size_t *value_cnt)
+{
+    sr_error_info_t *err_info = NULL;
+    size_t count;
+
+    SR_CHECK_ARG_APIRET(!session || !iter || !max_count || !values || !value_cnt, session, err_info);
+
+    *values = NULL;
+    *value_cnt = 0;
+    if (iter->idx == iter->set->number) {
+        /* no more elements */
+        return SR_ERR_NOT_FOUND;
+    }
+
+    count = iter->set->number - iter->idx;
+    if (count > max_count) {
+        count = max_count;
+    }
+
+    *values = calloc(count, sizeof **values);
+    SR_CHECK_MEM_GOTO(!*values, err_info, cleanup);
+
+    /* convert only this chunk */
+    while (*value_cnt < count) {
+        if ((err_info = sr_val_ly2sr(iter->set->set.d[iter->idx + *value_cnt], (*values) + *value_cnt))) {
+            goto cleanup;
+        }
+        ++(*value_cnt);
+    }
+    iter->idx += count;
+
+    /* success */
+
+cleanup:
+    if (err_info) {
+        sr_free_values(*values, *value_cnt);
+        *values = NULL;
+        *value_cnt = 0;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API void
+sr_free_val_iter(sr_val_iter_t *iter)
+{
+    if (!iter) {
+        return;
+    }
+
+    ly_set_free(iter->set);
+    lyd_free_withsiblings(iter->data);
+    free(iter);
+}
+
+API int
+sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms, struct lyd_node **subtree)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    struct sr_mod_info_s mod_info;
+    struct ly_set *set = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !path || !subtree, session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
+    }
+    memset(&mod_info, 0, sizeof mod_info);
+
+    /* SHM LOCK, collect all required modules, check read perm, and MODULES READ LOCK */
+    if ((err_info = sr_get_mods_lock(session, path, NULL, &mod_info))) {
+        goto cleanup;
+    }
+
+    /* load modules data and filter the required data */
+    if ((err_info = sr_get_load_filter(session, &mod_info, path, NULL, 1, timeout_ms, 0, &set, &cb_err_info)) || cb_err_info) {
+        goto cleanup_unlock;
+    }
+
+    if (set->number > 1) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "More subtrees match \"%s\".", path);
+        goto cleanup_unlock;
+    }
+
+    if (set->number == 1) {
+        *subtree = lyd_dup(set->set.d[0], LYD_DUP_OPT_RECURSIVE);
+        if (!*subtree) {
+            sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
+            goto cleanup_unlock;
+        }
+    } else {
+        *subtree = NULL;
+    }
+
+    /* success */
+
+cleanup_unlock:
+    /* MODULES UNLOCK, SHM UNLOCK */
+    sr_get_mods_unlock(session, &mod_info);
+
+cleanup:
+    ly_set_free(set);
+    sr_modinfo_free(&mod_info);
+    if (cb_err_info) {
+        /* return callback error if some was generated */
+        sr_errinfo_merge(&err_info, cb_err_info);
+        err_info->err_code = SR_ERR_CALLBACK_FAILED;
+    }
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts, struct lyd_node **data)
+{
+    return sr_get_data_page(session, xpath, max_depth, NULL, 0, 0, timeout_ms, opts, data);
+}
+
+/**
+ * @brief Duplicate selected subtrees with their parents and merge them into one data tree.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] subtrees Set of the selected subtrees.
+ * @param[in] start Index of the first subtree to duplicate.
+ * @param[in] end Index after the last subtree to duplicate.
+ * @param[in] max_depth Maximum depth of the subtrees, 0 for unlimited.
+ * @param[out] data Connected top-level trees with the duplicated subtrees, NULL if none.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_get_subtrees_dup(sr_conn_ctx_t *conn, const struct ly_set *subtrees, uint32_t start, uint32_t end,
+        uint32_t max_depth, struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+    uint32_t i;
+    int dup_opts;
+
+    *data = NULL;
+    for (i = start; i < end; ++i) {
+        dup_opts = (max_depth ? 0 : LYD_DUP_OPT_RECURSIVE) | LYD_DUP_OPT_WITH_PARENTS | LYD_DUP_OPT_WITH_KEYS | LYD_DUP_OPT_WITH_WHEN;
+        node = lyd_dup(subtrees->set.d[i], dup_opts);
+        if (!node) {
+            sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+            goto error;
+        }
+
+        /* duplicate only to the specified depth */
+        if ((err_info = sr_lyd_dup(subtrees->set.d[i], max_depth ? max_depth - 1 : 0, node))) {
+            lyd_free_withsiblings(node);
+            goto error;
+        }
+
+        /* always find parent */
+        while (node->parent) {
+            node = node->parent;
+        }
+
+        /* connect to the result */
+        if (!*data) {
+            *data = node;
+        } else {
+            if (lyd_merge(*data, node, LYD_OPT_DESTRUCT)) {
+                sr_errinfo_new_ly(&err_info, conn->ly_ctx);
+                lyd_free_withsiblings(node);
+                goto error;
+            }
+        }
+    }
+
+    return NULL;
+
+error:
+    lyd_free_withsiblings(*data);
+    *data = NULL;
+    return err_info;
+}
+
+/**
+ * @brief Learn whether the nodes selected by an XPath can be paged directly as siblings. That is the case
+ * if the XPath is a simple path to a list or leaf-list with a single parent instance.
+ *
+ * @param[in] ly_ctx libyang context.
+ * @param[in] xpath Selected data.
+ * @return Schema node of the selected instances, NULL if they cannot be paged directly.
+ */
+static const struct lys_node *
+sr_get_page_schema(const struct ly_ctx *ly_ctx, const char *xpath)
+{
+    const struct lys_node *snode, *parent;
+
+    if ((xpath[0] != '/') || strpbrk(xpath, "[]()*|=<> ") || strstr(xpath, "//") || strstr(xpath, "..")) {
+        /* not a simple path */
+        return NULL;
+    }
+
+    snode = ly_ctx_get_node(ly_ctx, NULL, xpath, 0);
+    if (!snode || !(snode->nodetype & (LYS_LIST | LYS_LEAFLIST))) {
+        return NULL;
+    }
+
+    /* there may be several parent instances, the instances would not be siblings */
+    for (parent = lys_parent(snode); parent; parent = lys_parent(parent)) {
+        if (parent->nodetype == LYS_LIST) {
+            return NULL;
+        }
+    }
+
+    return snode;
+}
+
+/**
+ * @brief Retrieve a page of subtrees whose root nodes match an XPath.
+ *
+ * @param[in] session Session to use.
+ * @param[in] xpath Selected data.
+ * @param[in] prepared Optional prepared @p xpath.
+ * @param[in] max_depth Maximum depth of the selected subtrees, 0 for unlimited.
+ * @param[in] after_path Optional path of the node to return the subtrees after.
+ * @param[in] offset Number of the selected subtrees to skip.
+ * @param[in] limit Maximum number of returned subtrees, 0 for no limit.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds.
+ * @param[in] opts Get oper data options.
+ * @param[out] data Connected top-level trees with the selected data.
+ * @return err_code (SR_ERR_OK on success).
+ */
+static int
+_sr_get_data(sr_session_ctx_t *session, const char *xpath, const sr_xpath_t *prepared, uint32_t max_depth,
+        const char *after_path, uint32_t offset, uint32_t limit, uint32_t timeout_ms, const sr_get_oper_options_t opts,
+        struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    uint32_t start, end;
+    struct sr_mod_info_s mod_info;
+    struct ly_set *subtrees = NULL, *set = NULL;
+    const struct lys_node *page_snode = NULL;
+    struct lyd_node *node;
+    char *filter_xpath = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !xpath || !data || ((session->ds != SR_DS_OPERATIONAL) && opts), session, err_info);
+
+    if (!timeout_ms) {
+        timeout_ms = SR_OPER_CB_TIMEOUT;
     }
+    *data = NULL;
+    memset(&mod_info, 0, sizeof mod_info);
 
-    /* filter the required data */
-    if ((err_info = sr_modinfo_get_filter(&mod_info, path, session, &set))) {
-        goto cleanup_mods_unlock;
+    /* SHM LOCK, collect all required modules, check read perm, and MODULES READ LOCK */
+    if ((err_info = sr_get_mods_lock(session, xpath, prepared, &mod_info))) {
+        goto cleanup;
     }
 
-    if (set->number > 1) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "More subtrees match \"%s\".", path);
-        goto cleanup_mods_unlock;
+    if (after_path || offset || limit) {
+        page_snode = sr_get_page_schema(session->conn->ly_ctx, xpath);
+    }
+    if (page_snode && limit && !sr_get_read_txn(session)) {
+        /* operational providers of the paged instances can return only the page */
+        mod_info.oper_page.snode = page_snode;
+        mod_info.oper_page.after_path = after_path;
+        mod_info.oper_page.count = (offset > UINT32_MAX - limit) ? UINT32_MAX : offset + limit;
+    }
+    if (page_snode) {
+        /* select only the first node of the page, the following ones are its siblings */
+        if (after_path) {
+            filter_xpath = strdup(after_path);
+            SR_CHECK_MEM_GOTO(!filter_xpath, err_info, cleanup_unlock);
+        } else if (asprintf(&filter_xpath, "%s[1]", xpath) == -1) {
+            filter_xpath = NULL;
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup_unlock;
+        }
     }
 
-    if (set->number == 1) {
-        *subtree = lyd_dup(set->set.d[0], LYD_DUP_OPT_RECURSIVE);
-        if (!*subtree) {
-            sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
-            goto cleanup_mods_unlock;
+    /* load modules data and filter the required data */
+    if ((err_info = sr_get_load_filter(session, &mod_info, xpath, filter_xpath, 1, timeout_ms, opts, &subtrees,
+            &cb_err_info)) || cb_err_info) {
+        goto cleanup_unlock;
+    }
+
+    if (page_snode) {
+        if (after_path && ((subtrees->number != 1) || (subtrees->set.d[0]->schema != page_snode))) {
+            sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, NULL, "Path \"%s\" does not identify a single node selected"
+                    " by \"%s\".", after_path, xpath);
+            goto cleanup_unlock;
         }
-    } else {
-        *subtree = NULL;
+
+        /* collect the page from the following instances */
+        node = subtrees->number ? subtrees->set.d[0] : NULL;
+        if (node && after_path) {
+            node = node->next;
+        }
+        ly_set_clean(subtrees);
+        for (; node && (!limit || (subtrees->number < limit)); node = node->next) {
+            if (node->schema != page_snode) {
+                continue;
+            }
+            if (offset) {
+                --offset;
+                continue;
+            }
+            if (ly_set_add(subtrees, node, LY_SET_OPT_USEASLIST) == -1) {
+                sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
+                goto cleanup_unlock;
+            }
+        }
+
+        /* duplicate the page of the subtrees with their parents and merge into one data tree */
+        if ((err_info = sr_get_subtrees_dup(session->conn, subtrees, 0, subtrees->number, max_depth, data))) {
+            goto cleanup_unlock;
+        }
+        goto cleanup_unlock;
     }
 
-    /* success */
+    /* learn the first returned subtree, generic XPath so the whole result is searched */
+    start = 0;
+    if (after_path) {
+        if (subtrees->number) {
+            set = lyd_find_path(subtrees->set.d[0], after_path);
+            if (!set) {
+                sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
+                goto cleanup_unlock;
+            }
+        }
+        if (set && (set->number == 1)) {
+            for (start = 0; start < subtrees->number; ++start) {
+                if (subtrees->set.d[start] == set->set.d[0]) {
+                    break;
+                }
+            }
+        }
+        if (!set || (set->number != 1) || (start == subtrees->number)) {
+            sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, NULL, "Path \"%s\" does not identify a single node selected"
+                    " by \"%s\".", after_path, xpath);
+            goto cleanup_unlock;
+        }
 
-cleanup_mods_unlock:
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info, 0);
+        /* start right after it */
+        ++start;
+    }
+    start = (offset < subtrees->number - start) ? start + offset : subtrees->number;
 
-cleanup_shm_unlock:
-    /* SHM UNLOCK */
-    sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
+    /* learn the last returned subtree */
+    end = (limit && (limit < subtrees->number - start)) ? start + limit : subtrees->number;
+
+    /* duplicate only the requested page of the subtrees with their parents and merge into one data tree */
+    if ((err_info = sr_get_subtrees_dup(session->conn, subtrees, start, end, max_depth, data))) {
+        goto cleanup_unlock;
+    }
+
+    /* success */
+
+cleanup_unlock:
+    /* MODULES UNLOCK, SHM UNLOCK */
+    sr_get_mods_unlock(session, &mod_info);
 
+cleanup:
+    free(filter_xpath);
+    ly_set_free(subtrees);
     ly_set_free(set);
     sr_modinfo_free(&mod_info);
     if (cb_err_info) {
@@ -1771,105 +2461,106 @@ cleanup_shm_unlock:
 }
 
 API int
-sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
+sr_get_data_page(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, const char *after_path,
+        uint32_t offset, uint32_t limit, uint32_t timeout_ms, const sr_get_oper_options_t opts, struct lyd_node **data)
+{
+    return _sr_get_data(session, xpath, NULL, max_depth, after_path, offset, limit, timeout_ms, opts, data);
+}
+
+API int
+sr_get_data_prepared(sr_session_ctx_t *session, const sr_xpath_t *prepared, uint32_t max_depth, uint32_t timeout_ms,
         const sr_get_oper_options_t opts, struct lyd_node **data)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !prepared || (prepared->conn != session->conn), session, err_info);
+
+    return _sr_get_data(session, prepared->xpath, prepared, max_depth, NULL, 0, 0, timeout_ms, opts, data);
+}
+
+API int
+sr_get_data_multi(sr_session_ctx_t *session, const char **xpaths, const uint32_t *max_depths, uint32_t xpath_count,
+        uint32_t timeout_ms, const sr_get_oper_options_t opts, struct lyd_node **data)
 {
     sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    uint32_t i;
-    int dup_opts;
     struct sr_mod_info_s mod_info;
-    struct ly_set *subtrees = NULL;
-    struct lyd_node *node;
+    struct ly_set *set = NULL;
+    struct lyd_node *root;
+    char *union_xpath = NULL;
+    uint32_t i;
 
-    SR_CHECK_ARG_APIRET(!session || !xpath || !data || ((session->ds != SR_DS_OPERATIONAL) && opts), session, err_info);
+    SR_CHECK_ARG_APIRET(!session || !xpaths || !xpath_count || !data || ((session->ds != SR_DS_OPERATIONAL) && opts),
+            session, err_info);
 
     if (!timeout_ms) {
         timeout_ms = SR_OPER_CB_TIMEOUT;
     }
-    *data = NULL;
+    memset(data, 0, xpath_count * sizeof *data);
     memset(&mod_info, 0, sizeof mod_info);
 
-    /* SHM LOCK */
-    if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
-        return sr_api_ret(session, err_info);
-    }
-
-    /* collect all required modules */
-    if ((err_info = sr_shmmod_collect_xpath(session->conn, xpath, session->ds, &mod_info))) {
-        goto cleanup_shm_unlock;
+    /* create the union of all the paths */
+    for (i = 0; i < xpath_count; ++i) {
+        SR_CHECK_ARG_APIRET(!xpaths[i], session, err_info);
     }
-
-    /* check read perm */
-    if ((err_info = sr_modinfo_perm_check(&mod_info, 0))) {
-        goto cleanup_shm_unlock;
+    if ((err_info = sr_xpath_union(xpaths, xpath_count, &union_xpath))) {
+        return sr_api_ret(session, err_info);
     }
 
-    /* MODULES READ LOCK */
-    if ((err_info = sr_shmmod_modinfo_rdlock(&mod_info, 0, session->sid))) {
-        goto cleanup_mods_unlock;
+    /* SHM LOCK, collect all required modules, check read perm, and MODULES READ LOCK */
+    if ((err_info = sr_get_mods_lock(session, union_xpath, NULL, &mod_info))) {
+        goto cleanup;
     }
 
-    /* load modules data */
-    if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_REQ, 1, &session->sid, xpath, timeout_ms, opts, &cb_err_info))
+    /* load modules data only once, providers are asked for the union of the paths */
+    if ((err_info = sr_get_load_filter(session, &mod_info, union_xpath, NULL, 1, timeout_ms, opts, &set, &cb_err_info))
             || cb_err_info) {
-        goto cleanup_mods_unlock;
+        goto cleanup_unlock;
+    }
+    if (!set->number) {
+        /* no data selected by any path */
+        goto cleanup_unlock;
     }
 
-    /* filter the required data */
-    if ((err_info = sr_modinfo_get_filter(&mod_info, xpath, session, &subtrees))) {
-        goto cleanup_mods_unlock;
+    /* learn the data tree the paths are evaluated on */
+    root = set->set.d[0];
+    while (root->parent) {
+        root = root->parent;
     }
+    ly_set_free(set);
+    set = NULL;
 
-    /* duplicate all returned subtrees with their parents and merge into one data tree */
-    for (i = 0; i < subtrees->number; ++i) {
-        dup_opts = (max_depth ? 0 : LYD_DUP_OPT_RECURSIVE) | LYD_DUP_OPT_WITH_PARENTS | LYD_DUP_OPT_WITH_KEYS | LYD_DUP_OPT_WITH_WHEN;
-        node = lyd_dup(subtrees->set.d[i], dup_opts);
-        if (!node) {
+    /* filter the data of every path */
+    for (i = 0; i < xpath_count; ++i) {
+        set = lyd_find_path(root, xpaths[i]);
+        if (!set) {
             sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
-            lyd_free_withsiblings(*data);
-            *data = NULL;
-            goto cleanup_mods_unlock;
-        }
-
-        /* duplicate only to the specified depth */
-        if ((err_info = sr_lyd_dup(subtrees->set.d[i], max_depth ? max_depth - 1 : 0, node))) {
-            lyd_free_withsiblings(node);
-            lyd_free_withsiblings(*data);
-            *data = NULL;
-            goto cleanup_mods_unlock;
-        }
-
-        /* always find parent */
-        while (node->parent) {
-            node = node->parent;
+            goto cleanup_unlock;
         }
 
-        /* connect to the result */
-        if (!*data) {
-            *data = node;
-        } else {
-            if (lyd_merge(*data, node, LYD_OPT_DESTRUCT)) {
-                sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
-                lyd_free_withsiblings(node);
-                lyd_free_withsiblings(*data);
-                *data = NULL;
-                goto cleanup_mods_unlock;
-            }
+        if ((err_info = sr_get_subtrees_dup(session->conn, set, 0, set->number, max_depths ? max_depths[i] : 0,
+                &data[i]))) {
+            goto cleanup_unlock;
         }
+        ly_set_free(set);
+        set = NULL;
     }
 
     /* success */
 
-cleanup_mods_unlock:
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info, 0);
-
-cleanup_shm_unlock:
-    /* SHM UNLOCK */
-    sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
+cleanup_unlock:
+    /* MODULES UNLOCK, SHM UNLOCK */
+    sr_get_mods_unlock(session, &mod_info);
 
-    ly_set_free(subtrees);
+cleanup:
+    ly_set_free(set);
+    free(union_xpath);
     sr_modinfo_free(&mod_info);
+    if (err_info || cb_err_info) {
+        for (i = 0; i < xpath_count; ++i) {
+            lyd_free_withsiblings(data[i]);
+            data[i] = NULL;
+        }
+    }
     if (cb_err_info) {
         /* return callback error if some was generated */
         sr_errinfo_merge(&err_info, cb_err_info);
@@ -1878,6 +2569,93 @@ cleanup_shm_unlock:
     return sr_api_ret(session, err_info);
 }
 
+/**
+ * @brief Resolve the modules of a prepared XPath with all their dependencies.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] mods Modules with selected data.
+ * @param[in] ds Datastore.
+ * @param[out] rmods Resolved modules.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_xpath_prepare_resolve(sr_conn_ctx_t *conn, const struct ly_set *mods, sr_datastore_t ds, struct sr_xpath_mods_s *rmods)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_s mod_info;
+
+    memset(&mod_info, 0, sizeof mod_info);
+
+    /* collect the modules and their dependencies the same way a get would */
+    if ((err_info = sr_shmmod_collect_xpath_modules(conn, mods, ds, &mod_info))) {
+        sr_modinfo_free(&mod_info);
+        return err_info;
+    }
+
+    /* keep them */
+    rmods->mods = mod_info.mods;
+    rmods->mod_count = mod_info.mod_count;
+    return NULL;
+}
+
+API int
+sr_xpath_prepare(sr_conn_ctx_t *conn, const char *xpath, sr_xpath_t **prepared)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *conv_mods = NULL, *oper_mods = NULL;
+
+    SR_CHECK_ARG_APIRET(!conn || !xpath || !prepared, NULL, err_info);
+
+    *prepared = calloc(1, sizeof **prepared);
+    SR_CHECK_MEM_GOTO(!*prepared, err_info, cleanup);
+    (*prepared)->conn = conn;
+    (*prepared)->xpath = strdup(xpath);
+    conv_mods = ly_set_new();
+    oper_mods = ly_set_new();
+    SR_CHECK_MEM_GOTO(!(*prepared)->xpath || !conv_mods || !oper_mods, err_info, cleanup);
+
+    /* learn the modules with selected data for all the datastores at once */
+    if ((err_info = sr_shmmod_xpath_modules(conn, xpath, conv_mods, oper_mods))) {
+        goto cleanup;
+    }
+
+    /* SHM LOCK */
+    if ((err_info = sr_shmmain_lock_remap(conn, SR_LOCK_READ, 0, 0, __func__))) {
+        goto cleanup;
+    }
+
+    /* resolve their dependencies, these are given only by the schemas so they stay valid until the context changes */
+    (*prepared)->mod_set_id = ly_ctx_get_module_set_id(conn->ly_ctx);
+    if (!(err_info = sr_xpath_prepare_resolve(conn, conv_mods, SR_DS_RUNNING, &(*prepared)->conv))) {
+        err_info = sr_xpath_prepare_resolve(conn, oper_mods, SR_DS_OPERATIONAL, &(*prepared)->oper);
+    }
+
+    /* SHM UNLOCK */
+    sr_shmmain_unlock(conn, SR_LOCK_READ, 0, 0, __func__);
+
+cleanup:
+    ly_set_free(conv_mods);
+    ly_set_free(oper_mods);
+    if (err_info) {
+        sr_xpath_free(*prepared);
+        *prepared = NULL;
+    }
+    return sr_api_ret(NULL, err_info);
+}
+
+API void
+sr_xpath_free(sr_xpath_t *prepared)
+{
+    if (!prepared) {
+        return;
+    }
+
+    free(prepared->xpath);
+    free(prepared->conv.mods);
+    free(prepared->oper.mods);
+    free(prepared);
+}
+
 API void
 sr_free_val(sr_val_t *value)
 {
@@ -2015,47 +2793,117 @@ sr_move_item(sr_session_ctx_t *session, const char *path, const sr_move_position
     return sr_api_ret(session, err_info);
 }
 
+/**
+ * @brief Set a NETCONF edit as the session edit.
+ *
+ * @param[in] session Session to use.
+ * @param[in] edit Edit to set, is spent.
+ * @param[in] default_operation Default operation of the edit.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_edit_batch_set(sr_session_ctx_t *session, struct lyd_node *edit, const char *default_operation)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+    struct lyd_attr *attr;
+
+    /* add default operation and default origin */
+    LY_TREE_FOR(edit, node) {
+        for (attr = node->attr; attr && strcmp(attr->name, "operation"); attr = attr->next);
+        if (!attr && (err_info = sr_edit_set_oper(node, default_operation))) {
+            goto error;
+        }
+        if ((session->ds == SR_DS_OPERATIONAL) && (err_info = sr_edit_diff_set_origin(node, SR_OPER_ORIGIN, 1))) {
+            goto error;
+        }
+    }
+
+    if (session->edit_check && (err_info = sr_edit_check(edit))) {
+        /* invalid edit, fail now instead of after loading the data */
+        goto error;
+    }
+
+    session->dt[session->ds].edit = edit;
+    return NULL;
+
+error:
+    lyd_free_withsiblings(edit);
+    return err_info;
+}
+
+API int
+sr_edit_batch(sr_session_ctx_t *session, const struct lyd_node *edit, const char *default_operation)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *dup_edit;
+
+    SR_CHECK_ARG_APIRET(!session || !edit || !default_operation, session, err_info);
+    SR_CHECK_ARG_APIRET(strcmp(default_operation, "merge") && strcmp(default_operation, "replace")
+            && strcmp(default_operation, "none"), session, err_info);
+
+    if (session->conn->ly_ctx != edit->schema->module->ctx) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Data trees must be created using the session connection libyang context.");
+        return sr_api_ret(session, err_info);
+    } else if (session->dt[session->ds].edit) {
+        /* do not allow merging NETCONF edits into sysrepo ones, it can cause some unexpected results */
+        sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, NULL, "There are already some session changes.");
+        return sr_api_ret(session, err_info);
+    }
+
+    dup_edit = lyd_dup_withsiblings(edit, LYD_DUP_OPT_RECURSIVE);
+    if (!dup_edit) {
+        sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
+        return sr_api_ret(session, err_info);
+    }
+
+    err_info = sr_edit_batch_set(session, dup_edit, default_operation);
+    return sr_api_ret(session, err_info);
+}
+
 API int
-sr_edit_batch(sr_session_ctx_t *session, const struct lyd_node *edit, const char *default_operation)
+sr_edit_batch_items(sr_session_ctx_t *session, const sr_edit_item_t *items, size_t item_count,
+        const char *default_operation)
 {
     sr_error_info_t *err_info = NULL;
-    struct lyd_node *dup_edit = NULL, *node;
+    struct lyd_node *edit;
+    const char *op;
+    size_t i;
 
-    SR_CHECK_ARG_APIRET(!session || !edit || !default_operation, session, err_info);
+    SR_CHECK_ARG_APIRET(!session || !items || !item_count || !default_operation, session, err_info);
     SR_CHECK_ARG_APIRET(strcmp(default_operation, "merge") && strcmp(default_operation, "replace")
             && strcmp(default_operation, "none"), session, err_info);
+    for (i = 0; i < item_count; ++i) {
+        op = items[i].operation;
+        SR_CHECK_ARG_APIRET(!items[i].path || (op && strcmp(op, "merge") && strcmp(op, "replace") && strcmp(op, "create")
+                && strcmp(op, "delete") && strcmp(op, "remove") && strcmp(op, "none")), session, err_info);
+    }
 
-    if (session->conn->ly_ctx != edit->schema->module->ctx) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Data trees must be created using the session connection libyang context.");
-        return sr_api_ret(session, err_info);
-    } else if (session->dt[session->ds].edit) {
+    if (session->dt[session->ds].edit) {
         /* do not allow merging NETCONF edits into sysrepo ones, it can cause some unexpected results */
         sr_errinfo_new(&err_info, SR_ERR_UNSUPPORTED, NULL, "There are already some session changes.");
         return sr_api_ret(session, err_info);
     }
 
-    dup_edit = lyd_dup_withsiblings(edit, LYD_DUP_OPT_RECURSIVE);
-    if (!dup_edit) {
-        sr_errinfo_new_ly(&err_info, session->conn->ly_ctx);
-        goto error;
+    /* create the edit */
+    if ((err_info = sr_edit_items_create(session->conn->ly_ctx, items, item_count, &edit))) {
+        return sr_api_ret(session, err_info);
     }
 
-    /* add default operation and default origin */
-    LY_TREE_FOR(dup_edit, node) {
-        if ((err_info = sr_edit_set_oper(node, default_operation))) {
-            goto error;
-        }
-        if ((session->ds == SR_DS_OPERATIONAL) && (err_info = sr_edit_diff_set_origin(node, SR_OPER_ORIGIN, 1))) {
-            goto error;
-        }
-    }
+    err_info = sr_edit_batch_set(session, edit, default_operation);
+    return sr_api_ret(session, err_info);
+}
 
-    session->dt[session->ds].edit = dup_edit;
-    return sr_api_ret(session, NULL);
+API int
+sr_session_set_edit_check(sr_session_ctx_t *session, int enable)
+{
+    sr_error_info_t *err_info = NULL;
 
-error:
-    lyd_free_withsiblings(dup_edit);
-    return sr_api_ret(session, err_info);
+    SR_CHECK_ARG_APIRET(!session, session, err_info);
+
+    session->edit_check = enable ? 1 : 0;
+
+    return sr_api_ret(session, NULL);
 }
 
 API int
@@ -2155,10 +3003,29 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
     sr_error_info_t *err_info = NULL;
     struct lyd_node *update_edit = NULL, *old_diff = NULL, *new_diff = NULL;
     const char *err_msg = NULL, *err_xpath = NULL;
+    uint32_t i;
     int ret;
 
     *cb_err_info = NULL;
 
+    /* check write perm even if nothing is going to be changed */
+    if ((err_info = sr_modinfo_perm_check(mod_info, 1))) {
+        goto cleanup;
+    }
+
+    if (!mod_info->diff) {
+        for (i = 0; i < mod_info->mod_count; ++i) {
+            if (mod_info->mods[i].state & MOD_INFO_CHANGED) {
+                break;
+            }
+        }
+        if (i == mod_info->mod_count) {
+            /* not even default flags were changed, stored data are valid so there is nothing to do */
+            SR_LOG_INFMSG("No datastore changes to apply.");
+            goto cleanup;
+        }
+    }
+
     /* call connection diff callback */
     if (mod_info->diff && session->conn->diff_check_cb && (ret = session->conn->diff_check_cb(session, mod_info->diff))) {
         /* create cb_err_info */
@@ -2190,7 +3057,7 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
         break;
     }
 
-    /* check write perm (we must wait until after validation, some additional modules can be modified) */
+    /* check write perm again (some additional modules can be modified by validation) */
     if ((err_info = sr_modinfo_perm_check(mod_info, 1))) {
         goto cleanup;
     }
@@ -2288,89 +3155,469 @@ sr_changes_notify_store(struct sr_mod_info_s *mod_info, sr_session_ctx_t *sessio
         }
     }
 
-    /* success */
-
-cleanup:
-    lyd_free_withsiblings(update_edit);
-    lyd_free_withsiblings(old_diff);
-    lyd_free_withsiblings(new_diff);
-    return err_info;
+    /* success */
+
+cleanup:
+    lyd_free_withsiblings(update_edit);
+    lyd_free_withsiblings(old_diff);
+    lyd_free_withsiblings(new_diff);
+    return err_info;
+}
+
+/**
+ * @brief Apply changes made in a session.
+ *
+ * @param[in] session Session with the edit to apply.
+ * @param[in] timeout_ms Configuration callback timeout in milliseconds. If 0, default is used.
+ * @param[in] wait Whether to wait until all callbacks on all events are finished.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+_sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms, int wait)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
+    struct sr_mod_info_s mod_info;
+    sr_get_oper_options_t get_opts;
+
+    if (!session->dt[session->ds].edit) {
+        return NULL;
+    }
+
+    if (!timeout_ms) {
+        timeout_ms = SR_CHANGE_CB_TIMEOUT;
+    }
+    memset(&mod_info, 0, sizeof mod_info);
+
+    if (session->ds == SR_DS_OPERATIONAL) {
+        /* when updating stored oper data, we will not validate them so we do not need data from oper subscribers */
+        get_opts = SR_OPER_NO_SUBS;
+    } else {
+        get_opts = 0;
+    }
+
+    /* SHM LOCK */
+    if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
+        return err_info;
+    }
+
+    /* collect all required modules */
+    if ((err_info = sr_shmmod_collect_edit(session->conn, session->dt[session->ds].edit, session->ds, &mod_info))) {
+        goto cleanup_shm_unlock;
+    }
+
+    /* MODULES READ LOCK (but setting flag for guaranteed later upgrade success) */
+    if ((err_info = sr_shmmod_modinfo_rdlock(&mod_info, 1, session->sid))) {
+        goto cleanup_mods_unlock;
+    }
+
+    /* load all modules data (we need dependencies for validation) */
+    if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_TYPE_MASK, 0, NULL, NULL, 0, get_opts, NULL))) {
+        goto cleanup_mods_unlock;
+    }
+
+    /* create diff */
+    if ((err_info = sr_modinfo_edit_apply(&mod_info, session->dt[session->ds].edit, 1))) {
+        goto cleanup_mods_unlock;
+    }
+
+    /* notify all the subscribers and store the changes */
+    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, wait, &cb_err_info);
+
+cleanup_mods_unlock:
+    /* MODULES UNLOCK */
+    sr_shmmod_modinfo_unlock(&mod_info, 1);
+
+cleanup_shm_unlock:
+    /* SHM UNLOCK */
+    sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
+
+    if (!err_info && !cb_err_info) {
+        /* free applied edit */
+        lyd_free_withsiblings(session->dt[session->ds].edit);
+        session->dt[session->ds].edit = NULL;
+    }
+
+    sr_modinfo_free(&mod_info);
+    if (cb_err_info) {
+        /* return callback error if some was generated */
+        sr_errinfo_merge(&err_info, cb_err_info);
+        err_info->err_code = SR_ERR_CALLBACK_FAILED;
+    }
+    return err_info;
+}
+
+API int
+sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms, int wait)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session, session, err_info);
+
+    err_info = _sr_apply_changes(session, timeout_ms, wait);
+    return sr_api_ret(session, err_info);
+}
+
+/**
+ * @brief Free an asynchronous apply changes handle.
+ *
+ * @param[in] handle Apply changes handle with applied changes.
+ */
+static void
+sr_apply_handle_free_mem(sr_apply_handle_t *handle)
+{
+    close(handle->pipe[0]);
+    close(handle->pipe[1]);
+    sr_errinfo_free(&handle->err_info);
+    pthread_mutex_destroy(&handle->cb_lock);
+    free(handle);
+}
+
+/**
+ * @brief Apply changes of an asynchronous apply changes handle, signal they are applied, and call the callback.
+ * The handle must not be accessed afterwards.
+ *
+ * @param[in] handle Apply changes handle.
+ */
+static void
+sr_apply_handle_process(sr_apply_handle_t *handle)
+{
+    sr_error_info_t *err_info = NULL;
+    char buf[1] = {0};
+    int free_cb;
+
+    /* apply the changes */
+    err_info = _sr_apply_changes(handle->sess, handle->timeout_ms, handle->wait);
+    handle->ret = sr_api_ret(handle->sess, err_info);
+
+    /* keep the errors and stop the private session with its own ID so that no originator locks are released */
+    handle->err_info = handle->sess->err_info;
+    handle->sess->err_info = NULL;
+    handle->sess->sid.sr = handle->sess_sid;
+    err_info = _sr_session_stop(handle->sess);
+    handle->sess = NULL;
+    sr_errinfo_free(&err_info);
+
+    /* CB LOCK, the handle can be freed only once the callback returns */
+    pthread_mutex_lock(&handle->cb_lock);
+    handle->cb_tid = pthread_self();
+    handle->cb_running = 1;
+
+    /* signal the changes are applied, before the callback so that it can wait for them */
+    if (write(handle->pipe[1], buf, 1) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "write");
+        sr_errinfo_free(&err_info);
+    }
+
+    if (handle->cb) {
+        handle->cb(handle, handle->ret, handle->err_info, handle->private_data);
+    }
+    handle->cb_running = 0;
+    free_cb = handle->free_cb;
+
+    /* CB UNLOCK */
+    pthread_mutex_unlock(&handle->cb_lock);
+
+    if (free_cb) {
+        /* freed by the callback */
+        sr_apply_handle_free_mem(handle);
+    }
+}
+
+/**
+ * @brief Thread applying all the changes queued in a connection, in order.
+ *
+ * @param[in] arg Connection.
+ * @return Always NULL.
+ */
+static void *
+sr_apply_queue_thread(void *arg)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = (sr_conn_ctx_t *)arg;
+    sr_apply_handle_t *handle;
+    int ret;
+
+    while (ATOMIC_LOAD_RELAXED(conn->apply_queue.thread_running) || conn->apply_queue.first) {
+        /* MUTEX LOCK */
+        ret = pthread_mutex_lock(&conn->apply_queue.lock.mutex);
+        if (ret) {
+            SR_ERRINFO_LOCK(&err_info, __func__, ret);
+            break;
+        }
+
+        /* wait for some changes */
+        ret = 0;
+        while (!ret && ATOMIC_LOAD_RELAXED(conn->apply_queue.thread_running) && !conn->apply_queue.first) {
+            /* COND WAIT */
+            ret = pthread_cond_wait(&conn->apply_queue.lock.cond, &conn->apply_queue.lock.mutex);
+        }
+        if (ret) {
+            /* MUTEX UNLOCK */
+            pthread_mutex_unlock(&conn->apply_queue.lock.mutex);
+
+            SR_ERRINFO_COND(&err_info, __func__, ret);
+            break;
+        }
+
+        /* dequeue the first changes */
+        handle = conn->apply_queue.first;
+        if (handle) {
+            conn->apply_queue.first = handle->next;
+            if (!conn->apply_queue.first) {
+                conn->apply_queue.last = NULL;
+            }
+        }
+
+        /* MUTEX UNLOCK */
+        pthread_mutex_unlock(&conn->apply_queue.lock.mutex);
+
+        if (handle) {
+            sr_apply_handle_process(handle);
+        }
+    }
+
+    sr_errinfo_free(&err_info);
+    return NULL;
+}
+
+/**
+ * @brief Queue changes to be applied asynchronously, start the thread applying them if not yet running.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] handle Apply changes handle to queue.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_apply_queue_add(sr_conn_ctx_t *conn, sr_apply_handle_t *handle)
+{
+    sr_error_info_t *err_info = NULL;
+    struct timespec timeout_ts;
+    int ret;
+
+    sr_time_get(&timeout_ts, SR_APPLY_QUEUE_LOCK_TIMEOUT);
+
+    /* MUTEX LOCK */
+    ret = pthread_mutex_timedlock(&conn->apply_queue.lock.mutex, &timeout_ts);
+    if (ret) {
+        SR_ERRINFO_LOCK(&err_info, __func__, ret);
+        return err_info;
+    }
+
+    if (!conn->apply_queue.tid) {
+        /* start the thread */
+        ATOMIC_STORE_RELAXED(conn->apply_queue.thread_running, 1);
+        ret = pthread_create(&conn->apply_queue.tid, NULL, sr_apply_queue_thread, conn);
+        if (ret) {
+            sr_errinfo_new(&err_info, SR_ERR_INTERNAL, NULL, "Creating a new thread failed (%s).", strerror(ret));
+            ATOMIC_STORE_RELAXED(conn->apply_queue.thread_running, 0);
+            conn->apply_queue.tid = 0;
+            goto cleanup_unlock;
+        }
+    }
+
+    /* queue the changes */
+    if (conn->apply_queue.last) {
+        conn->apply_queue.last->next = handle;
+    } else {
+        conn->apply_queue.first = handle;
+    }
+    conn->apply_queue.last = handle;
+
+    /* broadcast condition */
+    ret = pthread_cond_broadcast(&conn->apply_queue.lock.cond);
+    if (ret) {
+        /* continue */
+        SR_ERRINFO_COND(&err_info, __func__, ret);
+        sr_errinfo_free(&err_info);
+    }
+
+cleanup_unlock:
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&conn->apply_queue.lock.mutex);
+    return err_info;
+}
+
+/**
+ * @brief Stop the thread applying changes asynchronously, all the queued changes are applied first.
+ *
+ * @param[in] conn Connection to use.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_apply_queue_stop(sr_conn_ctx_t *conn)
+{
+    sr_error_info_t *err_info = NULL;
+    struct timespec timeout_ts;
+    int ret;
+
+    if (!conn->apply_queue.tid) {
+        /* never started */
+        return NULL;
+    }
+
+    sr_time_get(&timeout_ts, SR_APPLY_QUEUE_LOCK_TIMEOUT);
+
+    /* MUTEX LOCK */
+    ret = pthread_mutex_timedlock(&conn->apply_queue.lock.mutex, &timeout_ts);
+    if (ret) {
+        SR_ERRINFO_LOCK(&err_info, __func__, ret);
+        return err_info;
+    }
+
+    /* signal the thread */
+    ATOMIC_STORE_RELAXED(conn->apply_queue.thread_running, 0);
+    ret = pthread_cond_broadcast(&conn->apply_queue.lock.cond);
+
+    /* MUTEX UNLOCK */
+    pthread_mutex_unlock(&conn->apply_queue.lock.mutex);
+
+    if (ret) {
+        SR_ERRINFO_COND(&err_info, __func__, ret);
+        return err_info;
+    }
+
+    /* join the thread, it will apply all the queued changes */
+    ret = pthread_join(conn->apply_queue.tid, NULL);
+    if (ret) {
+        sr_errinfo_new(&err_info, SR_ERR_SYS, NULL, "Joining the apply changes thread failed (%s).", strerror(ret));
+        return err_info;
+    }
+    conn->apply_queue.tid = 0;
+    assert(!conn->apply_queue.first);
+
+    return NULL;
 }
 
 API int
-sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms, int wait)
+sr_apply_changes_async(sr_session_ctx_t *session, uint32_t timeout_ms, int wait, sr_apply_changes_cb callback,
+        void *private_data, sr_apply_handle_t **handle)
 {
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL;
-    struct sr_mod_info_s mod_info;
-    sr_get_oper_options_t get_opts;
+    sr_error_info_t *err_info = NULL;
+    sr_apply_handle_t *h;
 
-    SR_CHECK_ARG_APIRET(!session, session, err_info);
+    SR_CHECK_ARG_APIRET(!session || !handle, session, err_info);
 
-    if (!session->dt[session->ds].edit) {
-        return sr_api_ret(session, NULL);
-    }
+    h = calloc(1, sizeof *h);
+    SR_CHECK_MEM_GOTO(!h, err_info, error);
+    h->pipe[0] = -1;
+    h->pipe[1] = -1;
+    h->timeout_ms = timeout_ms;
+    h->wait = wait;
+    h->cb = callback;
+    h->private_data = private_data;
 
-    if (!timeout_ms) {
-        timeout_ms = SR_CHANGE_CB_TIMEOUT;
+    if (pipe(h->pipe) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "pipe");
+        goto error;
     }
-    memset(&mod_info, 0, sizeof mod_info);
-
-    if (session->ds == SR_DS_OPERATIONAL) {
-        /* when updating stored oper data, we will not validate them so we do not need data from oper subscribers */
-        get_opts = SR_OPER_NO_SUBS;
-    } else {
-        get_opts = 0;
+    if ((err_info = sr_mutex_init(&h->cb_lock, 0))) {
+        goto error;
     }
 
-    /* SHM LOCK */
-    if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
-        return sr_api_ret(session, err_info);
+    /* private session but with the session information of the originator so that it owns its locks
+     * and the subscribers learn the same originator as with sr_apply_changes() */
+    if ((err_info = _sr_session_start(session->conn, session->ds, &h->sess))) {
+        goto error_mutex;
     }
+    h->sess_sid = h->sess->sid.sr;
+    free(h->sess->sid.user);
+    h->sess->sid.user = strdup(session->sid.user);
+    SR_CHECK_MEM_GOTO(!h->sess->sid.user, err_info, error_sess);
+    h->sess->sid.sr = session->sid.sr;
+    h->sess->sid.nc = session->sid.nc;
 
-    /* collect all required modules */
-    if ((err_info = sr_shmmod_collect_edit(session->conn, session->dt[session->ds].edit, session->ds, &mod_info))) {
-        goto cleanup_shm_unlock;
+    /* the edit is now owned by the handle */
+    h->sess->dt[h->sess->ds].edit = session->dt[session->ds].edit;
+    session->dt[session->ds].edit = NULL;
+
+    if ((err_info = sr_apply_queue_add(session->conn, h))) {
+        /* give the edit back */
+        session->dt[session->ds].edit = h->sess->dt[h->sess->ds].edit;
+        h->sess->dt[h->sess->ds].edit = NULL;
+        goto error_sess;
     }
 
-    /* MODULES READ LOCK (but setting flag for guaranteed later upgrade success) */
-    if ((err_info = sr_shmmod_modinfo_rdlock(&mod_info, 1, session->sid))) {
-        goto cleanup_mods_unlock;
+    *handle = h;
+    return sr_api_ret(session, NULL);
+
+error_sess:
+    h->sess->sid.sr = h->sess_sid;
+    sr_errinfo_merge(&err_info, _sr_session_stop(h->sess));
+error_mutex:
+    pthread_mutex_destroy(&h->cb_lock);
+error:
+    if (h) {
+        if (h->pipe[0] > -1) {
+            close(h->pipe[0]);
+            close(h->pipe[1]);
+        }
+        free(h);
     }
+    return sr_api_ret(session, err_info);
+}
 
-    /* load all modules data (we need dependencies for validation) */
-    if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_TYPE_MASK, 0, NULL, NULL, 0, get_opts, NULL))) {
-        goto cleanup_mods_unlock;
+API int
+sr_apply_handle_get_fd(sr_apply_handle_t *handle, int *fd)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!handle || !fd, NULL, err_info);
+
+    *fd = handle->pipe[0];
+    return SR_ERR_OK;
+}
+
+API int
+sr_apply_handle_wait(sr_apply_handle_t *handle, const sr_error_info_t **error_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct pollfd pfd;
+    int ret;
+
+    SR_CHECK_ARG_APIRET(!handle, NULL, err_info);
+
+    /* wait for the changes to be applied, the pipe is never read so it stays ready */
+    pfd.fd = handle->pipe[0];
+    pfd.events = POLLIN;
+    do {
+        ret = poll(&pfd, 1, -1);
+    } while ((ret == -1) && (errno == EINTR));
+    if (ret == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "poll");
+        return sr_api_ret(NULL, err_info);
     }
 
-    /* create diff */
-    if ((err_info = sr_modinfo_edit_apply(&mod_info, session->dt[session->ds].edit, 1))) {
-        goto cleanup_mods_unlock;
+    if (error_info) {
+        *error_info = handle->err_info;
     }
+    return handle->ret;
+}
 
-    /* notify all the subscribers and store the changes */
-    err_info = sr_changes_notify_store(&mod_info, session, timeout_ms, wait, &cb_err_info);
+API void
+sr_apply_handle_free(sr_apply_handle_t *handle)
+{
+    if (!handle) {
+        return;
+    }
 
-cleanup_mods_unlock:
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info, 1);
+    /* the changes must be applied */
+    sr_apply_handle_wait(handle, NULL);
 
-cleanup_shm_unlock:
-    /* SHM UNLOCK */
-    sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
+    if (pthread_equal(handle->cb_tid, pthread_self())) {
+        if (handle->cb_running) {
+            /* called from the callback, the handle is freed once it returns */
+            handle->free_cb = 1;
+            return;
+        }
+    } else {
+        /* CB LOCK, wait for the callback to return */
+        pthread_mutex_lock(&handle->cb_lock);
 
-    if (!err_info && !cb_err_info) {
-        /* free applied edit */
-        lyd_free_withsiblings(session->dt[session->ds].edit);
-        session->dt[session->ds].edit = NULL;
+        /* CB UNLOCK */
+        pthread_mutex_unlock(&handle->cb_lock);
     }
 
-    sr_modinfo_free(&mod_info);
-    if (cb_err_info) {
-        /* return callback error if some was generated */
-        sr_errinfo_merge(&err_info, cb_err_info);
-        err_info->err_code = SR_ERR_CALLBACK_FAILED;
-    }
-    return sr_api_ret(session, err_info);
+    sr_apply_handle_free_mem(handle);
 }
 
 API int
@@ -2870,8 +4117,8 @@ sr_process_events_notif_replay_stop(sr_subscription_ctx_t *subscription)
         return err_info;
     }
 
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subscription->subs_lock, SR_SUB_SUBS_LOCK_TIMEOUT, __func__))) {
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUB_SUBS_LOCK_TIMEOUT, SR_LOCK_WRITE, __func__))) {
         sr_shmmain_unlock(subscription->conn, SR_LOCK_WRITE, 1, 0, __func__);
         return err_info;
     }
@@ -2897,103 +4144,413 @@ sr_process_events_notif_replay_stop(sr_subscription_ctx_t *subscription)
         ++i;
     }
 
-    /* success */
-
-cleanup_unlock:
-    /* SUBS UNLOCK */
-    sr_munlock(&subscription->subs_lock);
+    /* success */
+
+cleanup_unlock:
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subscription->subs_lock, SR_LOCK_WRITE, __func__);
+
+    /* SHM UNLOCK */
+    sr_shmmain_unlock(subscription->conn, SR_LOCK_WRITE, 1, 0, __func__);
+    return err_info;
+}
+
+API int
+sr_process_events(sr_subscription_ctx_t *subscription, sr_session_ctx_t *session, time_t *stop_time_in)
+{
+    sr_error_info_t *err_info = NULL;
+    int ret;
+    char buf[1];
+    uint32_t i, j, k, tid_count;
+    sr_lock_mode_t mode;
+
+    /* session does not have to be set */
+    SR_CHECK_ARG_APIRET(!subscription, session, err_info);
+
+    if (stop_time_in) {
+        *stop_time_in = 0;
+    }
+
+process_events:
+    /* events are only dispatched to worker threads, if there are any */
+    tid_count = subscription->pool.tid_count;
+    mode = tid_count ? SR_LOCK_READ : SR_LOCK_WRITE;
+
+    /* SUBS LOCK */
+    if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUB_SUBS_LOCK_TIMEOUT, mode, __func__))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    if (tid_count != subscription->pool.tid_count) {
+        /* worker threads were changed in the meantime */
+
+        /* SUBS UNLOCK */
+        sr_rwunlock(&subscription->subs_lock, mode, __func__);
+        goto process_events;
+    }
+
+    /* read all bytes from the pipe, there can be several events by now */
+    do {
+        ret = read(subscription->evpipe, buf, 1);
+    } while (ret == 1);
+    if ((ret == -1) && (errno != EAGAIN)) {
+        SR_ERRINFO_SYSERRNO(&err_info, "read");
+        sr_errinfo_new(&err_info, SR_ERR_INTERNAL, NULL, "Failed to read from an event pipe.");
+        goto cleanup_unlock;
+    }
+
+    /* first check whether there are any pending replays or finished subscriptions ... */
+    for (i = 0; i < subscription->notif_sub_count; ++i) {
+        if (sr_shmsub_notif_listen_module_has_replay_or_stop(&subscription->notif_subs[i])) {
+            break;
+        }
+    }
+    if (i < subscription->notif_sub_count) {
+        /* ... there are, prepare for handling them (keep lock order) */
+
+        /* SUBS UNLOCK */
+        sr_rwunlock(&subscription->subs_lock, mode, __func__);
+
+        if (tid_count) {
+            /* all the worker threads must be finished with their tasks */
+            if ((err_info = sr_shmsub_pool_wait(subscription))) {
+                return sr_api_ret(session, err_info);
+            }
+        }
+
+        if ((err_info = sr_process_events_notif_replay_stop(subscription))) {
+            return sr_api_ret(session, err_info);
+        }
+
+        /* start from the beginning again, anything could have changed */
+        goto process_events;
+    }
+
+    /* change subscriptions */
+    for (i = 0; i < subscription->change_sub_count; ++i) {
+        if (tid_count) {
+            err_info = sr_shmsub_pool_add_task(subscription, SR_SUBS_TASK_CHANGE, &subscription->change_subs[i], NULL, 0);
+        } else if (sr_shmsub_change_listen_module_has_event(&subscription->change_subs[i])) {
+            err_info = sr_shmsub_change_listen_process_module_events(&subscription->change_subs[i], subscription->conn);
+        }
+        if (err_info) {
+            goto cleanup_unlock;
+        }
+    }
+
+    /* operational subscriptions */
+    for (i = 0; i < subscription->oper_sub_count; ++i) {
+        if (tid_count) {
+            /* every request slot of every subscription separately, they are independent */
+            for (j = 0; !err_info && (j < subscription->oper_subs[i].sub_count); ++j) {
+                for (k = 0; !err_info && (k < subscription->oper_subs[i].subs[j].slot_count); ++k) {
+                    err_info = sr_shmsub_pool_add_task(subscription, SR_SUBS_TASK_OPER, &subscription->oper_subs[i].subs[j],
+                            &subscription->oper_subs[i], k);
+                }
+            }
+        } else if (sr_shmsub_oper_listen_module_has_event(&subscription->oper_subs[i])) {
+            err_info = sr_shmsub_oper_listen_process_module_events(&subscription->oper_subs[i], subscription->conn);
+        }
+        if (err_info) {
+            goto cleanup_unlock;
+        }
+    }
+
+    /* RPC/action subscriptions */
+    for (i = 0; i < subscription->rpc_sub_count; ++i) {
+        if (tid_count) {
+            err_info = sr_shmsub_pool_add_task(subscription, SR_SUBS_TASK_RPC, &subscription->rpc_subs[i], NULL, 0);
+        } else if (sr_shmsub_rpc_listen_has_event(&subscription->rpc_subs[i])) {
+            err_info = sr_shmsub_rpc_listen_process_rpc_events(&subscription->rpc_subs[i], subscription->conn);
+        }
+        if (err_info) {
+            goto cleanup_unlock;
+        }
+    }
+
+    /* notification subscriptions */
+    for (i = 0; i < subscription->notif_sub_count; ++i) {
+        if (tid_count) {
+            err_info = sr_shmsub_pool_add_task(subscription, SR_SUBS_TASK_NOTIF, &subscription->notif_subs[i], NULL, 0);
+        } else if (sr_shmsub_notif_listen_module_has_event(&subscription->notif_subs[i])) {
+            err_info = sr_shmsub_notif_listen_process_module_events(&subscription->notif_subs[i], subscription->conn);
+        }
+        if (err_info) {
+            goto cleanup_unlock;
+        }
+
+        /* find nearest stop time */
+        sr_shmsub_notif_listen_module_get_stop_time_in(&subscription->notif_subs[i], stop_time_in);
+    }
+
+cleanup_unlock:
+    /* SUBS UNLOCK */
+    sr_rwunlock(&subscription->subs_lock, mode, __func__);
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_subscription_thread_pool(sr_subscription_ctx_t *subscription, uint32_t thread_count)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!subscription, NULL, err_info);
+
+    /* SUBS WRITE LOCK */
+    if ((err_info = sr_rwlock(&subscription->subs_lock, SR_SUB_EVENT_LOOP_TIMEOUT * 1000, SR_LOCK_WRITE, __func__))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    /* stop the current worker threads, if any */
+    if ((err_info = sr_shmsub_pool_stop(subscription))) {
+        goto cleanup_unlock;
+    }
+
+    /* start the new ones */
+    if (thread_count && (err_info = sr_shmsub_pool_start(subscription, thread_count))) {
+        goto cleanup_unlock;
+    }
+
+cleanup_unlock:
+    /* SUBS WRITE UNLOCK */
+    sr_rwunlock(&subscription->subs_lock, SR_LOCK_WRITE, __func__);
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_event_loop_new(sr_event_loop_t **loop)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!loop, NULL, err_info);
+
+    *loop = calloc(1, sizeof **loop);
+    SR_CHECK_MEM_GOTO(!*loop, err_info, cleanup);
+
+    (*loop)->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if ((*loop)->epoll_fd == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "epoll_create1");
+        free(*loop);
+        *loop = NULL;
+        goto cleanup;
+    }
+
+cleanup:
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_event_loop_add(sr_event_loop_t *loop, sr_subscription_ctx_t *subscription)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_event_loop_sub_s *loop_sub = NULL;
+    struct epoll_event ev;
+    void *mem;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!loop || !subscription, NULL, err_info);
+
+    if (ATOMIC_LOAD_RELAXED(subscription->thread_running)) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Subscription with a listening thread cannot be added.");
+        return sr_api_ret(NULL, err_info);
+    }
+    for (i = 0; i < loop->sub_count; ++i) {
+        if (loop->subs[i]->subscription == subscription) {
+            sr_errinfo_new(&err_info, SR_ERR_EXISTS, NULL, "Subscription already in the event loop.");
+            return sr_api_ret(NULL, err_info);
+        }
+    }
+
+    /* make room for the new subscription */
+    mem = realloc(loop->subs, (loop->sub_count + 1) * sizeof *loop->subs);
+    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+    loop->subs = mem;
+
+    mem = realloc(loop->events, (loop->sub_count + 1) * sizeof *loop->events);
+    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+    loop->events = mem;
+
+    mem = realloc(loop->ready, (loop->sub_count + 1) * sizeof *loop->ready);
+    SR_CHECK_MEM_GOTO(!mem, err_info, cleanup);
+    loop->ready = mem;
+
+    loop_sub = calloc(1, sizeof *loop_sub);
+    SR_CHECK_MEM_GOTO(!loop_sub, err_info, cleanup);
+    loop_sub->subscription = subscription;
+
+    /* add the event pipe, there may be some events already so process the subscription first */
+    memset(&ev, 0, sizeof ev);
+    ev.events = EPOLLIN;
+    ev.data.ptr = loop_sub;
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, subscription->evpipe, &ev) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "epoll_ctl");
+        goto cleanup;
+    }
+    if ((err_info = sr_shmsub_notify_evpipe(subscription->evpipe_num))) {
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, subscription->evpipe, &ev);
+        goto cleanup;
+    }
+
+    loop->subs[loop->sub_count] = loop_sub;
+    ++loop->sub_count;
+    loop_sub = NULL;
 
-    /* SHM UNLOCK */
-    sr_shmmain_unlock(subscription->conn, SR_LOCK_WRITE, 1, 0, __func__);
-    return err_info;
+cleanup:
+    free(loop_sub);
+    return sr_api_ret(NULL, err_info);
 }
 
 API int
-sr_process_events(sr_subscription_ctx_t *subscription, sr_session_ctx_t *session, time_t *stop_time_in)
+sr_event_loop_del(sr_event_loop_t *loop, sr_subscription_ctx_t *subscription)
 {
     sr_error_info_t *err_info = NULL;
-    int ret;
-    char buf[1];
+    struct epoll_event ev;
     uint32_t i;
 
-    /* session does not have to be set */
-    SR_CHECK_ARG_APIRET(!subscription, session, err_info);
+    SR_CHECK_ARG_APIRET(!loop || !subscription, NULL, err_info);
 
-    if (stop_time_in) {
-        *stop_time_in = 0;
+    for (i = 0; i < loop->sub_count; ++i) {
+        if (loop->subs[i]->subscription == subscription) {
+            break;
+        }
+    }
+    if (i == loop->sub_count) {
+        sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, NULL, "Subscription not in the event loop.");
+        return sr_api_ret(NULL, err_info);
     }
 
-process_events:
-    /* SUBS LOCK */
-    if ((err_info = sr_mlock(&subscription->subs_lock, SR_SUB_SUBS_LOCK_TIMEOUT, __func__))) {
-        return sr_api_ret(session, err_info);
+    /* the event structure is ignored but must not be NULL for older kernels */
+    memset(&ev, 0, sizeof ev);
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, subscription->evpipe, &ev) == -1) {
+        SR_ERRINFO_SYSERRNO(&err_info, "epoll_ctl");
+        return sr_api_ret(NULL, err_info);
     }
 
-    /* read all bytes from the pipe, there can be several events by now */
-    do {
-        ret = read(subscription->evpipe, buf, 1);
-    } while (ret == 1);
-    if ((ret == -1) && (errno != EAGAIN)) {
-        SR_ERRINFO_SYSERRNO(&err_info, "read");
-        sr_errinfo_new(&err_info, SR_ERR_INTERNAL, NULL, "Failed to read from an event pipe.");
-        goto cleanup_unlock;
+    free(loop->subs[i]);
+    --loop->sub_count;
+    if (i < loop->sub_count) {
+        /* replace the removed subscription with the last one */
+        loop->subs[i] = loop->subs[loop->sub_count];
     }
 
-    /* first check whether there are any pending replays or finished subscriptions ... */
-    for (i = 0; i < subscription->notif_sub_count; ++i) {
-        if (sr_shmsub_notif_listen_module_has_replay_or_stop(&subscription->notif_subs[i])) {
-            break;
-        }
+    return sr_api_ret(NULL, NULL);
+}
+
+API int
+sr_event_loop_process(sr_event_loop_t *loop, int timeout_ms, sr_session_ctx_t *session,
+        sr_subscription_ctx_t ***ready, uint32_t *ready_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_event_loop_sub_s *loop_sub;
+    struct epoll_event ev;
+    uint32_t i, count = 0;
+    time_t cur_time, stop_time_in;
+    int ret, rc = SR_ERR_OK, j, ev_count = 0, stop_ms;
+
+    SR_CHECK_ARG_APIRET(!loop, session, err_info);
+
+    if (ready) {
+        *ready = NULL;
+    }
+    if (ready_count) {
+        *ready_count = 0;
     }
-    if (i < subscription->notif_sub_count) {
-        /* ... there are, prepare for handling them (keep lock order) */
 
-        /* SUBS UNLOCK */
-        sr_munlock(&subscription->subs_lock);
+    /* shorten the timeout if any subscription stop time elapses sooner */
+    cur_time = time(NULL);
+    for (i = 0; i < loop->sub_count; ++i) {
+        if (!loop->subs[i]->stop_time) {
+            continue;
+        }
+        if (loop->subs[i]->stop_time <= cur_time) {
+            timeout_ms = 0;
+            continue;
+        }
 
-        if ((err_info = sr_process_events_notif_replay_stop(subscription))) {
+        /* a stop time in the far future would not fit into the timeout */
+        if (loop->subs[i]->stop_time - cur_time > INT_MAX / 1000) {
+            stop_ms = INT_MAX;
+        } else {
+            stop_ms = (loop->subs[i]->stop_time - cur_time) * 1000;
+        }
+        if ((timeout_ms < 0) || (stop_ms < timeout_ms)) {
+            timeout_ms = stop_ms;
+        }
+    }
+
+    /* wait for some events, with no subscriptions the empty epoll set is used just to wait for the timeout */
+    ev_count = epoll_wait(loop->epoll_fd, loop->sub_count ? loop->events : &ev, loop->sub_count ? (int)loop->sub_count : 1,
+            timeout_ms);
+    if (ev_count == -1) {
+        if (errno != EINTR) {
+            SR_ERRINFO_SYSERRNO(&err_info, "epoll_wait");
             return sr_api_ret(session, err_info);
         }
 
-        /* start from the beginning again, anything could have changed */
-        goto process_events;
+        /* signal received, handle only elapsed stop times */
+        ev_count = 0;
     }
 
-    /* change subscriptions */
-    for (i = 0; i < subscription->change_sub_count; ++i) {
-        if ((err_info = sr_shmsub_change_listen_process_module_events(&subscription->change_subs[i], subscription->conn))) {
-            goto cleanup_unlock;
+    /* process the subscriptions with some events */
+    cur_time = time(NULL);
+    for (j = 0; j < ev_count; ++j) {
+        loop_sub = loop->events[j].data.ptr;
+
+        ret = sr_process_events(loop_sub->subscription, session, &stop_time_in);
+        if ((ret != SR_ERR_OK) && (rc == SR_ERR_OK)) {
+            rc = ret;
         }
+        loop_sub->stop_time = stop_time_in ? cur_time + stop_time_in : 0;
+        loop_sub->processed = 1;
+        loop->ready[count++] = loop_sub->subscription;
     }
 
-    /* operational subscriptions */
-    for (i = 0; i < subscription->oper_sub_count; ++i) {
-        if ((err_info = sr_shmsub_oper_listen_process_module_events(&subscription->oper_subs[i], subscription->conn))) {
-            goto cleanup_unlock;
+    /* process the subscriptions with elapsed stop times */
+    for (i = 0; i < loop->sub_count; ++i) {
+        loop_sub = loop->subs[i];
+        if (loop_sub->processed) {
+            /* already processed */
+            loop_sub->processed = 0;
+            continue;
+        }
+        if (!loop_sub->stop_time || (loop_sub->stop_time > cur_time)) {
+            continue;
         }
-    }
 
-    /* RPC/action subscriptions */
-    for (i = 0; i < subscription->rpc_sub_count; ++i) {
-        if ((err_info = sr_shmsub_rpc_listen_process_rpc_events(&subscription->rpc_subs[i], subscription->conn))) {
-            goto cleanup_unlock;
+        ret = sr_process_events(loop_sub->subscription, session, &stop_time_in);
+        if ((ret != SR_ERR_OK) && (rc == SR_ERR_OK)) {
+            rc = ret;
         }
+        loop_sub->stop_time = stop_time_in ? cur_time + stop_time_in : 0;
+        loop->ready[count++] = loop_sub->subscription;
     }
 
-    /* notification subscriptions */
-    for (i = 0; i < subscription->notif_sub_count; ++i) {
-        if ((err_info = sr_shmsub_notif_listen_process_module_events(&subscription->notif_subs[i], subscription->conn))) {
-            goto cleanup_unlock;
-        }
+    if (ready) {
+        *ready = count ? loop->ready : NULL;
+    }
+    if (ready_count) {
+        *ready_count = count;
+    }
+    return rc;
+}
 
-        /* find nearest stop time */
-        sr_shmsub_notif_listen_module_get_stop_time_in(&subscription->notif_subs[i], stop_time_in);
+API void
+sr_event_loop_free(sr_event_loop_t *loop)
+{
+    uint32_t i;
+
+    if (!loop) {
+        return;
     }
 
-cleanup_unlock:
-    /* SUBS UNLOCK */
-    sr_munlock(&subscription->subs_lock);
-    return sr_api_ret(session, err_info);
+    for (i = 0; i < loop->sub_count; ++i) {
+        free(loop->subs[i]);
+    }
+    free(loop->subs);
+    free(loop->events);
+    free(loop->ready);
+    close(loop->epoll_fd);
+    free(loop);
 }
 
 /**
@@ -3027,6 +4584,12 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
         }
     }
 
+    /* stop all the worker threads */
+    if ((tmp_err = sr_shmsub_pool_stop(subscription))) {
+        /* continue */
+        sr_errinfo_merge(&err_info, tmp_err);
+    }
+
     /* delete all subscriptions (also removes this subscription from all the sessions) */
     if ((tmp_err = sr_subs_del_all(subscription))) {
         /* continue */
@@ -3050,7 +4613,8 @@ _sr_unsubscribe(sr_subscription_ctx_t *subscription)
 
     /* free attributes */
     close(subscription->evpipe);
-    pthread_mutex_destroy(&subscription->subs_lock);
+    sr_rwlock_destroy(&subscription->subs_lock);
+    sr_rwlock_destroy(&subscription->pool.lock);
     free(subscription);
     return err_info;
 }
@@ -3208,7 +4772,15 @@ sr_subs_new(sr_conn_ctx_t *conn, sr_subscr_options_t opts, sr_subscription_ctx_t
     /* allocate new subscription */
     *subs_p = calloc(1, sizeof **subs_p);
     SR_CHECK_MEM_RET(!*subs_p, err_info);
-    sr_mutex_init(&(*subs_p)->subs_lock, 0);
+    if ((err_info = sr_rwlock_init(&(*subs_p)->subs_lock, 0))) {
+        free(*subs_p);
+        return err_info;
+    }
+    if ((err_info = sr_rwlock_init(&(*subs_p)->pool.lock, 0))) {
+        sr_rwlock_destroy(&(*subs_p)->subs_lock);
+        free(*subs_p);
+        return err_info;
+    }
     (*subs_p)->conn = conn;
     (*subs_p)->evpipe = -1;
 
@@ -3264,6 +4836,8 @@ error:
     if ((*subs_p)->evpipe > -1) {
         close((*subs_p)->evpipe);
     }
+    sr_rwlock_destroy(&(*subs_p)->subs_lock);
+    sr_rwlock_destroy(&(*subs_p)->pool.lock);
     free(*subs_p);
     return err_info;
 }
@@ -3393,6 +4967,92 @@ error_unlock:
     return sr_api_ret(session, err_info);
 }
 
+/**
+ * @brief Collect diff nodes selected by a change XPath. Whole subtrees selected by `<path>//.` are collected
+ * by walking the diff from the nodes selected by `<path>` instead of evaluating the descendant axis.
+ *
+ * @param[in] diff Diff to use.
+ * @param[in] xpath XPath selecting the changes.
+ * @param[out] set Set of selected diff nodes in document order.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_iter_collect(const struct lyd_node *diff, const char *xpath, struct ly_set **set)
+{
+    sr_error_info_t *err_info = NULL;
+    struct ly_set *roots = NULL;
+    const struct lyd_node *root;
+    struct lyd_node *next, *elem, *parent, *last = NULL;
+    char *prefix = NULL;
+    size_t len;
+    uint32_t i;
+
+    *set = NULL;
+
+    len = strlen(xpath);
+    if ((len < 4) || strcmp(xpath + len - 3, "//.") || (xpath[len - 4] == '/') || strchr(xpath, '|')) {
+        /* generic XPath */
+        *set = lyd_find_path(diff, xpath);
+        if (!*set) {
+            sr_errinfo_new_ly(&err_info, lyd_node_module(diff)->ctx);
+        }
+        return err_info;
+    }
+
+    prefix = strndup(xpath, len - 3);
+    SR_CHECK_MEM_GOTO(!prefix, err_info, cleanup);
+    len -= 3;
+
+    if ((prefix[0] == '/') && (len > 3) && !strcmp(prefix + len - 2, ":*") && !strpbrk(prefix + 1, "/[(")) {
+        /* all the changes of a module, the most common case */
+        prefix[len - 2] = '\0';
+        roots = ly_set_new();
+        SR_CHECK_MEM_GOTO(!roots, err_info, cleanup);
+        LY_TREE_FOR(diff, root) {
+            if (!strcmp(lyd_node_module(root)->name, prefix + 1)) {
+                ly_set_add(roots, (void *)root, LY_SET_OPT_USEASLIST);
+            }
+        }
+    } else {
+        roots = lyd_find_path(diff, prefix);
+        if (!roots) {
+            sr_errinfo_new_ly(&err_info, lyd_node_module(diff)->ctx);
+            goto cleanup;
+        }
+    }
+
+    *set = ly_set_new();
+    SR_CHECK_MEM_GOTO(!*set, err_info, cleanup);
+    for (i = 0; i < roots->number; ++i) {
+        /* skip subtrees already collected with an ancestor, the roots are in the document order
+         * so the ancestor can only be the last collected root */
+        if (last) {
+            for (parent = roots->set.d[i]->parent; parent && (parent != last); parent = parent->parent);
+            if (parent) {
+                continue;
+            }
+        }
+        last = roots->set.d[i];
+
+        LY_TREE_DFS_BEGIN(roots->set.d[i], next, elem) {
+            if (ly_set_add(*set, elem, LY_SET_OPT_USEASLIST) == -1) {
+                sr_errinfo_new_ly(&err_info, lyd_node_module(diff)->ctx);
+                goto cleanup;
+            }
+            LY_TREE_DFS_END(roots->set.d[i], next, elem);
+        }
+    }
+
+cleanup:
+    if (err_info) {
+        ly_set_free(*set);
+        *set = NULL;
+    }
+    ly_set_free(roots);
+    free(prefix);
+    return err_info;
+}
+
 API int
 sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, sr_change_iter_t **iter)
 {
@@ -3412,11 +5072,13 @@ sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, sr_change_iter
     }
 
     if (session->dt[session->ds].diff) {
-        (*iter)->set = lyd_find_path(session->dt[session->ds].diff, xpath);
+        if ((err_info = sr_change_iter_collect(session->dt[session->ds].diff, xpath, &(*iter)->set))) {
+            goto error;
+        }
     } else {
         (*iter)->set = ly_set_new();
+        SR_CHECK_MEM_GOTO(!(*iter)->set, err_info, error);
     }
-    SR_CHECK_MEM_GOTO(!(*iter)->set, err_info, error);
     (*iter)->idx = 0;
 
     return sr_api_ret(session, NULL);
@@ -3649,33 +5311,45 @@ error:
     return err_info;
 }
 
-API int
-sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_oper_t *operation,
-        sr_val_t **old_value, sr_val_t **new_value)
+/**
+ * @brief Get the next change from a change iterator as sysrepo values.
+ *
+ * @param[in] iter Change iterator.
+ * @param[out] operation Change operation.
+ * @param[out] old_value Old value.
+ * @param[out] new_value New value.
+ * @param[out] node_p Changed diff node, NULL if there are no more changes.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_change_next(sr_change_iter_t *iter, sr_change_oper_t *operation, sr_val_t **old_value, sr_val_t **new_value,
+        struct lyd_node **node_p)
 {
     sr_error_info_t *err_info = NULL;
     struct lyd_attr *attr, *attr2;
-    struct lyd_node *node;
+    struct lyd_node *node = NULL;
     const char *attr_name;
     sr_change_oper_t op;
 
-    SR_CHECK_ARG_APIRET(!session || !iter || !operation || !old_value || !new_value, session, err_info);
+    *old_value = NULL;
+    *new_value = NULL;
+    *node_p = NULL;
 
     /* get next change */
     if ((err_info = sr_diff_set_getnext(iter->set, &iter->idx, &node, &op))) {
-        return sr_api_ret(session, err_info);
+        return err_info;
     }
 
     if (!node) {
         /* no more changes */
-        return SR_ERR_NOT_FOUND;
+        return NULL;
     }
 
     /* create values */
     switch (op) {
     case SR_OP_DELETED:
         if ((err_info = sr_lyd_node2sr_val(node, NULL, NULL, old_value))) {
-            return sr_api_ret(session, err_info);
+            goto error;
         }
         *new_value = NULL;
         break;
@@ -3686,7 +5360,7 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
              attr = attr->next);
         if (!attr) {
             SR_ERRINFO_INT(&err_info);
-            return sr_api_ret(session, err_info);
+            goto error;
         }
 
         /* "orig-dflt" is present only if the previous value was default */
@@ -3695,7 +5369,7 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
              attr2 = attr2->next);
 
         if ((err_info = sr_lyd_node2sr_val(node, attr->value_str, NULL, old_value))) {
-            return sr_api_ret(session, err_info);
+            goto error;
         }
         if (attr2) {
             (*old_value)->dflt = 1;
@@ -3703,7 +5377,7 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
             (*old_value)->dflt = 0;
         }
         if ((err_info = sr_lyd_node2sr_val(node, NULL, NULL, new_value))) {
-            return sr_api_ret(session, err_info);
+            goto error;
         }
         break;
     case SR_OP_CREATED:
@@ -3711,7 +5385,7 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
             /* not a user-ordered list, so the operation is a simple creation */
             *old_value = NULL;
             if ((err_info = sr_lyd_node2sr_val(node, NULL, NULL, new_value))) {
-                return sr_api_ret(session, err_info);
+                goto error;
             }
             break;
         }
@@ -3729,7 +5403,7 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
              attr = attr->next);
         if (!attr) {
             SR_ERRINFO_INT(&err_info);
-            return sr_api_ret(session, err_info);
+            goto error;
         }
 
         if (attr->value_str[0]) {
@@ -3739,22 +5413,115 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
                 err_info = sr_lyd_node2sr_val(node, NULL, attr->value_str, old_value);
             }
             if (err_info) {
-                return sr_api_ret(session, err_info);
+                goto error;
             }
         } else {
             /* inserted as the first item */
             *old_value = NULL;
         }
         if ((err_info = sr_lyd_node2sr_val(node, NULL, NULL, new_value))) {
-            return sr_api_ret(session, err_info);
+            goto error;
         }
         break;
     }
 
     *operation = op;
+    *node_p = node;
+    return NULL;
+
+error:
+    sr_free_val(*old_value);
+    sr_free_val(*new_value);
+    *old_value = NULL;
+    *new_value = NULL;
+    return err_info;
+}
+
+API int
+sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_oper_t *operation,
+        sr_val_t **old_value, sr_val_t **new_value)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+
+    SR_CHECK_ARG_APIRET(!session || !iter || !operation || !old_value || !new_value, session, err_info);
+
+    if ((err_info = sr_change_next(iter, operation, old_value, new_value, &node))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    if (!node) {
+        /* no more changes */
+        return SR_ERR_NOT_FOUND;
+    }
+
     return sr_api_ret(session, NULL);
 }
 
+API int
+sr_get_change_next_batch(sr_session_ctx_t *session, sr_change_iter_t *iter, uint32_t max_count, sr_change_t **changes,
+        uint32_t *change_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *node;
+    sr_change_t *change;
+    uint32_t size;
+
+    SR_CHECK_ARG_APIRET(!session || !iter || !max_count || !changes || !change_count, session, err_info);
+
+    *changes = NULL;
+    *change_count = 0;
+
+    /* there cannot be more changes than remaining diff nodes */
+    size = iter->set->number - iter->idx;
+    if (size > max_count) {
+        size = max_count;
+    }
+    if (!size) {
+        return SR_ERR_NOT_FOUND;
+    }
+    *changes = malloc(size * sizeof **changes);
+    SR_CHECK_MEM_GOTO(!*changes, err_info, error);
+
+    while (*change_count < size) {
+        change = &(*changes)[*change_count];
+        if ((err_info = sr_change_next(iter, &change->oper, &change->old_value, &change->new_value, &node))) {
+            goto error;
+        }
+        if (!node) {
+            /* no more changes */
+            break;
+        }
+        ++(*change_count);
+    }
+
+    if (!*change_count) {
+        free(*changes);
+        *changes = NULL;
+        return SR_ERR_NOT_FOUND;
+    }
+
+    return sr_api_ret(session, NULL);
+
+error:
+    sr_free_changes(*changes, *change_count);
+    *changes = NULL;
+    *change_count = 0;
+    return sr_api_ret(session, err_info);
+}
+
+API void
+sr_free_changes(sr_change_t *changes, uint32_t change_count)
+{
+    uint32_t i;
+
+    for (i = 0; i < change_count; ++i) {
+        sr_free_val(changes[i].old_value);
+        sr_free_val(changes[i].new_value);
+    }
+    free(changes);
+}
+
 API int
 sr_get_change_tree_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_oper_t *operation,
         const struct lyd_node **node, const char **prev_value, const char **prev_list, bool *prev_dflt)
@@ -4425,83 +6192,111 @@ sr_event_notif_send(sr_session_ctx_t *session, const char *path, const sr_val_t
         }
     }
 
-    /* API function */
-    if ((ret = sr_event_notif_send_tree(session, notif_tree)) != SR_ERR_OK) {
-        lyd_free_withsiblings(notif_tree);
-        return ret;
-    }
-
-    /* success */
-
-cleanup:
-    lyd_free_withsiblings(notif_tree);
-    return sr_api_ret(session, err_info);
-}
-
-API int
-sr_event_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif)
-{
-    sr_error_info_t *err_info = NULL, *cb_err_info = NULL, *tmp_err_info = NULL;
-    struct sr_mod_info_s mod_info;
-    struct lyd_node *notif_op;
-    sr_mod_data_dep_t *shm_deps;
-    sr_mod_t *shm_mod;
-    time_t notif_ts;
-    uint16_t shm_dep_count;
-    sr_mod_notif_sub_t *notif_subs;
-    uint32_t notif_sub_count;
-    char *xpath = NULL;
-
-    SR_CHECK_ARG_APIRET(!session || !notif, session, err_info);
-    if (session->conn->ly_ctx != notif->schema->module->ctx) {
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Data trees must be created using the session connection libyang context.");
-        return sr_api_ret(session, err_info);
+    /* API function */
+    if ((ret = sr_event_notif_send_tree(session, notif_tree)) != SR_ERR_OK) {
+        lyd_free_withsiblings(notif_tree);
+        return ret;
     }
 
-    memset(&mod_info, 0, sizeof mod_info);
+    /* success */
 
-    /* remember when the notification was generated */
-    notif_ts = time(NULL);
+cleanup:
+    lyd_free_withsiblings(notif_tree);
+    return sr_api_ret(session, err_info);
+}
+
+/**
+ * @brief Find the root and the operation node of a notification tree.
+ *
+ * @param[in,out] notif Notification tree node, set to its root.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_event_notif_find_root(struct lyd_node **notif)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node *notif_op;
 
     /* check notif data tree */
-    switch (notif->schema->nodetype) {
+    switch ((*notif)->schema->nodetype) {
     case LYS_NOTIF:
-        for (notif_op = notif; notif->parent; notif = notif->parent);
-        break;
+        for (; (*notif)->parent; *notif = (*notif)->parent);
+        return NULL;
     case LYS_CONTAINER:
     case LYS_LIST:
         /* find the notification */
-        notif_op = notif;
+        notif_op = *notif;
         if ((err_info = sr_ly_find_last_parent(&notif_op, LYS_NOTIF))) {
-            return sr_api_ret(session, err_info);
+            return err_info;
         }
         if (notif_op->schema->nodetype == LYS_NOTIF) {
-            break;
+            return NULL;
         }
         /* fallthrough */
     default:
-        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Provided tree is not a valid notification invocation.");
-        return sr_api_ret(session, err_info);
+        break;
     }
 
-    /* SHM LOCK (accessing subscriptions) */
-    if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
-        return sr_api_ret(session, err_info);
-    }
+    sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Provided tree is not a valid notification invocation.");
+    return err_info;
+}
+
+/**
+ * @brief Check permissions and validate notifications of a single module. Main SHM is expected to be READ locked.
+ * All the modules needed by the notifications are locked and their data loaded only once.
+ *
+ * @param[in] session Session to use.
+ * @param[in] notifs Notification tree roots.
+ * @param[in] notif_count Count of @p notifs.
+ * @param[out] cb_err_info Callback error info in case an operational callback failed.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_event_notif_validate(sr_session_ctx_t *session, struct lyd_node **notifs, uint32_t notif_count,
+        sr_error_info_t **cb_err_info)
+{
+    sr_error_info_t *err_info = NULL;
+    struct sr_mod_info_s mod_info;
+    struct lyd_node **notif_ops = NULL;
+    sr_mod_data_dep_t **shm_deps = NULL;
+    sr_mod_t *shm_mod;
+    uint16_t *shm_dep_counts = NULL;
+    uint32_t i;
+    char *xpath = NULL;
+
+    memset(&mod_info, 0, sizeof mod_info);
 
     /* check write/read perm */
-    shm_mod = sr_shmmain_find_module(&session->conn->main_shm, session->conn->ext_shm.addr, lyd_node_module(notif)->name, 0);
-    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup_shm_unlock);
-    if ((err_info = sr_perm_check(lyd_node_module(notif)->name, (shm_mod->flags & SR_MOD_REPLAY_SUPPORT) ? 1 : 0))) {
-        goto cleanup_shm_unlock;
+    shm_mod = sr_shmmain_find_module(&session->conn->main_shm, session->conn->ext_shm.addr, lyd_node_module(notifs[0])->name, 0);
+    SR_CHECK_INT_GOTO(!shm_mod, err_info, cleanup);
+    if ((err_info = sr_perm_check(lyd_node_module(notifs[0])->name, (shm_mod->flags & SR_MOD_REPLAY_SUPPORT) ? 1 : 0))) {
+        goto cleanup;
     }
 
-    /* collect all required modules for validation (including checking that the nested notification
-     * can be invoked meaning its parent data node exists) */
-    xpath = lys_data_path(notif_op->schema);
-    SR_CHECK_MEM_GOTO(!xpath, err_info, cleanup_shm_unlock);
-    if ((err_info = sr_shmmod_collect_op(session->conn, xpath, notif_op, 0, &shm_deps, &shm_dep_count, &mod_info))) {
-        goto cleanup_shm_unlock;
+    notif_ops = malloc(notif_count * sizeof *notif_ops);
+    shm_deps = malloc(notif_count * sizeof *shm_deps);
+    shm_dep_counts = malloc(notif_count * sizeof *shm_dep_counts);
+    if (!notif_ops || !shm_deps || !shm_dep_counts) {
+        SR_ERRINFO_MEM(&err_info);
+        goto cleanup;
+    }
+
+    for (i = 0; i < notif_count; ++i) {
+        notif_ops[i] = notifs[i];
+        if ((err_info = sr_ly_find_last_parent(&notif_ops[i], LYS_NOTIF))) {
+            goto cleanup;
+        }
+
+        /* collect all required modules for validation (including checking that the nested notification
+         * can be invoked meaning its parent data node exists) */
+        xpath = lys_data_path(notif_ops[i]->schema);
+        SR_CHECK_MEM_GOTO(!xpath, err_info, cleanup);
+        if ((err_info = sr_shmmod_collect_op(session->conn, xpath, notif_ops[i], 0, &shm_deps[i], &shm_dep_counts[i],
+                &mod_info))) {
+            goto cleanup;
+        }
+        free(xpath);
+        xpath = NULL;
     }
 
     /* MODULES READ LOCK */
@@ -4511,60 +6306,224 @@ sr_event_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif)
 
     /* load all input dependency modules data */
     if ((err_info = sr_modinfo_data_load(&mod_info, MOD_INFO_TYPE_MASK, 1, &session->sid, NULL, SR_OPER_CB_TIMEOUT, 0,
-            &cb_err_info)) || cb_err_info) {
+            cb_err_info)) || *cb_err_info) {
         goto cleanup_mods_unlock;
     }
 
-    /* validate the operation */
-    if ((err_info = sr_modinfo_op_validate(&mod_info, notif_op, shm_deps, shm_dep_count, 0, &session->sid,
-            SR_OPER_CB_TIMEOUT, &cb_err_info))) {
-        goto cleanup_mods_unlock;
-    }
-    if (cb_err_info) {
-        goto cleanup_mods_unlock;
+    /* validate the operations */
+    for (i = 0; i < notif_count; ++i) {
+        if ((err_info = sr_modinfo_op_validate(&mod_info, notif_ops[i], shm_deps[i], shm_dep_counts[i], 0,
+                &session->sid, SR_OPER_CB_TIMEOUT, cb_err_info)) || *cb_err_info) {
+            goto cleanup_mods_unlock;
+        }
     }
 
+    /* success */
+
+cleanup_mods_unlock:
     /* MODULES UNLOCK */
     sr_shmmod_modinfo_unlock(&mod_info, 0);
 
-    /* store the notification for a replay, we continue on failure */
-    err_info = sr_replay_store(session, notif, notif_ts);
+cleanup:
+    free(xpath);
+    free(notif_ops);
+    free(shm_deps);
+    free(shm_dep_counts);
+    sr_modinfo_free(&mod_info);
+    return err_info;
+}
+
+/**
+ * @brief Store for replay and publish notifications of a single module. Main SHM is expected to be READ locked.
+ *
+ * @param[in] session Session to use.
+ * @param[in] notifs Notification tree roots.
+ * @param[in] notif_count Count of @p notifs.
+ * @param[in] notif_ts Notification timestamp.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_event_notif_publish(sr_session_ctx_t *session, struct lyd_node **notifs, uint32_t notif_count, time_t notif_ts)
+{
+    sr_error_info_t *err_info = NULL, *tmp_err_info = NULL;
+    sr_mod_notif_sub_t *notif_subs;
+    uint32_t notif_sub_count;
+    const char *mod_name;
+
+    mod_name = lyd_node_module(notifs[0])->name;
+
+    /* store the notifications for a replay, we continue on failure */
+    err_info = sr_replay_store_batch(session, (const struct lyd_node **)notifs, notif_count, notif_ts);
 
     /* check that there is a subscriber */
-    if ((tmp_err_info = sr_notif_find_subscriber(session->conn, lyd_node_module(notif)->name, &notif_subs, &notif_sub_count))) {
-        goto cleanup_shm_unlock;
+    if ((tmp_err_info = sr_notif_find_subscriber(session->conn, mod_name, &notif_subs, &notif_sub_count))) {
+        goto cleanup;
     }
 
     if (notif_sub_count) {
-        /* publish notif in an event, do not wait for subscribers */
-        if ((tmp_err_info = sr_shmsub_notif_notify(notif, notif_ts, session->sid, (uint32_t *)notif_subs, notif_sub_count))) {
-            goto cleanup_shm_unlock;
+        /* publish notifs in an event, do not wait for subscribers */
+        if ((tmp_err_info = sr_shmsub_notif_notify(notifs, notif_count, notif_ts, session->sid, (uint32_t *)notif_subs,
+                notif_sub_count))) {
+            goto cleanup;
         }
     } else {
-        SR_LOG_INF("There are no subscribers for \"%s\" notifications.", lyd_node_module(notif)->name);
+        SR_LOG_INF("There are no subscribers for \"%s\" notifications.", mod_name);
     }
 
-    /* success */
-    goto cleanup_shm_unlock;
+cleanup:
+    if (tmp_err_info) {
+        sr_errinfo_merge(&err_info, tmp_err_info);
+    }
+    return err_info;
+}
 
-cleanup_mods_unlock:
-    /* MODULES UNLOCK */
-    sr_shmmod_modinfo_unlock(&mod_info, 0);
+/**
+ * @brief Validate, store for replay, and publish notifications.
+ *
+ * @param[in] session Session to use.
+ * @param[in] notifs Notification tree roots.
+ * @param[in] notif_count Count of @p notifs.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+_sr_event_notif_send(sr_session_ctx_t *session, struct lyd_node **notifs, uint32_t notif_count)
+{
+    sr_error_info_t *err_info = NULL, *cb_err_info = NULL, *tmp_err_info;
+    struct lyd_node **mod_notifs = NULL;
+    const struct lys_module *ly_mod;
+    uint32_t i, j, mod_notif_count, *groups = NULL, group_count;
+    char *grouped = NULL;
+    time_t notif_ts;
+
+    /* remember when the notifications were generated */
+    notif_ts = time(NULL);
+
+    if (notif_count > 1) {
+        mod_notifs = malloc(notif_count * sizeof *mod_notifs);
+        groups = malloc((notif_count + 1) * sizeof *groups);
+        grouped = calloc(notif_count, 1);
+        if (!mod_notifs || !groups || !grouped) {
+            SR_ERRINFO_MEM(&err_info);
+            goto cleanup;
+        }
+
+        /* group the notifications of each module, keeping their order, group i is mod_notifs[groups[i]..groups[i + 1]) */
+        mod_notif_count = 0;
+        group_count = 0;
+        for (i = 0; i < notif_count; ++i) {
+            if (grouped[i]) {
+                continue;
+            }
+
+            ly_mod = lyd_node_module(notifs[i]);
+            groups[group_count++] = mod_notif_count;
+            for (j = i; j < notif_count; ++j) {
+                if (!grouped[j] && (lyd_node_module(notifs[j]) == ly_mod)) {
+                    mod_notifs[mod_notif_count++] = notifs[j];
+                    grouped[j] = 1;
+                }
+            }
+        }
+        groups[group_count] = mod_notif_count;
+    }
+
+    /* SHM LOCK (accessing subscriptions) */
+    if ((err_info = sr_shmmain_lock_remap(session->conn, SR_LOCK_READ, 0, 0, __func__))) {
+        goto cleanup;
+    }
+
+    if (notif_count == 1) {
+        if ((err_info = sr_event_notif_validate(session, notifs, 1, &cb_err_info)) || cb_err_info) {
+            goto cleanup_shm_unlock;
+        }
+        err_info = sr_event_notif_publish(session, notifs, 1, notif_ts);
+        goto cleanup_shm_unlock;
+    }
+
+    /* validate all the notifications first, those of a module at once */
+    for (i = 0; i < group_count; ++i) {
+        if ((err_info = sr_event_notif_validate(session, mod_notifs + groups[i], groups[i + 1] - groups[i],
+                &cb_err_info)) || cb_err_info) {
+            goto cleanup_shm_unlock;
+        }
+    }
+
+    /* publish notifications of each module at once */
+    for (i = 0; i < group_count; ++i) {
+        /* continue with other modules on failure */
+        tmp_err_info = sr_event_notif_publish(session, mod_notifs + groups[i], groups[i + 1] - groups[i], notif_ts);
+        sr_errinfo_merge(&err_info, tmp_err_info);
+    }
 
 cleanup_shm_unlock:
     /* SHM UNLOCK */
     sr_shmmain_unlock(session->conn, SR_LOCK_READ, 0, 0, __func__);
 
-    free(xpath);
-    sr_modinfo_free(&mod_info);
-    if (tmp_err_info) {
-        sr_errinfo_merge(&err_info, tmp_err_info);
-    }
+cleanup:
+    free(mod_notifs);
+    free(groups);
+    free(grouped);
     if (cb_err_info) {
         /* return callback error if some was generated */
         sr_errinfo_merge(&err_info, cb_err_info);
         err_info->err_code = SR_ERR_CALLBACK_FAILED;
     }
+    return err_info;
+}
+
+API int
+sr_event_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!session || !notif, session, err_info);
+    if (session->conn->ly_ctx != notif->schema->module->ctx) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Data trees must be created using the session connection libyang context.");
+        return sr_api_ret(session, err_info);
+    }
+
+    /* check notif data tree */
+    if ((err_info = sr_event_notif_find_root(&notif))) {
+        return sr_api_ret(session, err_info);
+    }
+
+    err_info = _sr_event_notif_send(session, &notif, 1);
+    return sr_api_ret(session, err_info);
+}
+
+API int
+sr_event_notif_send_batch(sr_session_ctx_t *session, struct lyd_node **notifs, uint32_t notif_count)
+{
+    sr_error_info_t *err_info = NULL;
+    struct lyd_node **roots = NULL;
+    uint32_t i;
+
+    SR_CHECK_ARG_APIRET(!session || !notifs || !notif_count, session, err_info);
+
+    roots = malloc(notif_count * sizeof *roots);
+    SR_CHECK_MEM_GOTO(!roots, err_info, cleanup);
+
+    for (i = 0; i < notif_count; ++i) {
+        if (!notifs[i]) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Invalid arguments for function \"%s\".", __func__);
+            goto cleanup;
+        }
+        if (session->conn->ly_ctx != notifs[i]->schema->module->ctx) {
+            sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Data trees must be created using the session connection libyang context.");
+            goto cleanup;
+        }
+
+        /* check notif data tree */
+        roots[i] = notifs[i];
+        if ((err_info = sr_event_notif_find_root(&roots[i]))) {
+            goto cleanup;
+        }
+    }
+
+    err_info = _sr_event_notif_send(session, roots, notif_count);
+
+cleanup:
+    free(roots);
     return sr_api_ret(session, err_info);
 }
 
@@ -4697,6 +6656,7 @@ sr_oper_get_items_subscribe(sr_session_ctx_t *session, const char *module_name,
     sr_conn_ctx_t *conn;
     const struct lys_module *ly_mod;
     sr_mod_oper_sub_type_t sub_type;
+    sr_subscr_options_t sub_opts;
     sr_mod_t *shm_mod;
 
     SR_CHECK_ARG_APIRET(!session || !module_name || !path || !callback || !subscription, session, err_info);
@@ -4707,6 +6667,8 @@ sr_oper_get_items_subscribe(sr_session_ctx_t *session, const char *module_name,
     }
 
     conn = session->conn;
+    /* only these options are relevant outside this function and will be stored */
+    sub_opts = opts & (SR_SUBSCR_OPER_BATCH | SR_SUBSCR_OPER_CONCURRENT | SR_SUBSCR_OPER_CACHE_SESSION);
 
     ly_mod = ly_ctx_get_module(conn->ly_ctx, module_name, NULL, 1);
     if (!ly_mod) {
@@ -4741,12 +6703,13 @@ sr_oper_get_items_subscribe(sr_session_ctx_t *session, const char *module_name,
     SR_CHECK_INT_GOTO(!shm_mod, err_info, error_unlock_unsub);
 
     /* add oper subscription into main SHM */
-    if ((err_info = sr_shmmod_oper_subscription_add(&conn->ext_shm, shm_mod, path, sub_type, (*subscription)->evpipe_num))) {
+    if ((err_info = sr_shmmod_oper_subscription_add(&conn->ext_shm, shm_mod, path, sub_type, sub_opts,
+            (*subscription)->evpipe_num))) {
         goto error_unlock_unsub;
     }
 
     /* add subscription into structure and create separate specific SHM segment */
-    if ((err_info = sr_sub_oper_add(session, module_name, path, callback, private_data, *subscription))) {
+    if ((err_info = sr_sub_oper_add(session, module_name, path, callback, private_data, sub_opts, *subscription))) {
         goto error_unlock_unsub_unmod;
     }
 
@@ -4760,7 +6723,7 @@ sr_oper_get_items_subscribe(sr_session_ctx_t *session, const char *module_name,
     goto cleanup_unlock;
 
 error_unlock_unsub_unmod:
-    sr_shmmod_oper_subscription_del(conn->ext_shm.addr, shm_mod, path, (*subscription)->evpipe_num, 0, NULL);
+    sr_shmmod_oper_subscription_del(conn->ext_shm.addr, shm_mod, path, (*subscription)->evpipe_num, 0, NULL, NULL);
 
 error_unlock_unsub:
     if (opts & SR_SUBSCR_CTX_REUSE) {
@@ -4776,3 +6739,106 @@ cleanup_unlock:
 
     return sr_api_ret(session, err_info);
 }
+
+/**
+ * @brief Change caching of the data of an operational subscription.
+ *
+ * @param[in] subscription Subscription context.
+ * @param[in] module_name Name of the module of the subscription.
+ * @param[in] path Path of the subscription.
+ * @param[in] set_ttl Whether to set the validity period or only invalidate cached data.
+ * @param[in] ttl_ms Validity period of the data to set.
+ * @return err_info, NULL on success.
+ */
+static sr_error_info_t *
+sr_oper_sub_cache_set(sr_subscription_ctx_t *subscription, const char *module_name, const char *path, int set_ttl,
+        uint32_t ttl_ms)
+{
+    sr_error_info_t *err_info = NULL;
+    sr_conn_ctx_t *conn = subscription->conn;
+    sr_mod_t *shm_mod;
+    sr_mod_oper_sub_t *shm_msub;
+    uint16_t i;
+
+    /* SHM LOCK */
+    if ((err_info = sr_shmmain_lock_remap(conn, SR_LOCK_READ, 0, 0, __func__))) {
+        return err_info;
+    }
+
+    /* find module */
+    shm_mod = sr_shmmain_find_module(&conn->main_shm, conn->ext_shm.addr, module_name, 0);
+    if (!shm_mod) {
+        sr_errinfo_new(&err_info, SR_ERR_INVAL_ARG, NULL, "Module \"%s\" was not found in sysrepo.", module_name);
+        goto cleanup_unlock;
+    }
+
+    /* find the subscription */
+    shm_msub = (sr_mod_oper_sub_t *)(conn->ext_shm.addr + shm_mod->oper_subs);
+    for (i = 0; i < shm_mod->oper_sub_count; ++i) {
+        if ((shm_msub[i].evpipe_num == subscription->evpipe_num) && !strcmp(conn->ext_shm.addr + shm_msub[i].xpath, path)) {
+            break;
+        }
+    }
+    if (i == shm_mod->oper_sub_count) {
+        sr_errinfo_new(&err_info, SR_ERR_NOT_FOUND, NULL, "Operational subscription \"%s\" not found.", path);
+        goto cleanup_unlock;
+    }
+
+    if (set_ttl) {
+        ATOMIC_STORE_RELAXED(shm_msub[i].cache_ttl_ms, ttl_ms);
+    }
+
+    /* invalidate any cached data */
+    ATOMIC_INC_RELAXED(shm_msub[i].cache_ver);
+
+cleanup_unlock:
+    /* SHM UNLOCK */
+    sr_shmmain_unlock(conn, SR_LOCK_READ, 0, 0, __func__);
+    return err_info;
+}
+
+API int
+sr_oper_get_items_cache(sr_subscription_ctx_t *subscription, const char *module_name, const char *path, uint32_t ttl_ms)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!subscription || !module_name || !path, NULL, err_info);
+
+    err_info = sr_oper_sub_cache_set(subscription, module_name, path, 1, ttl_ms);
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_oper_get_items_cache_invalidate(sr_subscription_ctx_t *subscription, const char *module_name, const char *path)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!subscription || !module_name || !path, NULL, err_info);
+
+    err_info = sr_oper_sub_cache_set(subscription, module_name, path, 0, 0);
+    return sr_api_ret(NULL, err_info);
+}
+
+API int
+sr_oper_cache_stats(sr_conn_ctx_t *conn, uint32_t *hit_count, uint32_t *miss_count)
+{
+    sr_error_info_t *err_info = NULL;
+
+    SR_CHECK_ARG_APIRET(!conn, NULL, err_info);
+
+    /* CACHE LOCK */
+    if ((err_info = sr_mlock(&conn->oper_cache.lock, -1, __func__))) {
+        return sr_api_ret(NULL, err_info);
+    }
+
+    if (hit_count) {
+        *hit_count = conn->oper_cache.hit_count;
+    }
+    if (miss_count) {
+        *miss_count = conn->oper_cache.miss_count;
+    }
+
+    /* CACHE UNLOCK */
+    sr_munlock(&conn->oper_cache.lock);
+    return sr_api_ret(NULL, NULL);
+}
@@ -743,6 +743,104 @@ int sr_get_item(sr_session_ctx_t *session, const char *path, uint32_t timeout_ms
 int sr_get_items(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms, const sr_get_oper_options_t opts,
         sr_val_t **values, size_t *value_cnt);
 
+/**
+ * @brief Prepared XPath used by ::sr_get_items_prepared and ::sr_get_data_prepared calls.
+ */
+typedef struct sr_xpath_s sr_xpath_t;
+
+/**
+ * @brief Prepare an XPath to be used repeatedly for data retrieval.
+ *
+ * Schema evaluation of the XPath needed to learn the modules with the selected data and resolving all
+ * the modules these data depend on are performed only once so gets using the prepared XPath are cheaper.
+ * The prepared XPath can be used with any session of the connection and in any datastore. Should the connection
+ * context change, the modules are learned again by every get.
+ *
+ * @param[in] conn Connection to use.
+ * @param[in] xpath [XPath](@ref paths) to prepare.
+ * @param[out] prepared Prepared XPath, should be freed with ::sr_xpath_free.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_xpath_prepare(sr_conn_ctx_t *conn, const char *xpath, sr_xpath_t **prepared);
+
+/**
+ * @brief Free a prepared XPath.
+ *
+ * @param[in] prepared Prepared XPath to free.
+ */
+void sr_xpath_free(sr_xpath_t *prepared);
+
+/**
+ * @brief Retrieve an array of data elements selected by a prepared XPath.
+ * Works the same way as ::sr_get_items.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] prepared XPath prepared by ::sr_xpath_prepare on the session connection.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[out] values Array of requested nodes, allocated dynamically (free using ::sr_free_values).
+ * @param[out] value_cnt Number of returned elements in the values array.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_get_items_prepared(sr_session_ctx_t *session, const sr_xpath_t *prepared, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts, sr_val_t **values, size_t *value_cnt);
+
+/**
+ * @brief Iterator used for retrieval of data elements using ::sr_get_items_iter call.
+ */
+typedef struct sr_val_iter_s sr_val_iter_t;
+
+/**
+ * @brief Create an iterator for retrieving data elements selected by the provided XPath.
+ * Data are represented as ::sr_val_t structures.
+ *
+ * Unlike ::sr_get_items, the elements are converted into ::sr_val_t only when retrieved using
+ * ::sr_get_item_next or ::sr_get_items_next so the memory needed does not depend on the number
+ * of the selected elements. The iterator does not hold any locks, it works on a snapshot of the data.
+ *
+ * Required READ access.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] xpath [XPath](@ref paths) of the data elements to be retrieved.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[out] iter Iterator context that can be used to retrieve the individual elements. Allocated by the function,
+ * should be freed with ::sr_free_val_iter.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_get_items_iter(sr_session_ctx_t *session, const char *xpath, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts, sr_val_iter_t **iter);
+
+/**
+ * @brief Return the next data element from an iterator created by ::sr_get_items_iter call.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) used for creating the iterator.
+ * @param[in,out] iter Iterator acquired with ::sr_get_items_iter call.
+ * @param[out] value Next data element, allocated dynamically (free using ::sr_free_val).
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND if there are no more elements).
+ */
+int sr_get_item_next(sr_session_ctx_t *session, sr_val_iter_t *iter, sr_val_t **value);
+
+/**
+ * @brief Return a chunk of the next data elements from an iterator created by ::sr_get_items_iter call.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) used for creating the iterator.
+ * @param[in,out] iter Iterator acquired with ::sr_get_items_iter call.
+ * @param[in] max_count Maximum number of returned elements.
+ * @param[out] values Array of the next elements, allocated dynamically (free using ::sr_free_values).
+ * @param[out] value_cnt Number of returned elements in the values array.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND if there are no more elements).
+ */
+int sr_get_items_next(sr_session_ctx_t *session, sr_val_iter_t *iter, size_t max_count, sr_val_t **values,
+        size_t *value_cnt);
+
+/**
+ * @brief Free ::sr_val_iter_t iterator and all memory allocated within it.
+ *
+ * @param[in] iter Iterator to be freed.
+ */
+void sr_free_val_iter(sr_val_iter_t *iter);
+
 /**
  * @brief Retrieve a single subtree whose root node is selected by the provided path.
  * Data are represented as _libyang_ subtrees.
@@ -789,6 +887,109 @@ int sr_get_subtree(sr_session_ctx_t *session, const char *path, uint32_t timeout
 int sr_get_data(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, uint32_t timeout_ms,
         const sr_get_oper_options_t opts, struct lyd_node **data);
 
+/**
+ * @brief Retrieve a tree whose root nodes are a page of the nodes matching the provided XPath.
+ * Data are represented as _libyang_ subtrees.
+ *
+ * Works the same way as ::sr_get_data() but only a continuous part of the nodes selected by @p xpath,
+ * in the data tree order, is returned. Only the returned subtrees are duplicated so paging through
+ * a large list (such as a RIB) with a small @p limit is cheaper than getting it whole. If @p xpath is
+ * a simple path to a list or leaf-list (without predicates and with no list ancestors), the page is found
+ * directly from the @p after_path instance, otherwise all the nodes selected by @p xpath are searched.
+ *
+ * If @p xpath is such a simple path and @p limit is set, the operational data providers of the paged instances
+ * are told about the page (see ::sr_session_get_oper_page) so that they can return only the instances of the page.
+ * The stored data of the modules are always loaded whole, except for _running_ with ::SR_CONN_CACHE_RUNNING
+ * when the cached data are used directly and each page costs only about its size.
+ *
+ * Required READ access.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] xpath [XPath](@ref paths) selecting root nodes of subtrees to be retrieved.
+ * @param[in] max_depth Maximum depth of the selected subtrees. 0 is unlimited, 1 will not return any
+ * descendant nodes. If a list should be returned, its keys are always returned as well.
+ * @param[in] after_path Optional [path](@ref paths) identifying one of the nodes selected by @p xpath,
+ * typically the last node of the previous page. Only nodes following it are returned.
+ * @param[in] offset Number of the selected nodes (following @p after_path, if set) to skip.
+ * @param[in] limit Maximum number of returned subtrees, 0 for no limit.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[out] data Connected top-level trees with the requested page of the data, allocated dynamically.
+ * NULL if there are no more data.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND if @p after_path is not one of the selected nodes).
+ */
+int sr_get_data_page(sr_session_ctx_t *session, const char *xpath, uint32_t max_depth, const char *after_path,
+        uint32_t offset, uint32_t limit, uint32_t timeout_ms, const sr_get_oper_options_t opts, struct lyd_node **data);
+
+/**
+ * @brief Retrieve several trees, each with the subtrees selected by one path, in a single call.
+ *
+ * Works as calling ::sr_get_data for every path but all the required modules are locked and their
+ * data loaded only once. Every operational data provider is asked only once, for the union of the paths
+ * that select its data.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] xpaths Array of [XPaths](@ref paths) selecting the root nodes of subtrees to be retrieved.
+ * @param[in] max_depths Optional array of maximum depths of the subtrees selected by each path, see ::sr_get_data.
+ * If not set, all the subtrees are retrieved whole.
+ * @param[in] xpath_count Number of @p xpaths (and @p max_depths).
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[out] data Array of @p xpath_count connected top-level trees, one for every path, with the selected data.
+ * Each should be freed with `lyd_free_withsiblings()`, NULL if a path selects no data.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_get_data_multi(sr_session_ctx_t *session, const char **xpaths, const uint32_t *max_depths, uint32_t xpath_count,
+        uint32_t timeout_ms, const sr_get_oper_options_t opts, struct lyd_node **data);
+
+/**
+ * @brief Retrieve a tree whose root nodes match a prepared XPath.
+ * Works the same way as ::sr_get_data.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] prepared XPath prepared by ::sr_xpath_prepare on the session connection.
+ * @param[in] max_depth Maximum depth of the selected subtrees. 0 is unlimited, 1 will not return any
+ * descendant nodes. If a list should be returned, its keys are always returned as well.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour.
+ * @param[out] data Connected top-level trees with all the requested data, allocated dynamically.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_get_data_prepared(sr_session_ctx_t *session, const sr_xpath_t *prepared, uint32_t max_depth, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts, struct lyd_node **data);
+
+/**
+ * @brief Start a read transaction. All the following data retrievals (::sr_get_item, ::sr_get_items,
+ * ::sr_get_items_iter, ::sr_get_subtree, ::sr_get_data, ::sr_get_data_page, ::sr_get_data_multi, and their prepared
+ * variants) on the current datastore of the session are served from a snapshot until ::sr_read_end is called.
+ *
+ * The snapshot is formed by the data selected by @p xpaths and it is loaded right away. Data of all the modules
+ * required by the paths are loaded together while these modules are locked, so the snapshot is consistent across
+ * them. Operational providers are asked only if their data are selected and they are given the union of @p xpaths
+ * as the request XPath. All the following retrievals only select the data in the snapshot without any locking
+ * or permission checks, so they see the data unchanged and any data not selected by @p xpaths are not found.
+ * Changes prepared in the session are not reflected in the snapshot. Iterators created during the transaction
+ * can be used only until its end.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] xpaths Array of [XPaths](@ref paths) selecting the data of the snapshot.
+ * @param[in] xpath_count Count of @p xpaths.
+ * @param[in] timeout_ms Operational callback timeout in milliseconds. If 0, default is used.
+ * @param[in] opts Options overriding default get behaviour used for loading the snapshot, those of
+ * the retrievals are ignored.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_read_begin(sr_session_ctx_t *session, const char **xpaths, uint32_t xpath_count, uint32_t timeout_ms,
+        const sr_get_oper_options_t opts);
+
+/**
+ * @brief End a read transaction started by ::sr_read_begin and free its snapshot.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_read_end(sr_session_ctx_t *session);
+
 /**
  * @brief Free ::sr_val_t structure and all memory allocated within it.
  *
@@ -939,6 +1140,50 @@ int sr_move_item(sr_session_ctx_t *session, const char *path, const sr_move_posi
  */
 int sr_edit_batch(sr_session_ctx_t *session, const struct lyd_node *edit, const char *default_operation);
 
+/**
+ * @brief Single change of an edit created by ::sr_edit_batch_items.
+ */
+typedef struct sr_edit_item_s {
+    const char *path;           /**< [Path](@ref paths) identifier of the changed data element. */
+    const char *value;          /**< String representation of the value of the data element, NULL if none. */
+    const char *operation;      /**< Operation of the data element, `merge`, `replace`, `create`, `delete`, `remove`,
+                                     or `none` (see [NETCONF RFC](https://tools.ietf.org/html/rfc6241#page-39)).
+                                     If NULL, it is inherited from the parent. */
+} sr_edit_item_t;
+
+/**
+ * @brief Create an edit from an array of changes to be applied.
+ * These changes are applied only after calling ::sr_apply_changes.
+ *
+ * Works as creating an edit data tree and passing it to ::sr_edit_batch. If the changes are sorted so that
+ * changes of sibling nodes follow each other, their parent is not searched for again but reused, which makes
+ * creating large edits much faster than calling `sr_*_item()` functions.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] items Array of the changes.
+ * @param[in] item_count Count of @p items.
+ * @param[in] default_operation Default operation for nodes without operation on themselves or any parent.
+ * Possible values are `merge`, `replace`, or `none` (see [NETCONF RFC](https://tools.ietf.org/html/rfc6241#page-39)).
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_edit_batch_items(sr_session_ctx_t *session, const sr_edit_item_t *items, size_t item_count,
+        const char *default_operation);
+
+/**
+ * @brief Set whether edits created by ::sr_edit_batch and ::sr_edit_batch_items are checked right away.
+ *
+ * When enabled, invalid combinations of operations in the edit are reported by these functions instead of
+ * by ::sr_apply_changes after the data are locked and loaded. The edit is also normalized, operations
+ * equal to the inherited ones are removed and `remove` operations in removed subtrees are dropped.
+ * Errors depending on the current data (such as deleting a non-existing node) can still be found only
+ * when the changes are applied. Disabled by default.
+ *
+ * @param[in] session Session (not [DS](@ref sr_datastore_t)-specific) to change.
+ * @param[in] enable Non-zero to enable the checks, 0 to disable them.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_session_set_edit_check(sr_session_ctx_t *session, int enable);
+
 /**
  * @brief Perform the validation a datastore and any changes made in the current session, but do not
  * apply nor discard them.
@@ -970,6 +1215,77 @@ int sr_validate(sr_session_ctx_t *session, uint32_t timeout_ms);
  */
 int sr_apply_changes(sr_session_ctx_t *session, uint32_t timeout_ms, int wait);
 
+/**
+ * @brief Handle of changes applied asynchronously by ::sr_apply_changes_async().
+ */
+typedef struct sr_apply_handle_s sr_apply_handle_t;
+
+/**
+ * @brief Callback called once asynchronously applied changes are finished, from a separate thread.
+ *
+ * @param[in] handle Handle of the applied changes, it can be waited for and freed by the callback.
+ * @param[in] result Error code of applying the changes (::SR_ERR_OK on success).
+ * @param[in] err_info Detailed error information, if any.
+ * @param[in] private_data Private data passed to ::sr_apply_changes_async().
+ */
+typedef void (*sr_apply_changes_cb)(sr_apply_handle_t *handle, int result, const sr_error_info_t *err_info,
+        void *private_data);
+
+/**
+ * @brief Apply changes made in the current session asynchronously. The function returns immediately and
+ * the changes are queued to be applied with the same effect as ::sr_apply_changes(). All the queued changes
+ * of a connection are applied in order by a single thread. Completion is reported by the callback,
+ * by the handle file descriptor becoming ready for reading, or it can be waited for using ::sr_apply_handle_wait().
+ *
+ * The changes are moved from the session into the handle so the session can be used to prepare
+ * other changes right away. They are applied by a private session with the ID, NETCONF ID, and user of the session
+ * so locks held by the session apply to them and subscribers learn the same originator. If the session is stopped
+ * before the changes are applied, its locks are released. The changes are discarded even if they could not be applied.
+ *
+ * The session can be stopped while the changes are being applied. ::sr_disconnect() waits until all
+ * the queued changes of the connection are applied but the handles stay valid and must still be freed.
+ * The callback must not call ::sr_disconnect() on the connection or wait for other changes queued after these.
+ *
+ * Required WRITE access.
+ *
+ * @param[in] session Session ([DS](@ref sr_datastore_t)-specific) to apply changes of.
+ * @param[in] timeout_ms Configuration callback timeout in milliseconds. If 0, default is used.
+ * @param[in] wait Whether to wait until all callbacks on all events are finished before completing.
+ * @param[in] callback Optional callback called on completion.
+ * @param[in] private_data Private data passed to @p callback.
+ * @param[out] handle Handle of the applied changes, free with ::sr_apply_handle_free().
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_apply_changes_async(sr_session_ctx_t *session, uint32_t timeout_ms, int wait, sr_apply_changes_cb callback,
+        void *private_data, sr_apply_handle_t **handle);
+
+/**
+ * @brief Get the file descriptor of a handle of changes applied asynchronously. It becomes ready for reading
+ * in `select()`, `poll()`, or similar functions once the changes are applied, before the callback is called.
+ *
+ * @param[in] handle Handle of the applied changes.
+ * @param[out] fd File descriptor, do not close or read from it! It will be closed when the handle is freed.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_apply_handle_get_fd(sr_apply_handle_t *handle, int *fd);
+
+/**
+ * @brief Wait until changes applied asynchronously are finished and learn the result.
+ *
+ * @param[in] handle Handle of the applied changes.
+ * @param[out] error_info Optional detailed error information, valid until the handle is freed.
+ * @return Error code of applying the changes (::SR_ERR_OK on success).
+ */
+int sr_apply_handle_wait(sr_apply_handle_t *handle, const sr_error_info_t **error_info);
+
+/**
+ * @brief Free a handle of changes applied asynchronously, waits for them to be finished and for the callback
+ * to return, unless called from the callback itself.
+ *
+ * @param[in] handle Handle to free.
+ */
+void sr_apply_handle_free(sr_apply_handle_t *handle);
+
 /**
  * @brief Discard prepared changes made in the current session.
  *
@@ -1158,6 +1474,30 @@ typedef enum sr_subscr_flag_e {
      */
     SR_SUBSCR_UNLOCKED = 64,
 
+    /**
+     * @brief The operational data provider wants to be called only once for all the instances of its data parent
+     * instead of once for each instance. The callback is then given the top-level node of a tree with all
+     * the existing parent instances and is supposed to append the requested nodes to each of them. Accepted **only**
+     * for operational subscriptions, it makes no sense for others. Data of these subscriptions are never cached
+     * (::sr_oper_get_items_cache).
+     */
+    SR_SUBSCR_OPER_BATCH = 128,
+
+    /**
+     * @brief The operational data provider is able to serve several requests at once. Several requesters can then
+     * send their requests at the same time instead of waiting for the previous request to be processed. Useful
+     * especially together with a worker thread pool (::sr_subscription_thread_pool). Accepted **only** for operational
+     * subscriptions, it makes no sense for others.
+     */
+    SR_SUBSCR_OPER_CONCURRENT = 256,
+
+    /**
+     * @brief The operational data provider returns different data for different sessions so its cached data
+     * (::sr_oper_get_items_cache) are used only for the requests of the same session. Data are always cached
+     * separately for each user. Accepted **only** for operational subscriptions, it makes no sense for others.
+     */
+    SR_SUBSCR_OPER_CACHE_SESSION = 512,
+
 } sr_subscr_flag_t;
 
 /**
@@ -1197,6 +1537,79 @@ int sr_get_event_pipe(sr_subscription_ctx_t *subscription, int *event_pipe);
  */
 int sr_process_events(sr_subscription_ctx_t *subscription, sr_session_ctx_t *session, time_t *stop_time_in);
 
+/**
+ * @brief Set the number of worker threads processing the events of a subscription. Events of different modules
+ * (or RPCs/actions) and of different operational subscriptions are then processed in parallel by the workers
+ * while the events of a single module (or RPC/action) are still processed in order. Concurrent requests
+ * of an ::SR_SUBSCR_OPER_CONCURRENT subscription are also processed in parallel.
+ * Without any worker threads (default), all the events are processed serially by the thread calling
+ * ::sr_process_events().
+ *
+ * Changing the number of threads first waits for all the events already queued for the current workers
+ * to be processed.
+ *
+ * @param[in] subscription Subscription to use.
+ * @param[in] thread_count Number of worker threads, 0 to stop all the workers and process events serially.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_subscription_thread_pool(sr_subscription_ctx_t *subscription, uint32_t thread_count);
+
+/**
+ * @brief Event loop processing events of several subscriptions in a single thread.
+ */
+typedef struct sr_event_loop_s sr_event_loop_t;
+
+/**
+ * @brief Create a new event loop.
+ *
+ * @param[out] loop Created event loop, free with ::sr_event_loop_free().
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_event_loop_new(sr_event_loop_t **loop);
+
+/**
+ * @brief Add a subscription into an event loop. Do not add it unless ::SR_SUBSCR_NO_THREAD flag was used
+ * when subscribing!
+ *
+ * @param[in] loop Event loop to use.
+ * @param[in] subscription Subscription without a listening thread to add. It must be removed from the loop
+ * using ::sr_event_loop_del() before it is unsubscribed.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_event_loop_add(sr_event_loop_t *loop, sr_subscription_ctx_t *subscription);
+
+/**
+ * @brief Remove a subscription from an event loop.
+ *
+ * @param[in] loop Event loop to use.
+ * @param[in] subscription Subscription to remove.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_event_loop_del(sr_event_loop_t *loop, sr_subscription_ctx_t *subscription);
+
+/**
+ * @brief Wait for new events on any of the subscriptions in an event loop and process them. Only subscriptions
+ * with some new events (or with an elapsed notification subscription stop time) are processed, by
+ * calling ::sr_process_events() on them.
+ *
+ * @param[in] loop Event loop to use.
+ * @param[in] timeout_ms Maximum time to wait for a new event, -1 for no timeout. It is shortened to the nearest
+ * notification subscription stop time. The whole timeout is waited even if there are no subscriptions in @p loop.
+ * @param[in] session Optional session for storing errors.
+ * @param[out] ready Optional subscriptions that were processed, valid until the next call.
+ * @param[out] ready_count Optional count of @p ready.
+ * @return Error code (::SR_ERR_OK on success, also if no events occured before the timeout elapsed).
+ */
+int sr_event_loop_process(sr_event_loop_t *loop, int timeout_ms, sr_session_ctx_t *session,
+        sr_subscription_ctx_t ***ready, uint32_t *ready_count);
+
+/**
+ * @brief Free an event loop. The subscriptions in it are not affected.
+ *
+ * @param[in] loop Event loop to free.
+ */
+void sr_event_loop_free(sr_event_loop_t *loop);
+
 /**
  * @brief Unsubscribes from a subscription acquired by any of sr_*_subscribe
  * calls and releases all subscription-related data.
@@ -1344,6 +1757,39 @@ int sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, sr_change_
 int sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_oper_t *operation,
         sr_val_t **old_value, sr_val_t **new_value);
 
+/**
+ * @brief Single change returned by ::sr_get_change_next_batch.
+ */
+typedef struct sr_change_s {
+    sr_change_oper_t oper;      /**< Type of the operation made on the item. */
+    sr_val_t *old_value;        /**< Old value of the item, same meaning as in ::sr_get_change_next. */
+    sr_val_t *new_value;        /**< New value of the item, same meaning as in ::sr_get_change_next. */
+} sr_change_t;
+
+/**
+ * @brief Return up to @p max_count next changes from the provided iterator created
+ * by ::sr_get_changes_iter call at once. Data are represented as ::sr_val_t structures.
+ *
+ * Same as calling ::sr_get_change_next repeatedly, useful for processing large changesets.
+ *
+ * @param[in] session Implicit session provided in the callbacks (::sr_module_change_cb). Will not work with other sessions.
+ * @param[in,out] iter Iterator acquired with ::sr_get_changes_iter call.
+ * @param[in] max_count Maximum number of changes to return.
+ * @param[out] changes Array of the changes, should be freed with ::sr_free_changes.
+ * @param[out] change_count Number of returned changes.
+ * @return Error code (::SR_ERR_OK on success, ::SR_ERR_NOT_FOUND on no more changes).
+ */
+int sr_get_change_next_batch(sr_session_ctx_t *session, sr_change_iter_t *iter, uint32_t max_count, sr_change_t **changes,
+        uint32_t *change_count);
+
+/**
+ * @brief Free an array of changes returned by ::sr_get_change_next_batch.
+ *
+ * @param[in] changes Array of changes to free.
+ * @param[in] change_count Number of changes in the array.
+ */
+void sr_free_changes(sr_change_t *changes, uint32_t change_count);
+
 /**
  * @brief Returns the next change from the provided iterator created
  * by ::sr_get_changes_iter call. Data are represented as _libyang_ subtrees.
@@ -1633,6 +2079,22 @@ int sr_event_notif_send(sr_session_ctx_t *session, const char *path, const sr_va
  */
 int sr_event_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif);
 
+/**
+ * @brief Send several notifications at once. All of them are validated first and then those of the same module
+ * are stored for replay and published to subscribers together, in a single event. Subscribers receive them
+ * in order, one by one, in their callbacks.
+ *
+ * Required WRITE access. If the module does not support replay, required READ access.
+ *
+ * @note Notifications must be valid in (are validated against) the [operational datastore](@ref oper_ds) context.
+ *
+ * @param[in] session Session (not [DS](@ref sr_datastore_t)-specific) to use.
+ * @param[in] notifs Array of notification data trees to send.
+ * @param[in] notif_count Count of @p notifs.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_event_notif_send_batch(sr_session_ctx_t *session, struct lyd_node **notifs, uint32_t notif_count);
+
 /** @} notifsubs */
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1654,6 +2116,9 @@ int sr_event_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif);
  * they will be called after this one (and when they are called, their parent children will again be removed
  * which can result in nodes provided by the original callback being lost).
  *
+ * If only a page of the provided list or leaf-list instances was requested (see ::sr_get_data_page), the callback
+ * can learn it using ::sr_session_get_oper_page and return only that page.
+ *
  * @note Callback is allowed to modify installed YANG modules but MUST not modify subscriptions. It would result in
  * a deadlock and this callback timeout.
  *
@@ -1665,13 +2130,32 @@ int sr_event_notif_send_tree(sr_session_ctx_t *session, struct lyd_node *notif);
  * @param[in] request_id Request ID unique for the specific \p module_name.
  * @param[in,out] parent Pointer to an existing parent of the requested nodes. Is NULL for top-level nodes.
  * Caller is supposed to append the requested nodes to this data subtree and return either the original parent
- * or a top-level node.
+ * or a top-level node. For ::SR_SUBSCR_OPER_BATCH subscriptions it is the first top-level node of a data tree
+ * with all the parents of the requested nodes.
  * @param[in] private_data Private context opaque to sysrepo, as passed to ::sr_oper_get_items_subscribe call.
  * @return User error code (::SR_ERR_OK on success).
  */
 typedef int (*sr_oper_get_items_cb)(sr_session_ctx_t *session, const char *module_name, const char *path,
         const char *request_xpath, uint32_t request_id, struct lyd_node **parent, void *private_data);
 
+/**
+ * @brief Learn whether only a page of the list or leaf-list instances provided by an operational subscription
+ * is requested. It is requested by ::sr_get_data_page with a simple path to the list or leaf-list so only
+ * subscriptions providing these instances (or any of their ancestors) learn about the page.
+ *
+ * The callback can then return only the @p after_path instance followed by the next @p count instances selected
+ * by the request, in the order it would return all of them. If @p after_path is NULL, it can return only the first
+ * @p count instances. If it does not provide the @p after_path instance, it must return all the instances. Returning
+ * more instances is always correct. Subscriptions with cached data (see ::sr_oper_get_items_cache) never learn
+ * about a page so that their cached data can be used for any page.
+ *
+ * @param[in] session Implicit session of the operational callback.
+ * @param[out] after_path Optional [path](@ref paths) of the instance the page follows, NULL for the first page.
+ * @param[out] count Number of the requested instances following @p after_path, 0 if all the data are requested.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_session_get_oper_page(sr_session_ctx_t *session, const char **after_path, uint32_t *count);
+
 /**
  * @brief Register for providing operational data at the given xpath.
  *
@@ -1691,6 +2175,44 @@ typedef int (*sr_oper_get_items_cb)(sr_session_ctx_t *session, const char *modul
 int sr_oper_get_items_subscribe(sr_session_ctx_t *session, const char *module_name, const char *path,
         sr_oper_get_items_cb callback, void *private_data, sr_subscr_options_t opts, sr_subscription_ctx_t **subscription);
 
+/**
+ * @brief Allow the operational data provided by a subscription to be cached by the requesting connections.
+ *
+ * Until the validity period elapses, any identical request (same subscription, data parent, request XPath, and user
+ * or session with ::SR_SUBSCR_OPER_CACHE_SESSION) in the same connection is answered from the cache and the callback
+ * is not called. Only a limited number of data are cached in a connection, those expiring first are dropped when
+ * the limit is reached. Providers whose data change should call ::sr_oper_get_items_cache_invalidate. Any previously
+ * cached data are invalidated.
+ *
+ * @param[in] subscription Subscription context with the operational subscription.
+ * @param[in] module_name Name of the module of the subscription.
+ * @param[in] path [Path](@ref paths) of the subscription, as used in ::sr_oper_get_items_subscribe call.
+ * @param[in] ttl_ms Validity period of the provided data in milliseconds, 0 to disable caching.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_oper_get_items_cache(sr_subscription_ctx_t *subscription, const char *module_name, const char *path,
+        uint32_t ttl_ms);
+
+/**
+ * @brief Invalidate all the cached operational data provided by a subscription, in all the connections.
+ *
+ * @param[in] subscription Subscription context with the operational subscription.
+ * @param[in] module_name Name of the module of the subscription.
+ * @param[in] path [Path](@ref paths) of the subscription, as used in ::sr_oper_get_items_subscribe call.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_oper_get_items_cache_invalidate(sr_subscription_ctx_t *subscription, const char *module_name, const char *path);
+
+/**
+ * @brief Learn how many operational data requests of a connection were answered from the cache.
+ *
+ * @param[in] conn Connection to use.
+ * @param[out] hit_count Optional number of requests answered from the cache.
+ * @param[out] miss_count Optional number of requests of cached subscriptions that called the callback.
+ * @return Error code (::SR_ERR_OK on success).
+ */
+int sr_oper_cache_stats(sr_conn_ctx_t *conn, uint32_t *hit_count, uint32_t *miss_count);
+
 /** @} oper_subs */
 
 ////////////////////////////////////////////////////////////////////////////////
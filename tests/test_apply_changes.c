@@ -38,6 +38,7 @@
 struct state {
     sr_conn_ctx_t *conn;
     volatile int cb_called, cb_called2;
+    volatile uint32_t ev_sid;
     pthread_barrier_t barrier, barrier2;
 };
 
@@ -3577,6 +3578,505 @@ test_change_userord(void **state)
     pthread_join(tid[1], NULL);
 }
 
+/* TEST 12 */
+static int
+module_change_async_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, sr_event_t event,
+        uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    if (event == SR_EV_CHANGE) {
+        st->ev_sid = sr_session_get_id(session);
+        ++st->cb_called;
+    }
+    return SR_ERR_OK;
+}
+
+static void
+apply_changes_async_cb(sr_apply_handle_t *handle, int result, const sr_error_info_t *err_info, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const sr_error_info_t *err_info2;
+
+    assert_int_equal(result, SR_ERR_OK);
+    assert_null(err_info);
+
+    /* the changes are already finished */
+    assert_int_equal(sr_apply_handle_wait(handle, &err_info2), SR_ERR_OK);
+    assert_null(err_info2);
+    ++st->cb_called2;
+}
+
+static void
+apply_changes_async_free_cb(sr_apply_handle_t *handle, int result, const sr_error_info_t *err_info, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)err_info;
+
+    assert_int_equal(result, SR_ERR_OK);
+    sr_apply_handle_free(handle);
+    ++st->cb_called2;
+}
+
+static void
+test_change_async(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr;
+    sr_apply_handle_t *handle;
+    const sr_error_info_t *err_info;
+    sr_val_t *val;
+    int fd, ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_async_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* apply the changes asynchronously */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 0, 1, apply_changes_async_cb, st, &handle);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_handle_get_fd(handle, &fd);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_true(fd > -1);
+
+    /* the session can be used right away */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* wait for the changes */
+    ret = sr_apply_handle_wait(handle, &err_info);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(err_info);
+    assert_int_equal(st->cb_called, 1);
+    sr_apply_handle_free(handle);
+    assert_int_equal(st->cb_called2, 1);
+
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 5);
+    sr_free_val(val);
+
+    /* apply the prepared delete */
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 2);
+
+    /* the callback can free the handle */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "6", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 0, 1, apply_changes_async_free_cb, st, &handle);
+    assert_int_equal(ret, SR_ERR_OK);
+    while (st->cb_called2 < 2) {
+        usleep(1000);
+    }
+    assert_int_equal(st->cb_called, 3);
+
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 4);
+
+    sr_unsubscribe(subscr);
+    sr_session_stop(sess);
+}
+
+/* TEST 13 */
+static int
+module_change_batch_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, sr_event_t event,
+        uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    sr_change_iter_t *iter;
+    sr_change_oper_t op;
+    sr_change_t *changes;
+    sr_val_t *old_val, *new_val;
+    uint32_t i, count, generic_count = 0, batch_count = 0;
+    int ret;
+
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    if (event != SR_EV_CHANGE) {
+        return SR_ERR_OK;
+    }
+
+    /* union forces generic XPath evaluation */
+    ret = sr_get_changes_iter(session, "/ietf-interfaces:*//. | /ietf-interfaces:interfaces", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    while ((ret = sr_get_change_next(session, iter, &op, &old_val, &new_val)) == SR_ERR_OK) {
+        sr_free_val(old_val);
+        sr_free_val(new_val);
+        ++generic_count;
+    }
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    sr_free_change_iter(iter);
+
+    /* whole module subtrees are walked */
+    ret = sr_get_changes_iter(session, "/ietf-interfaces:*//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    while ((ret = sr_get_change_next_batch(session, iter, 4, &changes, &count)) == SR_ERR_OK) {
+        assert_true(count && (count <= 4));
+        for (i = 0; i < count; ++i) {
+            assert_int_equal(changes[i].oper, SR_OP_CREATED);
+            assert_null(changes[i].old_value);
+            assert_non_null(changes[i].new_value);
+            if (!batch_count && !i) {
+                assert_string_equal(changes[i].new_value->xpath, "/ietf-interfaces:interfaces");
+            }
+        }
+        batch_count += count;
+        sr_free_changes(changes, count);
+    }
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    sr_free_change_iter(iter);
+    assert_int_equal(batch_count, generic_count);
+
+    /* nested subtrees, every change is returned only once */
+    ret = sr_get_changes_iter(session, "/ietf-interfaces:interfaces//*//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    batch_count = 0;
+    while ((ret = sr_get_change_next(session, iter, &op, &old_val, &new_val)) == SR_ERR_OK) {
+        sr_free_val(old_val);
+        sr_free_val(new_val);
+        ++batch_count;
+    }
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    sr_free_change_iter(iter);
+    assert_int_equal(batch_count, generic_count - 1);
+
+    /* subtree of a single list instance */
+    ret = sr_get_changes_iter(session, "/ietf-interfaces:interfaces/interface[name='eth2']//.", &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_change_next(session, iter, &op, &old_val, &new_val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(new_val->xpath, "/ietf-interfaces:interfaces/interface[name='eth2']");
+    sr_free_val(new_val);
+    sr_free_change_iter(iter);
+
+    ++st->cb_called;
+    return SR_ERR_OK;
+}
+
+static void
+test_change_batch(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "ietf-interfaces", NULL, module_change_batch_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces/interface[name='eth1']/type", "iana-if-type:ethernetCsmacd",
+            NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces/interface[name='eth2']/type", "iana-if-type:ethernetCsmacd",
+            NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 1);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/ietf-interfaces:interfaces", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST 14 */
+static int
+module_change_noop_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, sr_event_t event,
+        uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)xpath;
+    (void)event;
+    (void)request_id;
+
+    assert_string_equal(module_name, "test");
+    ++st->cb_called;
+    return SR_ERR_OK;
+}
+
+static void
+test_change_noop(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr;
+    sr_val_t *val;
+    uid_t uid;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_noop_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* real change, "change" and "done" events */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 2);
+
+    /* the same value, nothing is changed */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 2);
+
+    /* removing a non-existing node, nothing is changed */
+    ret = sr_delete_item(sess, "/test:l1[k='none']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 2);
+
+    /* the edit was still applied and discarded */
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 5);
+    sr_free_val(val);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 2);
+
+    /* nothing is changed but write permission is still required */
+    ret = sr_set_module_access(st->conn, "test", NULL, NULL, 00444);
+    assert_int_equal(ret, SR_ERR_OK);
+    uid = geteuid();
+    if (!uid) {
+        /* root always has write access, use an unprivileged effective UID */
+        assert_int_equal(seteuid(65534), 0);
+    }
+    ret = sr_set_item_str(sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_UNAUTHORIZED);
+    assert_int_equal(st->cb_called, 2);
+    if (!uid) {
+        assert_int_equal(seteuid(uid), 0);
+    }
+    ret = sr_discard_changes(sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_module_access(st->conn, "test", NULL, NULL, 00600);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST 15 */
+static int
+module_change_filter_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, sr_event_t event,
+        uint32_t request_id, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)module_name;
+    (void)request_id;
+
+    if (!xpath) {
+        /* whole module, gets "change" and "abort" */
+        if (st->cb_called == 0) {
+            assert_int_equal(event, SR_EV_CHANGE);
+        } else if (st->cb_called == 1) {
+            assert_int_equal(event, SR_EV_ABORT);
+        } else {
+            fail();
+        }
+        ++st->cb_called;
+    } else if (!strcmp(xpath, "/test:test-leaf")) {
+        /* fail the change */
+        assert_int_equal(event, SR_EV_CHANGE);
+        return SR_ERR_UNSUPPORTED;
+    } else {
+        /* never interested in any changes */
+        ++st->cb_called2;
+    }
+
+    return SR_ERR_OK;
+}
+
+static void
+test_change_filter(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_session_ctx_t *sess;
+    sr_subscription_ctx_t *subscr;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_set_item_str(sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_filter_cb, st, 1, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(sess, "test", "/test:test-leaf", module_change_filter_cb, st, 0,
+            SR_SUBSCR_CTX_REUSE, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    /* does not select anything in the change nor the reversed abort diff */
+    ret = sr_module_change_subscribe(sess, "test", "/test:cont", module_change_filter_cb, st, 2,
+            SR_SUBSCR_CTX_REUSE, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    /* selects nothing in the change diff but would select the old value in the reversed abort diff */
+    ret = sr_module_change_subscribe(sess, "test", "/test:test-leaf[.='5']", module_change_filter_cb, st, 2,
+            SR_SUBSCR_CTX_REUSE, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change fails, is aborted, and the filtered subscriptions are neither waited for nor called */
+    ret = sr_set_item_str(sess, "/test:test-leaf", "6", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_CALLBACK_FAILED);
+    assert_int_equal(st->cb_called, 2);
+    assert_int_equal(st->cb_called2, 0);
+
+    sr_unsubscribe(subscr);
+
+    /* cleanup */
+    ret = sr_discard_changes(sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_session_stop(sess);
+}
+
+/* TEST 16 */
+static void
+test_change_async_queue(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess, *sess2;
+    sr_subscription_ctx_t *subscr;
+    sr_apply_handle_t *handles[3];
+    const sr_error_info_t *err_info;
+    sr_val_t *val;
+    char str[2];
+    int i, ret;
+
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_module_change_subscribe(sess, "test", NULL, module_change_async_cb, st, 0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* changes are applied with the session ID so they own the lock of the session */
+    ret = sr_lock(sess, "test");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess, "/test:test-leaf", "1", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess, 0, 1, NULL, NULL, &handles[0]);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_handle_wait(handles[0], &err_info);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(err_info);
+    sr_apply_handle_free(handles[0]);
+    assert_int_equal(st->cb_called, 1);
+    assert_int_equal(st->ev_sid, sr_session_get_id(sess));
+
+    /* but not the locks of other sessions */
+    ret = sr_session_start(st->conn, SR_DS_RUNNING, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/test:test-leaf", "2", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes_async(sess2, 0, 1, NULL, NULL, &handles[0]);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_handle_wait(handles[0], &err_info);
+    assert_int_equal(ret, SR_ERR_LOCKED);
+    assert_non_null(err_info);
+    sr_apply_handle_free(handles[0]);
+    sr_session_stop(sess2);
+
+    /* the lock is still held by the session */
+    ret = sr_unlock(sess, "test");
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 1);
+    st->cb_called = 0;
+
+    /* queue several changes in another connection */
+    ret = sr_connect(0, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_RUNNING, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+    for (i = 0; i < 3; ++i) {
+        sprintf(str, "%d", i + 1);
+        ret = sr_set_item_str(sess2, "/test:test-leaf", str, NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+        ret = sr_apply_changes_async(sess2, 0, 1, NULL, NULL, &handles[i]);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+
+    /* the session can be stopped and disconnect waits for all the changes */
+    sr_session_stop(sess2);
+    ret = sr_disconnect(conn);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the handles are still valid */
+    for (i = 0; i < 3; ++i) {
+        ret = sr_apply_handle_wait(handles[i], &err_info);
+        assert_int_equal(ret, SR_ERR_OK);
+        assert_null(err_info);
+        sr_apply_handle_free(handles[i]);
+    }
+    assert_int_equal(st->cb_called, 3);
+
+    /* applied in order */
+    ret = sr_get_item(sess, "/test:test-leaf", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint8_val, 3);
+    sr_free_val(val);
+
+    ret = sr_delete_item(sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_unsubscribe(subscr);
+    sr_session_stop(sess);
+}
+
 /* MAIN */
 int
 main(void)
@@ -3593,6 +4093,11 @@ main(void)
         cmocka_unit_test_setup_teardown(test_change_timeout, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_order, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_change_userord, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_async, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_batch, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_noop, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_filter, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_change_async_queue, setup_f, teardown_f),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
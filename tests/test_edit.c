@@ -610,6 +610,189 @@ test_purge(void **state)
     assert_null(subtree);
 }
 
+static void
+test_batch_items(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *subtree;
+    char *str, *str2;
+    int ret;
+    sr_edit_item_t items[] = {
+        {"/ietf-interfaces:interfaces/interface[name='eth32']", NULL, "create"},
+        {"/ietf-interfaces:interfaces/interface[name='eth32']/type", "iana-if-type:ethernetCsmacd", NULL},
+        {"/ietf-interfaces:interfaces/interface[name='eth32']/description", "first", NULL},
+        {"/ietf-interfaces:interfaces/interface[name='eth64']/type", "iana-if-type:ethernetCsmacd", NULL},
+        {"/ietf-interfaces:interfaces/interface[name='eth64']/enabled", "false", NULL}
+    };
+    sr_edit_item_t del_items[] = {
+        {"/ietf-interfaces:interfaces/interface[name='eth32']/description", NULL, "delete"},
+        {"/ietf-interfaces:interfaces/interface[name='eth64']", NULL, "remove"}
+    };
+
+    /* create some data */
+    ret = sr_edit_batch_items(st->sess, items, 5, "merge");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* creating existing data fails */
+    ret = sr_edit_batch_items(st->sess, items, 1, "merge");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_EXISTS);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* delete some of them */
+    ret = sr_edit_batch_items(st->sess, del_items, 2, "none");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* check final datastore contents */
+    ret = sr_get_subtree(st->sess, "/ietf-interfaces:interfaces", 0, &subtree);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    lyd_print_mem(&str, subtree, LYD_XML, LYP_WITHSIBLINGS);
+    lyd_free(subtree);
+
+    str2 =
+    "<interfaces xmlns=\"urn:ietf:params:xml:ns:yang:ietf-interfaces\">"
+        "<interface>"
+            "<name>eth32</name>"
+            "<type xmlns:ianaift=\"urn:ietf:params:xml:ns:yang:iana-if-type\">ianaift:ethernetCsmacd</type>"
+        "</interface>"
+    "</interfaces>";
+
+    assert_string_equal(str, str2);
+    free(str);
+}
+
+static void
+test_edit_check(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *subtree;
+    int ret;
+    sr_edit_item_t inval_items[] = {
+        {"/ietf-interfaces:interfaces/interface[name='eth32']", NULL, "delete"},
+        {"/ietf-interfaces:interfaces/interface[name='eth32']/description", "desc", "create"}
+    };
+    sr_edit_item_t items[] = {
+        {"/ietf-interfaces:interfaces/interface[name='eth32']", NULL, "merge"},
+        {"/ietf-interfaces:interfaces/interface[name='eth32']/type", "iana-if-type:ethernetCsmacd", "merge"}
+    };
+    sr_edit_item_t rem_items[] = {
+        {"/ietf-interfaces:interfaces/interface[name='eth32']", NULL, "remove"},
+        {"/ietf-interfaces:interfaces/interface[name='eth32']/type", NULL, "remove"}
+    };
+
+    ret = sr_session_set_edit_check(st->sess, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* invalid edit fails right away and is not kept */
+    ret = sr_edit_batch_items(st->sess, inval_items, 2, "merge");
+    assert_int_equal(ret, SR_ERR_UNSUPPORTED);
+
+    /* valid edits */
+    ret = sr_edit_batch_items(st->sess, items, 2, "merge");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_edit_batch_items(st->sess, rem_items, 2, "none");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* everything was removed */
+    ret = sr_get_subtree(st->sess, "/ietf-interfaces:interfaces/interface[name='eth32']", 0, &subtree);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(subtree);
+
+    ret = sr_session_set_edit_check(st->sess, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+static void
+test_toplevel_many(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    struct ly_set *set;
+    char path[64], val[8];
+    uint32_t i;
+    int ret;
+
+    /* create many top-level list instances */
+    for (i = 0; i < 32; ++i) {
+        sprintf(path, "/test:l1[k='key%u']/v", i);
+        sprintf(val, "%u", i);
+        ret = sr_set_item_str(st->sess, path, val, NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change some, create new ones, delete some, and move one */
+    for (i = 16; i < 48; ++i) {
+        sprintf(path, "/test:l1[k='key%u']/v", i);
+        ret = sr_set_item_str(st->sess, path, "100", NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    for (i = 0; i < 8; ++i) {
+        sprintf(path, "/test:l1[k='key%u']", i);
+        ret = sr_delete_item(st->sess, path, SR_EDIT_STRICT);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_move_item(st->sess, "/test:l1[k='key8']", SR_MOVE_AFTER, "[k='key40']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* creating existing data fails */
+    ret = sr_set_item_str(st->sess, "/test:l1[k='key20']", NULL, NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_EXISTS);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* check datastore contents */
+    ret = sr_get_data(st->sess, "/test:l1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    set = lyd_find_path(data, "/test:l1");
+    assert_non_null(set);
+    assert_int_equal(set->number, 40);
+    ly_set_free(set);
+
+    set = lyd_find_path(data, "/test:l1[v='100']");
+    assert_non_null(set);
+    assert_int_equal(set->number, 32);
+    ly_set_free(set);
+
+    /* moved instance */
+    set = lyd_find_path(data, "/test:l1[k='key40']");
+    assert_non_null(set);
+    assert_int_equal(set->number, 1);
+    assert_non_null(set->set.d[0]->next);
+    assert_string_equal(((struct lyd_node_leaf_list *)set->set.d[0]->next->child)->value_str, "key8");
+    ly_set_free(set);
+
+    lyd_free_withsiblings(data);
+
+    /* remove all the instances */
+    ret = sr_delete_item(st->sess, "/test:l1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(st->sess, "/test:l1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(data);
+}
+
 int
 main(void)
 {
@@ -622,6 +805,9 @@ main(void)
         cmocka_unit_test_teardown(test_replace, clear_interfaces),
         cmocka_unit_test_teardown(test_isolate, clear_interfaces),
         cmocka_unit_test(test_purge),
+        cmocka_unit_test_teardown(test_batch_items, clear_interfaces),
+        cmocka_unit_test_teardown(test_edit_check, clear_interfaces),
+        cmocka_unit_test(test_toplevel_many),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
@@ -133,11 +133,301 @@ test_enable_cached_get(void **state)
     sr_unsubscribe(sub);
 }
 
+static void
+test_get_page(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data, *node;
+    const char *keys[] = {"a", "b", "c", "d", "e"};
+    char *path, *str;
+    int ret;
+    uint32_t i;
+
+    /* create some list instances */
+    for (i = 0; i < 5; ++i) {
+        asprintf(&path, "/simple:ac1/acl1[acs1='%s']", keys[i]);
+        ret = sr_set_item_str(st->sess, path, NULL, NULL, 0);
+        free(path);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* first page */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1", 0, NULL, 0, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = lyd_print_mem(&str, data, LYD_XML, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+    assert_string_equal(str, "<ac1 xmlns=\"s\"><acl1><acs1>a</acs1></acl1><acl1><acs1>b</acs1></acl1></ac1>");
+    free(str);
+    lyd_free_withsiblings(data);
+
+    /* next page */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1", 0, "/simple:ac1/acl1[acs1='b']", 0, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = lyd_print_mem(&str, data, LYD_XML, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+    assert_string_equal(str, "<ac1 xmlns=\"s\"><acl1><acs1>c</acs1></acl1><acl1><acs1>d</acs1></acl1></ac1>");
+    free(str);
+    lyd_free_withsiblings(data);
+
+    /* page with an offset */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1", 0, NULL, 4, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    node = data->child;
+    while (node && strcmp(node->schema->name, "acl1")) {
+        node = node->next;
+    }
+    assert_non_null(node);
+    assert_string_equal(((struct lyd_node_leaf_list *)node->child)->value_str, "e");
+    assert_null(node->next);
+    lyd_free_withsiblings(data);
+
+    /* no more data */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1", 0, "/simple:ac1/acl1[acs1='e']", 0, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_null(data);
+
+    /* not a selected node */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1", 0, "/simple:ac1/acl1[acs1='f']", 0, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* generic XPath, all the selected nodes are searched */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1[acs1!='c']", 0, "/simple:ac1/acl1[acs1='b']", 0, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = lyd_print_mem(&str, data, LYD_XML, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+    assert_string_equal(str, "<ac1 xmlns=\"s\"><acl1><acs1>d</acs1></acl1><acl1><acs1>e</acs1></acl1></ac1>");
+    free(str);
+    lyd_free_withsiblings(data);
+
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1[acs1!='c']", 0, "/simple:ac1/acl1[acs1='c']", 0, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* cleanup */
+    ret = sr_delete_item(st->sess, "/simple:ac1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+static int
+get_page_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *path, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    const struct ly_ctx *ly_ctx = sr_get_context(sr_session_get_connection(session));
+    uint32_t *page_count = (uint32_t *)private_data, count, start = 0, end = 20, i;
+    const char *after_path;
+    struct lyd_node *node;
+    char buf[64];
+    int ret;
+
+    (void)module_name;
+    (void)path;
+    (void)request_xpath;
+    (void)request_id;
+
+    ret = sr_session_get_oper_page(session, &after_path, &count);
+    assert_int_equal(ret, SR_ERR_OK);
+    *page_count = count;
+
+    /* return only the requested page, including the instance it follows */
+    if (after_path) {
+        assert_non_null(strstr(after_path, "'k"));
+        start = atoi(strstr(after_path, "'k") + 2);
+        ++count;
+    }
+    if (count && (start + count < end)) {
+        end = start + count;
+    }
+
+    for (i = start; i < end; ++i) {
+        sprintf(buf, "/simple:ac1/acl1[acs1='k%02u']", i);
+        node = lyd_new_path(*parent, ly_ctx, buf, NULL, 0, 0);
+        assert_non_null(node);
+        if (!*parent) {
+            *parent = node;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+static void
+test_get_page_oper(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr;
+    struct lyd_node *data, *node;
+    uint32_t page_count = 0, count;
+    char *str;
+    int ret;
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_subscribe(st->sess, "simple", "/simple:ac1", get_page_oper_cb, &page_count, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the provider learns the page and returns only it */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1", 0, "/simple:ac1/acl1[acs1='k05']", 1, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(page_count, 3);
+    ret = lyd_print_mem(&str, data, LYD_XML, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+    assert_string_equal(str, "<ac1 xmlns=\"s\"><acl1><acs1>k07</acs1></acl1><acl1><acs1>k08</acs1></acl1></ac1>");
+    free(str);
+    lyd_free_withsiblings(data);
+
+    /* first page */
+    ret = sr_get_data_page(st->sess, "/simple:ac1/acl1", 0, NULL, 0, 2, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(page_count, 2);
+    ret = lyd_print_mem(&str, data, LYD_XML, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+    assert_string_equal(str, "<ac1 xmlns=\"s\"><acl1><acs1>k00</acs1></acl1><acl1><acs1>k01</acs1></acl1></ac1>");
+    free(str);
+    lyd_free_withsiblings(data);
+
+    /* all the data without a page */
+    ret = sr_get_data(st->sess, "/simple:ac1/acl1", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(page_count, 0);
+    count = 0;
+    LY_TREE_FOR(data->child, node) {
+        if (!strcmp(node->schema->name, "acl1")) {
+            ++count;
+        }
+    }
+    assert_int_equal(count, 20);
+    lyd_free_withsiblings(data);
+
+    sr_unsubscribe(subscr);
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+static void
+test_get_iter(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_val_iter_t *iter;
+    sr_val_t *val, *vals;
+    size_t val_count;
+    char *path;
+    int ret;
+    uint32_t i;
+
+    /* create some list instances */
+    for (i = 0; i < 5; ++i) {
+        asprintf(&path, "/simple:ac1/acl1[acs1='%u']", i);
+        ret = sr_set_item_str(st->sess, path, NULL, NULL, 0);
+        free(path);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_items_iter(st->sess, "/simple:ac1/acl1/acs1", 0, 0, &iter);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the iterator works on a snapshot */
+    ret = sr_delete_item(st->sess, "/simple:ac1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* single value */
+    ret = sr_get_item_next(st->sess, iter, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(val->xpath, "/simple:ac1/acl1[acs1='0']/acs1");
+    assert_string_equal(val->data.string_val, "0");
+    sr_free_val(val);
+
+    /* chunks */
+    ret = sr_get_items_next(st->sess, iter, 3, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 3);
+    assert_string_equal(vals[0].data.string_val, "1");
+    assert_string_equal(vals[2].data.string_val, "3");
+    sr_free_values(vals, val_count);
+
+    ret = sr_get_items_next(st->sess, iter, 3, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    assert_string_equal(vals[0].data.string_val, "4");
+    sr_free_values(vals, val_count);
+
+    /* no more values */
+    ret = sr_get_items_next(st->sess, iter, 3, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+    ret = sr_get_item_next(st->sess, iter, &val);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    sr_free_val_iter(iter);
+}
+
+static void
+test_get_prepared(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_xpath_t *prepared;
+    sr_val_t *vals;
+    struct lyd_node *data;
+    size_t val_count;
+    int ret;
+
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='a']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='b']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_xpath_prepare(st->conn, "/simple:ac1/acl1", &prepared);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* prepared XPath can be used repeatedly */
+    ret = sr_get_items_prepared(st->sess, prepared, 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 2);
+    assert_string_equal(vals[0].xpath, "/simple:ac1/acl1[acs1='a']");
+    assert_string_equal(vals[1].xpath, "/simple:ac1/acl1[acs1='b']");
+    sr_free_values(vals, val_count);
+
+    ret = sr_get_data_prepared(st->sess, prepared, 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_string_equal(data->schema->name, "ac1");
+    assert_non_null(data->child);
+    assert_non_null(data->child->next);
+    lyd_free_withsiblings(data);
+
+    /* and in other datastores, running data are not enabled in operational */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_items_prepared(st->sess, prepared, 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_free_values(vals, val_count);
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_xpath_free(prepared);
+
+    ret = sr_delete_item(st->sess, "/simple:ac1", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_enable_cached_get),
+        cmocka_unit_test(test_get_page),
+        cmocka_unit_test(test_get_page_oper),
+        cmocka_unit_test(test_get_iter),
+        cmocka_unit_test(test_get_prepared),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
@@ -1021,6 +1021,160 @@ test_notif_buffer(void **state)
     lyd_free_withsiblings(notif);
 }
 
+/* TEST 8 */
+static void
+notif_batch_cb(sr_session_ctx_t *session, const sr_ev_notif_type_t notif_type, const struct lyd_node *notif,
+        time_t timestamp, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+
+    (void)session;
+    (void)timestamp;
+
+    assert_int_equal(notif_type, SR_EV_NOTIF_REALTIME);
+    assert_string_equal(notif->schema->name, "notif4");
+
+    /* signal that we were called */
+    ++st->cb_called;
+    pthread_barrier_wait(&st->barrier);
+}
+
+static void
+test_batch(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const struct ly_ctx *ly_ctx = sr_get_context(st->conn);
+    sr_subscription_ctx_t *subscr;
+    struct lyd_node *notifs[5];
+    int i, ret;
+
+    st->cb_called = 0;
+
+    /* subscribe */
+    ret = sr_event_notif_subscribe_tree(st->sess, "ops", "/ops:notif4", 0, 0, notif_batch_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    for (i = 0; i < 5; ++i) {
+        notifs[i] = lyd_new_path(NULL, ly_ctx, "/ops:notif4", NULL, 0, 0);
+        assert_non_null(notifs[i]);
+    }
+
+    /* send all the notifications at once */
+    ret = sr_event_notif_send_batch(st->sess, notifs, 5);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* wait for all the callbacks */
+    for (i = 0; i < 5; ++i) {
+        pthread_barrier_wait(&st->barrier);
+    }
+    assert_int_equal(st->cb_called, 5);
+
+    for (i = 0; i < 5; ++i) {
+        lyd_free_withsiblings(notifs[i]);
+    }
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 9 */
+static void
+notif_loop_cb(sr_session_ctx_t *session, const sr_ev_notif_type_t notif_type, const struct lyd_node *notif,
+        time_t timestamp, void *private_data)
+{
+    int *counts = (int *)private_data;
+
+    (void)session;
+    (void)timestamp;
+
+    switch (notif_type) {
+    case SR_EV_NOTIF_REALTIME:
+        assert_string_equal(notif->schema->name, "notif4");
+        ++counts[0];
+        break;
+    case SR_EV_NOTIF_STOP:
+        ++counts[1];
+        break;
+    default:
+        fail();
+    }
+}
+
+static void
+test_event_loop(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const struct ly_ctx *ly_ctx = sr_get_context(st->conn);
+    sr_subscription_ctx_t *subscr1, *subscr2, **ready;
+    sr_event_loop_t *loop;
+    struct lyd_node *notif;
+    struct timespec start, end;
+    uint32_t ready_count;
+    int counts1[2] = {0}, counts2[2] = {0}, ret;
+
+    ret = sr_event_loop_new(&loop);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* an empty loop still waits for the timeout */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = sr_event_loop_process(loop, 200, NULL, &ready, &ready_count);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ready_count, 0);
+    assert_true((end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000 >= 190);
+
+    /* subscribe without threads, the first with a stop time too far to fit into a timeout in ms */
+    ret = sr_event_notif_subscribe_tree(st->sess, "ops", "/ops:notif4", 0, time(NULL) + 100000000, notif_loop_cb,
+            counts1, SR_SUBSCR_NO_THREAD, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_event_notif_subscribe_tree(st->sess, "ops", "/ops:notif4", 0, time(NULL) + 2, notif_loop_cb,
+            counts2, SR_SUBSCR_NO_THREAD, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_event_loop_add(loop, subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_event_loop_add(loop, subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_event_loop_add(loop, subscr2);
+    assert_int_equal(ret, SR_ERR_EXISTS);
+
+    /* both subscriptions are processed after being added */
+    ret = sr_event_loop_process(loop, 0, NULL, &ready, &ready_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ready_count, 2);
+
+    /* send a notification, both subscriptions get it */
+    notif = lyd_new_path(NULL, ly_ctx, "/ops:notif4", NULL, 0, 0);
+    assert_non_null(notif);
+    ret = sr_event_notif_send_tree(st->sess, notif);
+    lyd_free_withsiblings(notif);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_event_loop_process(loop, 1000, NULL, &ready, &ready_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ready_count, 2);
+    assert_int_equal(counts1[0], 1);
+    assert_int_equal(counts2[0], 1);
+
+    /* wait without a timeout, returns once the nearest stop time elapses */
+    ret = sr_event_loop_process(loop, -1, NULL, &ready, &ready_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ready_count, 1);
+    assert_true(ready[0] == subscr2);
+    assert_int_equal(counts1[1], 0);
+    assert_int_equal(counts2[1], 1);
+
+    /* nothing more to process */
+    ret = sr_event_loop_del(loop, subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_event_loop_process(loop, 100, NULL, &ready, &ready_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(ready_count, 0);
+    assert_null(ready);
+
+    sr_event_loop_free(loop);
+    sr_unsubscribe(subscr1);
+    sr_unsubscribe(subscr2);
+}
+
 /* MAIN */
 int
 main(void)
@@ -1033,6 +1187,8 @@ main(void)
         cmocka_unit_test_setup_teardown(test_no_replay, clear_ops_notif, clear_ops),
         cmocka_unit_test_teardown(test_notif_config_change, clear_ops),
         cmocka_unit_test(test_notif_buffer),
+        cmocka_unit_test(test_batch),
+        cmocka_unit_test(test_event_loop),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
@@ -27,6 +27,7 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <pthread.h>
+#include <time.h>
 
 #include <cmocka.h>
 #include <libyang/libyang.h>
@@ -39,6 +40,8 @@ struct state {
     sr_session_ctx_t *sess;
     int cb_called;
     pthread_barrier_t barrier;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
 };
 
 static int
@@ -97,6 +100,8 @@ setup(void **state)
     st->cb_called = 0;
 
     pthread_barrier_init(&st->barrier, NULL, 2);
+    pthread_mutex_init(&st->lock, NULL);
+    pthread_cond_init(&st->cond, NULL);
 
     return 0;
 }
@@ -116,6 +121,8 @@ teardown(void **state)
 
     sr_disconnect(st->conn);
     pthread_barrier_destroy(&st->barrier);
+    pthread_mutex_destroy(&st->lock);
+    pthread_cond_destroy(&st->cond);
     free(st);
     return 0;
 }
@@ -2080,6 +2087,1109 @@ test_default_when(void **state)
     free(str1);
 }
 
+/* TEST 19 */
+static int
+cache_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    struct lyd_node *node;
+
+    (void)session;
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+
+    node = lyd_new_path(NULL, sr_get_context(st->conn), "/ietf-interfaces:interfaces-state/interface[name='eth5']/type",
+            "iana-if-type:ethernetCsmacd", 0, 0);
+    assert_non_null(node);
+    *parent = node;
+
+    ++st->cb_called;
+    return SR_ERR_OK;
+}
+
+static void
+test_cache(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    sr_subscription_ctx_t *subscr;
+    uint32_t hit_count, miss_count;
+    int ret;
+
+    /* subscribe as state data provider with cached data */
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", cache_oper_cb,
+            st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_cache(subscr, "ietf-interfaces", "/ietf-interfaces:interfaces-state", 60000);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* switch to operational DS */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data twice, the callback is called only once */
+    st->cb_called = 0;
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    lyd_free_withsiblings(data);
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_string_equal(data->schema->name, "interfaces-state");
+    lyd_free_withsiblings(data);
+    assert_int_equal(st->cb_called, 1);
+
+    ret = sr_oper_cache_stats(st->conn, &hit_count, &miss_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(hit_count, 1);
+    assert_int_equal(miss_count, 1);
+
+    /* invalidate the cached data, the callback is called again */
+    ret = sr_oper_get_items_cache_invalidate(subscr, "ietf-interfaces", "/ietf-interfaces:interfaces-state");
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    lyd_free_withsiblings(data);
+    assert_int_equal(st->cb_called, 2);
+
+    /* disable caching */
+    ret = sr_oper_get_items_cache(subscr, "ietf-interfaces", "/ietf-interfaces:interfaces-state", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    lyd_free_withsiblings(data);
+    assert_int_equal(st->cb_called, 3);
+
+    /* unknown subscription */
+    ret = sr_oper_get_items_cache(subscr, "ietf-interfaces", "/ietf-interfaces:interfaces", 1000);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 20 */
+static int
+batch_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+    struct lyd_node *node;
+    struct ly_set *set;
+    uint32_t i;
+
+    (void)request_xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    assert_string_equal(module_name, "ietf-interfaces");
+    assert_non_null(parent);
+
+    if (!strcmp(xpath, "/ietf-interfaces:interfaces-state/interface/phys-address")) {
+        /* all the parents at once */
+        assert_non_null(*parent);
+        assert_null((*parent)->parent);
+
+        set = lyd_find_path(*parent, "/ietf-interfaces:interfaces-state/interface");
+        assert_non_null(set);
+        assert_int_equal(set->number, 2);
+        for (i = 0; i < set->number; ++i) {
+            node = lyd_new_path(set->set.d[i], NULL, "phys-address", "01:23:45:67:89:ab", 0, 0);
+            assert_non_null(node);
+        }
+        ly_set_free(set);
+
+        ++st->cb_called;
+    } else if (!strcmp(xpath, "/ietf-interfaces:interfaces-state")) {
+        assert_null(*parent);
+
+        node = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces-state/interface[name='eth2']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+        assert_non_null(node);
+        *parent = node;
+
+        node = lyd_new_path(*parent, NULL, "/ietf-interfaces:interfaces-state/interface[name='eth3']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+        assert_non_null(node);
+    } else {
+        fail();
+    }
+
+    return SR_ERR_OK;
+}
+
+static void
+test_batch(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    sr_subscription_ctx_t *subscr;
+    char *str1;
+    const char *str2;
+    int ret;
+
+    /* subscribe as state data provider, the nested one is called once for all the interfaces */
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            batch_oper_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state/interface/phys-address",
+            batch_oper_cb, st, SR_SUBSCR_CTX_REUSE | SR_SUBSCR_OPER_BATCH, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data from operational */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    st->cb_called = 0;
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, SR_OPER_WITH_ORIGIN, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 1);
+
+    ret = lyd_print_mem(&str1, data, LYD_XML, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+
+    lyd_free_withsiblings(data);
+
+    str2 =
+    "<interfaces-state xmlns=\"urn:ietf:params:xml:ns:yang:ietf-interfaces\""
+        " xmlns:or=\"urn:ietf:params:xml:ns:yang:ietf-origin\" or:origin=\"unknown\">"
+        "<interface>"
+            "<name>eth2</name>"
+            "<type xmlns:ianaift=\"urn:ietf:params:xml:ns:yang:iana-if-type\">ianaift:ethernetCsmacd</type>"
+            "<phys-address>01:23:45:67:89:ab</phys-address>"
+        "</interface>"
+        "<interface>"
+            "<name>eth3</name>"
+            "<type xmlns:ianaift=\"urn:ietf:params:xml:ns:yang:iana-if-type\">ianaift:ethernetCsmacd</type>"
+            "<phys-address>01:23:45:67:89:ab</phys-address>"
+        "</interface>"
+    "</interfaces-state>";
+
+    assert_string_equal(str1, str2);
+    free(str1);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 21 */
+static int
+parallel_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+    struct lyd_node *node;
+
+    (void)module_name;
+    (void)request_xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    /* both providers must have been asked for the data at once */
+    pthread_barrier_wait(&st->barrier);
+
+    if (!strcmp(xpath, "/ietf-interfaces:interfaces-state")) {
+        node = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces-state/interface[name='eth2']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+    } else if (!strcmp(xpath, "/ietf-interfaces:interfaces")) {
+        node = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces/interface[name='eth3']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+    } else {
+        fail();
+    }
+    assert_non_null(node);
+    *parent = node;
+
+    return SR_ERR_OK;
+}
+
+static void
+test_parallel(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    sr_subscription_ctx_t *subscr1, *subscr2;
+    char *str1;
+    const char *str2;
+    int ret;
+
+    /* subscribe 2 independent providers, each in its own thread */
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            parallel_oper_cb, st, 0, &subscr1);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces",
+            parallel_oper_cb, st, 0, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data from operational */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(st->sess, "/ietf-interfaces:*", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = lyd_print_mem(&str1, data, LYD_XML, LYP_WITHSIBLINGS);
+    assert_int_equal(ret, 0);
+
+    lyd_free_withsiblings(data);
+
+    str2 =
+    "<interfaces xmlns=\"urn:ietf:params:xml:ns:yang:ietf-interfaces\">"
+        "<interface>"
+            "<name>eth3</name>"
+            "<type xmlns:ianaift=\"urn:ietf:params:xml:ns:yang:iana-if-type\">ianaift:ethernetCsmacd</type>"
+        "</interface>"
+    "</interfaces>"
+    "<interfaces-state xmlns=\"urn:ietf:params:xml:ns:yang:ietf-interfaces\">"
+        "<interface>"
+            "<name>eth2</name>"
+            "<type xmlns:ianaift=\"urn:ietf:params:xml:ns:yang:iana-if-type\">ianaift:ethernetCsmacd</type>"
+        "</interface>"
+    "</interfaces-state>";
+
+    assert_string_equal(str1, str2);
+    free(str1);
+
+    sr_unsubscribe(subscr1);
+    sr_unsubscribe(subscr2);
+}
+
+/* TEST 22 */
+static int
+concurrent_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+    struct timespec ts;
+    int ret = 0;
+
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    /* wait for the other request to be handled, fails if the requests are serialized */
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += 3;
+    pthread_mutex_lock(&st->lock);
+    ++st->cb_called;
+    pthread_cond_broadcast(&st->cond);
+    while (!ret && (st->cb_called < 2)) {
+        ret = pthread_cond_timedwait(&st->cond, &st->lock, &ts);
+    }
+    pthread_mutex_unlock(&st->lock);
+    if (ret) {
+        return SR_ERR_TIME_OUT;
+    }
+
+    *parent = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces-state/interface[name='eth5']/type",
+            "iana-if-type:ethernetCsmacd", 0, 0);
+    assert_non_null(*parent);
+
+    return SR_ERR_OK;
+}
+
+static void *
+concurrent_get_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    sr_val_t *val;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data at the same time as the main thread */
+    pthread_barrier_wait(&st->barrier);
+
+    ret = sr_get_item(sess, "/ietf-interfaces:interfaces-state/interface[name='eth5']/type", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->type, SR_IDENTITYREF_T);
+    sr_free_val(val);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_concurrent(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr;
+    sr_val_t *val;
+    pthread_t tid;
+    int ret;
+
+    /* subscribe a provider that can be asked by several requesters at once */
+    st->cb_called = 0;
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            concurrent_oper_cb, st, SR_SUBSCR_OPER_CONCURRENT, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* handle both requests at once */
+    ret = sr_subscription_thread_pool(subscr, 2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data from 2 threads */
+    pthread_create(&tid, NULL, concurrent_get_thread, st);
+    pthread_barrier_wait(&st->barrier);
+
+    ret = sr_get_item(st->sess, "/ietf-interfaces:interfaces-state/interface[name='eth5']/type", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->type, SR_IDENTITYREF_T);
+    sr_free_val(val);
+
+    pthread_join(tid, NULL);
+
+    /* every request was answered separately */
+    assert_int_equal(st->cb_called, 2);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 23 */
+static void
+test_push_update(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn;
+    sr_session_ctx_t *sess;
+    sr_val_t *vals;
+    size_t val_count;
+    int ret;
+
+    /* create another connection and session */
+    ret = sr_connect(0, &conn);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* no stored data yet */
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 0);
+
+    /* push data from the other connection */
+    ret = sr_set_item_str(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    sr_free_values(vals, val_count);
+
+    /* push data from this connection, the stored diff is updated */
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces-state/interface[name='eth2']/type",
+            "iana-if-type:ethernetCsmacd", NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 2);
+    sr_free_values(vals, val_count);
+
+    ret = sr_get_items(sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 2);
+    sr_free_values(vals, val_count);
+
+    /* remove data from the other connection */
+    ret = sr_delete_item(sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']", SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    assert_string_equal(vals[0].xpath, "/ietf-interfaces:interfaces-state/interface[name='eth2']");
+    sr_free_values(vals, val_count);
+
+    /* data of this connection are kept */
+    sr_disconnect(conn);
+
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    sr_free_values(vals, val_count);
+}
+
+/* TEST 24 */
+static int
+read_txn_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+    char *path;
+
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    /* every call provides different data */
+    ++st->cb_called;
+    asprintf(&path, "/ietf-interfaces:interfaces-state/interface[name='eth%d']/type", st->cb_called);
+    *parent = lyd_new_path(NULL, ly_ctx, path, "iana-if-type:ethernetCsmacd", 0, 0);
+    free(path);
+    assert_non_null(*parent);
+
+    return SR_ERR_OK;
+}
+
+static int
+read_txn_mc_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    const struct ly_ctx *ly_ctx;
+
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+    (void)private_data;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    *parent = lyd_new_path(NULL, ly_ctx, "/mixed-config:test-state/test-case[name='tc']/result", "1", 0, 0);
+    assert_non_null(*parent);
+
+    return SR_ERR_OK;
+}
+
+static int
+read_txn_fail_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    (void)session;
+    (void)module_name;
+    (void)xpath;
+    (void)request_xpath;
+    (void)request_id;
+    (void)parent;
+    (void)private_data;
+
+    /* must never be called */
+    fail();
+
+    return SR_ERR_CALLBACK_FAILED;
+}
+
+static void
+test_read_txn(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr, *subscr2;
+    sr_val_t *val, *vals;
+    size_t val_count;
+    const char *xpaths[] = {"/ietf-interfaces:interfaces-state", "/mixed-config:test-state"};
+    int ret;
+
+    st->cb_called = 0;
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            read_txn_oper_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_subscribe(st->sess, "mixed-config", "/mixed-config:test-state",
+            read_txn_mc_oper_cb, st, 0, &subscr2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* provider of data outside the snapshot, it would fail the transaction */
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces",
+            read_txn_fail_oper_cb, st, SR_SUBSCR_CTX_REUSE, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* several gets in one read transaction, the snapshot is loaded right away */
+    ret = sr_read_begin(st->sess, xpaths, 2, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 1);
+
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    assert_string_equal(vals[0].xpath, "/ietf-interfaces:interfaces-state/interface[name='eth1']");
+    sr_free_values(vals, val_count);
+
+    ret = sr_get_item(st->sess, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_free_val(val);
+
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface/name", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    assert_string_equal(vals[0].data.string_val, "eth1");
+    sr_free_values(vals, val_count);
+
+    /* data of the other module were loaded into the snapshot as well */
+    sr_unsubscribe(subscr2);
+    ret = sr_get_item(st->sess, "/mixed-config:test-state/test-case[name='tc']/result", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->data.uint32_val, 1);
+    sr_free_val(val);
+
+    /* data not selected by the transaction paths are not in the snapshot */
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 0);
+
+    ret = sr_read_end(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the provider was asked only once */
+    assert_int_equal(st->cb_called, 1);
+
+    /* no data of the other module without the snapshot */
+    ret = sr_get_item(st->sess, "/mixed-config:test-state/test-case[name='tc']/result", 0, &val);
+    assert_int_equal(ret, SR_ERR_NOT_FOUND);
+
+    /* new data after the transaction */
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface/name", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    assert_string_equal(vals[0].data.string_val, "eth2");
+    sr_free_values(vals, val_count);
+    assert_int_equal(st->cb_called, 2);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 25 */
+static int
+get_multi_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    /* union of only the paths of this module is requested */
+    assert_non_null(strchr(request_xpath, '|'));
+    assert_null(strstr(request_xpath, "mixed-config"));
+
+    ++st->cb_called;
+    *parent = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", 0, 0);
+    assert_non_null(*parent);
+    assert_non_null(lyd_new_path(*parent, NULL, "/ietf-interfaces:interfaces-state/interface[name='eth2']/type",
+            "iana-if-type:ethernetCsmacd", 0, 0));
+
+    return SR_ERR_OK;
+}
+
+static int
+get_multi_mc_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+
+    (void)module_name;
+    (void)xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    /* only the path of this module is requested */
+    assert_string_equal(request_xpath, "/mixed-config:test-state/test-case[name='tc']");
+
+    ++st->cb_called;
+    *parent = lyd_new_path(NULL, ly_ctx, "/mixed-config:test-state/test-case[name='tc']/result", "1", 0, 0);
+    assert_non_null(*parent);
+
+    return SR_ERR_OK;
+}
+
+static void
+test_get_multi(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr;
+    struct lyd_node *data[4];
+    const char *xpaths[4] = {
+        "/ietf-interfaces:interfaces-state/interface[name='eth1']",
+        "/ietf-interfaces:interfaces-state/interface[name='eth2']/type",
+        "/ietf-interfaces:interfaces-state/interface[name='eth3']",
+        "/mixed-config:test-state/test-case[name='tc']"
+    };
+    uint32_t max_depths[4] = {1, 0, 0, 0};
+    int ret;
+
+    st->cb_called = 0;
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            get_multi_oper_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_subscribe(st->sess, "mixed-config", "/mixed-config:test-state",
+            get_multi_mc_oper_cb, st, SR_SUBSCR_CTX_REUSE, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data_multi(st->sess, xpaths, max_depths, 4, 0, 0, data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* every provider was asked only once */
+    assert_int_equal(st->cb_called, 2);
+
+    /* only the list keys */
+    assert_non_null(data[0]);
+    assert_string_equal(data[0]->child->child->schema->name, "name");
+    assert_null(data[0]->child->child->next);
+    lyd_free_withsiblings(data[0]);
+
+    assert_non_null(data[1]);
+    assert_string_equal(data[1]->child->child->schema->name, "name");
+    assert_string_equal(((struct lyd_node_leaf_list *)data[1]->child->child)->value_str, "eth2");
+    assert_string_equal(data[1]->child->child->next->schema->name, "type");
+    lyd_free_withsiblings(data[1]);
+
+    /* nothing selected */
+    assert_null(data[2]);
+
+    assert_non_null(data[3]);
+    lyd_free_withsiblings(data[3]);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 26 */
+static void
+test_stored_diff_merge_many(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    struct ly_set *set;
+    char path[128];
+    uint32_t i;
+    int ret;
+
+    /* switch to operational DS */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* store many list instances */
+    for (i = 0; i < 64; ++i) {
+        sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='eth%u']/type", i);
+        ret = sr_set_item_str(st->sess, path, "iana-if-type:ethernetCsmacd", NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change some, remove some and add new ones, merged with the stored diff */
+    for (i = 32; i < 96; ++i) {
+        sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='eth%u']/type", i);
+        ret = sr_set_item_str(st->sess, path, "iana-if-type:softwareLoopback", NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    for (i = 0; i < 16; ++i) {
+        sprintf(path, "/ietf-interfaces:interfaces-state/interface[name='eth%u']", i);
+        ret = sr_delete_item(st->sess, path, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data */
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    set = lyd_find_path(data, "/ietf-interfaces:interfaces-state/interface");
+    assert_non_null(set);
+    assert_int_equal(set->number, 80);
+    ly_set_free(set);
+
+    set = lyd_find_path(data, "/ietf-interfaces:interfaces-state/interface[name='eth8']");
+    assert_non_null(set);
+    assert_int_equal(set->number, 0);
+    ly_set_free(set);
+
+    set = lyd_find_path(data, "/ietf-interfaces:interfaces-state/interface[type='iana-if-type:softwareLoopback']");
+    assert_non_null(set);
+    assert_int_equal(set->number, 64);
+    ly_set_free(set);
+
+    lyd_free_withsiblings(data);
+}
+
+/* TEST 27 */
+static void
+test_stored_running_unrelated(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr;
+    sr_val_t *vals;
+    size_t val_count;
+    int ret;
+
+    /* subscribe to all configuration data just to enable them */
+    ret = sr_module_change_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces", dummy_change_cb, NULL,
+            0, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* store some state data */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces-state/interface[name='eth5']/type",
+            "iana-if-type:ethernetCsmacd", NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* change running data of another subtree of the module */
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", NULL, SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* both are in operational data */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    assert_string_equal(vals[0].xpath, "/ietf-interfaces:interfaces-state/interface[name='eth5']");
+    sr_free_values(vals, val_count);
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    sr_free_values(vals, val_count);
+
+    /* store config data overwriting running data */
+    ret = sr_set_item_str(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']/description",
+            "oper-description", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* delete the interface, which affects the stored data */
+    ret = sr_session_switch_ds(st->sess, SR_DS_RUNNING);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_delete_item(st->sess, "/ietf-interfaces:interfaces/interface[name='eth1']", SR_EDIT_STRICT);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* only the state data remain */
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 0);
+    ret = sr_get_items(st->sess, "/ietf-interfaces:interfaces-state/interface", 0, 0, &vals, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    sr_free_values(vals, val_count);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 28 */
+static void
+test_state_default(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    int ret;
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* only default state NP container */
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_string_equal(data->schema->name, "interfaces-state");
+    assert_int_equal(data->dflt, 1);
+    assert_null(data->child);
+
+    /* modify the returned data */
+    assert_non_null(lyd_new_path(data, NULL, "/ietf-interfaces:interfaces-state/interface[name='eth1']/type",
+            "iana-if-type:ethernetCsmacd", 0, 0));
+    lyd_free_withsiblings(data);
+
+    /* the same default data are returned again */
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_non_null(data);
+    assert_string_equal(data->schema->name, "interfaces-state");
+    assert_int_equal(data->dflt, 1);
+    assert_null(data->child);
+    lyd_free_withsiblings(data);
+}
+
+/* TEST 29 */
+static int
+pool_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+    struct timespec ts;
+    int ret = 0;
+
+    (void)module_name;
+    (void)request_xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    /* wait for the other callback to start, fails if the callbacks are called one after another */
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += 3;
+    pthread_mutex_lock(&st->lock);
+    ++st->cb_called;
+    pthread_cond_broadcast(&st->cond);
+    while (!ret && (st->cb_called < 2)) {
+        ret = pthread_cond_timedwait(&st->cond, &st->lock, &ts);
+    }
+    pthread_mutex_unlock(&st->lock);
+    if (ret) {
+        return SR_ERR_TIME_OUT;
+    }
+
+    if (!strcmp(xpath, "/ietf-interfaces:interfaces-state")) {
+        *parent = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces-state/interface[name='eth2']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+    } else if (!strcmp(xpath, "/ietf-interfaces:interfaces")) {
+        *parent = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces/interface[name='eth3']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+    } else {
+        fail();
+    }
+    assert_non_null(*parent);
+
+    return SR_ERR_OK;
+}
+
+static void
+test_pool_parallel(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    sr_subscription_ctx_t *subscr = NULL;
+    int ret;
+
+    /* subscribe 2 independent providers in a single subscription */
+    st->cb_called = 0;
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            pool_oper_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces",
+            pool_oper_cb, st, SR_SUBSCR_CTX_REUSE, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* handle them by 2 worker threads */
+    ret = sr_subscription_thread_pool(subscr, 2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* both callbacks must run at once */
+    ret = sr_get_data(st->sess, "/ietf-interfaces:*", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(st->cb_called, 2);
+
+    assert_non_null(data);
+    assert_string_equal(data->schema->name, "interfaces");
+    assert_non_null(data->next);
+    assert_string_equal(data->next->schema->name, "interfaces-state");
+    lyd_free_withsiblings(data);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 30 */
+static int
+pool_slow_oper_cb(sr_session_ctx_t *session, const char *module_name, const char *xpath, const char *request_xpath,
+        uint32_t request_id, struct lyd_node **parent, void *private_data)
+{
+    struct state *st = (struct state *)private_data;
+    const struct ly_ctx *ly_ctx;
+
+    (void)module_name;
+    (void)request_xpath;
+    (void)request_id;
+
+    ly_ctx = sr_get_context(sr_session_get_connection(session));
+
+    pthread_mutex_lock(&st->lock);
+    ++st->cb_called;
+    pthread_cond_broadcast(&st->cond);
+    pthread_mutex_unlock(&st->lock);
+
+    /* keep the worker thread busy so that the other task stays queued */
+    usleep(300000);
+
+    if (!strcmp(xpath, "/ietf-interfaces:interfaces-state")) {
+        *parent = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces-state/interface[name='eth2']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+    } else {
+        *parent = lyd_new_path(NULL, ly_ctx, "/ietf-interfaces:interfaces/interface[name='eth3']/type",
+                "iana-if-type:ethernetCsmacd", 0, 0);
+    }
+    assert_non_null(*parent);
+
+    return SR_ERR_OK;
+}
+
+static void *
+pool_get_thread(void *arg)
+{
+    struct state *st = (struct state *)arg;
+    sr_session_ctx_t *sess;
+    struct lyd_node *data;
+    int ret;
+
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_get_data(sess, "/ietf-interfaces:*", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* all the queued requests were answered */
+    assert_non_null(data);
+    assert_non_null(data->next);
+    lyd_free_withsiblings(data);
+
+    sr_session_stop(sess);
+    return NULL;
+}
+
+static void
+test_pool_stop(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_subscription_ctx_t *subscr = NULL;
+    pthread_t tid;
+    int ret;
+
+    /* subscribe 2 slow providers handled by a single worker thread */
+    st->cb_called = 0;
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state",
+            pool_slow_oper_cb, st, 0, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces",
+            pool_slow_oper_cb, st, SR_SUBSCR_CTX_REUSE, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_subscription_thread_pool(subscr, 1);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data in another thread and wait for the first callback */
+    pthread_create(&tid, NULL, pool_get_thread, st);
+    pthread_mutex_lock(&st->lock);
+    while (!st->cb_called) {
+        pthread_cond_wait(&st->cond, &st->lock);
+    }
+    pthread_mutex_unlock(&st->lock);
+
+    /* stop the pool while a task is being processed and the other one is queued */
+    usleep(100000);
+    ret = sr_subscription_thread_pool(subscr, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* the reader got all the data */
+    pthread_join(tid, NULL);
+    assert_int_equal(st->cb_called, 2);
+
+    /* the pool can be started again */
+    ret = sr_subscription_thread_pool(subscr, 2);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    sr_unsubscribe(subscr);
+}
+
+/* TEST 31 */
+static void
+test_cache_session(void **state)
+{
+    struct state *st = (struct state *)*state;
+    struct lyd_node *data;
+    sr_subscription_ctx_t *subscr;
+    sr_session_ctx_t *sess;
+    char xpath[64];
+    int i, ret;
+
+    /* subscribe as state data provider with data cached per session */
+    ret = sr_oper_get_items_subscribe(st->sess, "ietf-interfaces", "/ietf-interfaces:interfaces-state", cache_oper_cb,
+            st, SR_SUBSCR_OPER_CACHE_SESSION, &subscr);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_oper_get_items_cache(subscr, "ietf-interfaces", "/ietf-interfaces:interfaces-state", 60000);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    ret = sr_session_switch_ds(st->sess, SR_DS_OPERATIONAL);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(st->conn, SR_DS_OPERATIONAL, &sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* read the data twice in each session, the callback is called once for each session */
+    st->cb_called = 0;
+    for (i = 0; i < 4; ++i) {
+        ret = sr_get_data(i % 2 ? sess : st->sess, "/ietf-interfaces:interfaces-state", 0, 0, 0, &data);
+        assert_int_equal(ret, SR_ERR_OK);
+        assert_non_null(data);
+        lyd_free_withsiblings(data);
+    }
+    assert_int_equal(st->cb_called, 2);
+
+    /* cache more data than fit into the cache */
+    for (i = 0; i < 300; ++i) {
+        sprintf(xpath, "/ietf-interfaces:interfaces-state/interface[name='eth%d']", i);
+        ret = sr_get_data(st->sess, xpath, 0, 0, 0, &data);
+        assert_int_equal(ret, SR_ERR_OK);
+        lyd_free_withsiblings(data);
+    }
+    assert_int_equal(st->cb_called, 302);
+
+    /* the most recent data are still cached, the oldest were dropped */
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state/interface[name='eth299']", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    lyd_free_withsiblings(data);
+    assert_int_equal(st->cb_called, 302);
+    ret = sr_get_data(st->sess, "/ietf-interfaces:interfaces-state/interface[name='eth0']", 0, 0, 0, &data);
+    assert_int_equal(ret, SR_ERR_OK);
+    lyd_free_withsiblings(data);
+    assert_int_equal(st->cb_called, 303);
+
+    sr_session_stop(sess);
+    sr_unsubscribe(subscr);
+}
+
 int
 main(void)
 {
@@ -2102,6 +3212,19 @@ main(void)
         cmocka_unit_test_teardown(test_stored_diff_merge_replace, clear_up),
         cmocka_unit_test_teardown(test_stored_diff_merge_userord, clear_up),
         cmocka_unit_test(test_default_when),
+        cmocka_unit_test_teardown(test_cache, clear_up),
+        cmocka_unit_test_teardown(test_batch, clear_up),
+        cmocka_unit_test_teardown(test_parallel, clear_up),
+        cmocka_unit_test_teardown(test_concurrent, clear_up),
+        cmocka_unit_test_teardown(test_push_update, clear_up),
+        cmocka_unit_test_teardown(test_read_txn, clear_up),
+        cmocka_unit_test_teardown(test_get_multi, clear_up),
+        cmocka_unit_test_teardown(test_stored_diff_merge_many, clear_up),
+        cmocka_unit_test_teardown(test_stored_running_unrelated, clear_up),
+        cmocka_unit_test_teardown(test_state_default, clear_up),
+        cmocka_unit_test_teardown(test_pool_parallel, clear_up),
+        cmocka_unit_test_teardown(test_pool_stop, clear_up),
+        cmocka_unit_test_teardown(test_cache_session, clear_up),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);
@@ -26,6 +26,7 @@
 #include <setjmp.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdio.h>
 
 #include <cmocka.h>
 #include <libyang/libyang.h>
@@ -63,6 +64,9 @@ setup_f(void **state)
     if (sr_install_module(st->conn, TESTS_DIR "/files/refs.yang", TESTS_DIR "/files", NULL, 0) != SR_ERR_OK) {
         return 1;
     }
+    if (sr_install_module(st->conn, TESTS_DIR "/files/simple.yang", TESTS_DIR "/files", NULL, 0) != SR_ERR_OK) {
+        return 1;
+    }
     sr_disconnect(st->conn);
 
     if (sr_connect(0, &(st->conn)) != SR_ERR_OK) {
@@ -83,6 +87,7 @@ teardown_f(void **state)
 
     sr_remove_module(st->conn, "test");
     sr_remove_module(st->conn, "refs");
+    sr_remove_module(st->conn, "simple");
 
     sr_disconnect(st->conn);
     free(st);
@@ -104,6 +109,7 @@ clear_test_refs(void **state)
     sr_delete_item(st->sess, "/refs:ll[.='y']", 0);
     sr_delete_item(st->sess, "/refs:ll[.='z']", 0);
     sr_delete_item(st->sess, "/refs:lll[key='1']", 0);
+    sr_delete_item(st->sess, "/simple:ac1", 0);
     sr_apply_changes(st->sess, 0, 0);
 
     return 0;
@@ -217,12 +223,181 @@ test_instid(void **state)
     assert_int_equal(ret, SR_ERR_OK);
 }
 
+static void
+test_unchanged(void **state)
+{
+    struct state *st = (struct state *)*state;
+    int ret;
+
+    /* create valid data */
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:lref", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* no actual change */
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* unchanged target module, the changed one is still validated */
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:lref", "8", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* changed target module, the unchanged referencing one is validated */
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "8", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:lref", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
+static void
+test_independent(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_val_t *val;
+    size_t val_count;
+    char path[64];
+    uint32_t i;
+    int ret;
+
+    /* change 2 independent groups of modules */
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:lref", "10", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='a']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* enough data for the groups to be validated in parallel */
+    for (i = 0; i < 600; ++i) {
+        sprintf(path, "/simple:ac1/acl1[acs1='n%u']", i);
+        ret = sr_set_item_str(st->sess, path, NULL, NULL, 0);
+        assert_int_equal(ret, SR_ERR_OK);
+    }
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* default value was added by the validation */
+    ret = sr_get_item(st->sess, "/simple:ac1/acd1", 0, &val);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val->type, SR_BOOL_T);
+    assert_int_equal(val->data.bool_val, 1);
+    sr_free_val(val);
+
+    /* one group is invalid */
+    ret = sr_set_item_str(st->sess, "/simple:ac1/acl1[acs1='b']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:lref", "8", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* nothing was stored */
+    ret = sr_get_items(st->sess, "/simple:ac1/acl1", 0, 0, &val, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 601);
+    sr_free_values(val, val_count);
+    ret = sr_get_items(st->sess, "/refs:lref[.='10']", 0, 0, &val, &val_count);
+    assert_int_equal(ret, SR_ERR_OK);
+    assert_int_equal(val_count, 1);
+    sr_free_values(val, val_count);
+}
+
+static void
+test_instid_cache(void **state)
+{
+    struct state *st = (struct state *)*state;
+    sr_conn_ctx_t *conn2;
+    sr_session_ctx_t *sess2;
+    int ret;
+
+    /* inst-id to another module, its targets are cached */
+    ret = sr_set_item_str(st->sess, "/test:test-leaf", "5", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:inst-id", "/test:test-leaf", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* unrelated change, only the diff is evaluated and the cached target module is loaded */
+    ret = sr_set_item_str(st->sess, "/refs:l", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* delete the target together with an unrelated change, the inst-id is not in the diff */
+    ret = sr_delete_item(st->sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:ll", "y", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* delete only the target */
+    ret = sr_delete_item(st->sess, "/test:test-leaf", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* another connection changes the inst-id to a different module */
+    ret = sr_connect(0, &conn2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_session_start(conn2, SR_DS_RUNNING, &sess2);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/simple:ac1/acl1[acs1='a']", NULL, NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(sess2, "/refs:inst-id", "/simple:ac1/acl1[simple:acs1='a']", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(sess2, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    sr_disconnect(conn2);
+
+    /* the cached targets are outdated, all the inst-ids are evaluated and the new target module is loaded */
+    ret = sr_delete_item(st->sess, "/refs:l", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+
+    /* deleting the new target fails */
+    ret = sr_delete_item(st->sess, "/simple:ac1/acl1[acs1='a']", 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_set_item_str(st->sess, "/refs:ll", "y", NULL, 0);
+    assert_int_equal(ret, SR_ERR_OK);
+    ret = sr_apply_changes(st->sess, 0, 0);
+    assert_int_equal(ret, SR_ERR_VALIDATION_FAILED);
+    ret = sr_discard_changes(st->sess);
+    assert_int_equal(ret, SR_ERR_OK);
+}
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_teardown(test_leafref, clear_test_refs),
         cmocka_unit_test_teardown(test_instid, clear_test_refs),
+        cmocka_unit_test_teardown(test_unchanged, clear_test_refs),
+        cmocka_unit_test_teardown(test_independent, clear_test_refs),
+        cmocka_unit_test_teardown(test_instid_cache, clear_test_refs),
     };
 
     setenv("CMOCKA_TEST_ABORT", "1", 1);